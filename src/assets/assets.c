@@ -3,6 +3,7 @@
 #include "assets/group.h"
 #include "assets/image.h"
 #include "assets/xml.h"
+#include "core/config.h"
 #include "core/dir.h"
 #include "core/log.h"
 #include "graphics/renderer.h"
@@ -11,12 +12,26 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define PREFETCH_GROUPS_SIZE_STEP 64
+
 static struct {
     int roadblock_image_id;
     asset_image *roadblock_image;
     int asset_lookup[ASSET_MAX_KEY];
+    struct {
+        const image_groups **groups;
+        int capacity;
+        int size;
+        int next;
+    } prefetch;
 } data;
 
+static void free_lazy_assets(void)
+{
+    graphics_renderer()->free_image_atlas(ATLAS_LAZY_EXTRA_ASSET);
+    assets_clear_prefetched_groups();
+}
+
 void assets_init(int force_reload, color_t **main_images, int *main_image_widths)
 {
     if (graphics_renderer()->has_image_atlas(ATLAS_EXTRA_ASSET) && !force_reload) {
@@ -25,6 +40,7 @@ void assets_init(int force_reload, color_t **main_images, int *main_image_widths
     }
 
     graphics_renderer()->free_image_atlas(ATLAS_EXTRA_ASSET);
+    free_lazy_assets();
 
     const dir_listing *xml_files = dir_find_files_with_extension(ASSETS_DIRECTORY "/" ASSETS_IMAGE_PATH, "xml");
 
@@ -40,7 +56,7 @@ void assets_init(int force_reload, color_t **main_images, int *main_image_widths
 
     xml_finish();
 
-    asset_image_load_all(main_images, main_image_widths);
+    asset_image_load_all(main_images, main_image_widths, config_get(CONFIG_GENERAL_LAZY_ASSET_LOADING));
 
     group_set_for_external_files();
 
@@ -70,7 +86,8 @@ int assets_load_single_group(const char *file_name, color_t **main_images, int *
     }
     xml_init();
     graphics_renderer()->free_image_atlas(ATLAS_EXTRA_ASSET);
-    return xml_process_assetlist_file(file_name) && asset_image_load_all(main_images, main_image_widths);
+    free_lazy_assets();
+    return xml_process_assetlist_file(file_name) && asset_image_load_all(main_images, main_image_widths, 0);
 }
 
 int assets_get_group_id(const char *assetlist_name)
@@ -144,6 +161,14 @@ int assets_lookup_image_id(asset_id id)
     return data.asset_lookup[id];
 }
 
+static void load_deferred_group(const asset_image *img)
+{
+    const image_groups *group = group_get_from_image_index(img->index);
+    if (group) {
+        asset_image_load_deferred(group->first_image_index, group->last_image_index);
+    }
+}
+
 const image *assets_get_image(int image_id)
 {
     asset_image *img = asset_image_get_from_id(image_id - IMAGE_MAIN_ENTRIES);
@@ -153,9 +178,52 @@ const image *assets_get_image(int image_id)
     if (!img) {
         return image_get(0);
     }
+    if (img->is_deferred) {
+        load_deferred_group(img);
+    }
     return &img->img;
 }
 
+void assets_prefetch_group(const char *assetlist_name)
+{
+    const image_groups *group = group_get_from_name(assetlist_name);
+    if (!group) {
+        return;
+    }
+    for (int i = 0; i < data.prefetch.size; i++) {
+        if (data.prefetch.groups[i] == group) {
+            return;
+        }
+    }
+    if (data.prefetch.size == data.prefetch.capacity) {
+        int capacity = data.prefetch.capacity + PREFETCH_GROUPS_SIZE_STEP;
+        const image_groups **groups = realloc((void *) data.prefetch.groups, sizeof(image_groups *) * capacity);
+        if (!groups) {
+            log_error("Unable to queue asset group for loading", assetlist_name, 0);
+            return;
+        }
+        data.prefetch.groups = groups;
+        data.prefetch.capacity = capacity;
+    }
+    data.prefetch.groups[data.prefetch.size++] = group;
+}
+
+void assets_clear_prefetched_groups(void)
+{
+    data.prefetch.size = 0;
+    data.prefetch.next = 0;
+}
+
+void assets_load_next_prefetched_group(void)
+{
+    while (data.prefetch.next < data.prefetch.size) {
+        const image_groups *group = data.prefetch.groups[data.prefetch.next++];
+        if (asset_image_load_deferred(group->first_image_index, group->last_image_index)) {
+            return;
+        }
+    }
+}
+
 void assets_load_unpacked_asset(int image_id)
 {
     asset_image *img = asset_image_get_from_id(image_id - IMAGE_MAIN_ENTRIES);
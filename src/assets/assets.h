@@ -39,6 +39,23 @@ int assets_lookup_image_id(asset_id id);
 
 const image *assets_get_image(int image_id);
 
+/**
+ * Queues an asset group to be loaded ahead of its first use, when extra assets are loaded on demand
+ * @param assetlist_name The name of the group
+ */
+void assets_prefetch_group(const char *assetlist_name);
+
+/**
+ * Empties the queue of asset groups to load, e.g. when another scenario is loaded
+ */
+void assets_clear_prefetched_groups(void);
+
+/**
+ * Loads the next queued asset group that still has images waiting to be loaded.
+ * Only one group is loaded per call, so the call can be made once per frame.
+ */
+void assets_load_next_prefetched_group(void);
+
 void assets_load_unpacked_asset(int image_id);
 
 #endif // ASSETS_H
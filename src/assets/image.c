@@ -2,24 +2,31 @@
 
 #include "assets/group.h"
 #include "core/array.h"
+#include "core/file.h"
 #include "core/image.h"
 #include "core/image_packer.h"
 #include "core/log.h"
+#include "core/memory.h"
 #include "core/png_read.h"
 #include "game/campaign.h"
 #include "graphics/color.h"
 #include "graphics/graphics.h"
 #include "graphics/image.h"
 #include "graphics/renderer.h"
+#include "platform/thread_pool.h"
 
 #include <stdlib.h>
 #include <string.h>
 
 #define ASSET_ARRAY_SIZE 2000
+#define PNG_FILES_TO_DECODE_PER_WORKER 8
+#define MAX_PNG_FILES_TO_DECODE 64
+#define PNG_FILE_READ_STEP 65536
 
 static struct {
     array(asset_image) asset_images;
     int total_isometric_images;
+    int loading_deferred_images;
 } data;
 
 typedef enum {
@@ -137,10 +144,15 @@ static void translate_reference_position(asset_image *img)
 
 static void make_similar_images_references(const asset_image *img)
 {
+    // Images loaded after startup can't become references, as the other images are already packed
+    if (data.loading_deferred_images) {
+        return;
+    }
     const image_groups *group = group_get_from_image_index(img->index);
     for (int i = img->index + 1; i <= group->last_image_index; i++) {
         asset_image *reference = asset_image_get_from_id(i);
-        if (get_image_reference_type(reference) != IMAGE_ORIGINAL && reference->last_layer->asset_image_path &&
+        if (!reference->is_deferred && get_image_reference_type(reference) != IMAGE_ORIGINAL &&
+            reference->last_layer->asset_image_path &&
             strcmp(reference->last_layer->asset_image_path, img->last_layer->asset_image_path) == 0 &&
             reference->last_layer->src_x == img->last_layer->src_x &&
             reference->last_layer->src_y == img->last_layer->src_y) {
@@ -199,6 +211,110 @@ static void split_top_and_footprint(const image *img, color_t *dst, const color_
     image_copy_isometric_footprint(&copy);
 }
 
+typedef struct {
+    const char *path;
+    uint8_t *file_data;
+    size_t file_length;
+    color_t *pixels;
+    int width;
+    int height;
+} png_decode_job;
+
+static uint8_t *read_asset_file(const char *path, size_t *length)
+{
+    FILE *fp = file_open_asset(path, "rb");
+    if (!fp) {
+        return 0;
+    }
+    uint8_t *file_data = 0;
+    size_t size = 0;
+    size_t capacity = 0;
+    while (1) {
+        if (size == capacity) {
+            capacity += PNG_FILE_READ_STEP;
+            uint8_t *new_data = realloc(file_data, capacity);
+            if (!new_data) {
+                free(file_data);
+                file_close(fp);
+                return 0;
+            }
+            file_data = new_data;
+        }
+        size_t bytes_read = fread(file_data + size, 1, capacity - size, fp);
+        size += bytes_read;
+        if (!bytes_read) {
+            break;
+        }
+    }
+    file_close(fp);
+    *length = size;
+    return file_data;
+}
+
+static void decode_png_file(int task, int worker, void *userdata)
+{
+    png_decode_job *job = &((png_decode_job *) userdata)[task];
+    job->pixels = png_decode_from_buffer(job->file_data, job->file_length, &job->width, &job->height);
+}
+
+static int add_png_decode_jobs(const asset_image *img, png_decode_job *jobs, int num_jobs, int max_jobs)
+{
+    for (const layer *l = img->last_layer; l && num_jobs < max_jobs; l = l->prev) {
+        if (l->calculated_image_id || !l->asset_image_path || png_has_decoded_file(l->asset_image_path)) {
+            continue;
+        }
+        int is_new = 1;
+        for (int i = 0; i < num_jobs && is_new; i++) {
+            is_new = strcmp(jobs[i].path, l->asset_image_path) != 0;
+        }
+        if (is_new) {
+            memset(&jobs[num_jobs], 0, sizeof(png_decode_job));
+            jobs[num_jobs++].path = l->asset_image_path;
+        }
+    }
+    return num_jobs;
+}
+
+/**
+ * Decodes the png files of the next images on all workers, so load_image only composites the layers.
+ * Only the images before end_index whose deferred state matches the one given are looked at.
+ * Files are read on the main thread, as opening files is not thread safe on every platform.
+ * Returns the index of the first image whose files were not looked at.
+ */
+static unsigned int decode_png_files_ahead(unsigned int first_index, unsigned int end_index, int deferred)
+{
+    png_clear_decoded_files();
+    int workers = platform_thread_pool_worker_count();
+    if (workers == 1) {
+        return end_index;
+    }
+    png_decode_job jobs[MAX_PNG_FILES_TO_DECODE];
+    int max_jobs = workers * PNG_FILES_TO_DECODE_PER_WORKER;
+    if (max_jobs > MAX_PNG_FILES_TO_DECODE) {
+        max_jobs = MAX_PNG_FILES_TO_DECODE;
+    }
+    int num_jobs = 0;
+    unsigned int index;
+    for (index = first_index; index < end_index && num_jobs < max_jobs; index++) {
+        const asset_image *img = array_item(data.asset_images, index);
+        if (!img->is_reference && img->is_deferred == deferred) {
+            num_jobs = add_png_decode_jobs(img, jobs, num_jobs, max_jobs);
+        }
+    }
+    for (int i = 0; i < num_jobs; i++) {
+        jobs[i].file_data = read_asset_file(jobs[i].path, &jobs[i].file_length);
+    }
+    platform_thread_pool_run(num_jobs, decode_png_file, jobs);
+    for (int i = 0; i < num_jobs; i++) {
+        free(jobs[i].file_data);
+        // Files that failed to decode are loaded again later, which also logs the problem
+        if (jobs[i].pixels && !png_add_decoded_file(jobs[i].path, jobs[i].pixels, jobs[i].width, jobs[i].height)) {
+            free(jobs[i].pixels);
+        }
+    }
+    return index;
+}
+
 static int load_image(asset_image *img, color_t **main_images, int *main_image_widths)
 {
     img->img.original.width = img->img.width;
@@ -218,13 +334,13 @@ static int load_image(asset_image *img, color_t **main_images, int *main_image_w
     }
     int has_alpha_mask = load_image_layers(img, main_images, main_image_widths);
 
-    color_t *pixels = malloc(sizeof(color_t) * img->img.width * img->img.height);
+    color_t *pixels = core_memory_calloc(MEMORY_TAG_ASSET,
+        (size_t) img->img.width * img->img.height, sizeof(color_t));
     if (!pixels) {
         log_error("Error creating image - out of memory", 0, 0);
         unload_image_layers(img);
         return 0;
     }
-    memset(pixels, 0, sizeof(color_t) * img->img.width * img->img.height);
 
     // Images with an alpha mask layer need to be loaded from first to last, which is slower
     const layer *l = has_alpha_mask ? &img->first_layer : img->last_layer;
@@ -339,7 +455,8 @@ static int load_image(asset_image *img, color_t **main_images, int *main_image_w
             img->img.top->original.width = img->img.top->width;
             img->img.top->original.height = img->img.top->height;
             img->img.atlas.y_offset = img->img.top->height;
-            color_t *new_data = malloc(sizeof(color_t) * (img->img.height + img->img.top->height) * img->img.width);
+            color_t *new_data = core_memory_alloc(MEMORY_TAG_ASSET,
+                sizeof(color_t) * (img->img.height + img->img.top->height) * img->img.width);
             if (!new_data) {
                 log_error("Error creating image - out of memory", 0, 0);
                 unload_image_layers(img);
@@ -349,7 +466,7 @@ static int load_image(asset_image *img, color_t **main_images, int *main_image_w
             split_top_and_footprint(&img->img, new_data, pixels, img->img.height);
 
             img->img.height = footprint_height;
-            free(pixels);
+            core_memory_free(MEMORY_TAG_ASSET, pixels);
             pixels = new_data;
         }
         if (reference_type == IMAGE_FULL_REFERENCE) {
@@ -454,7 +571,7 @@ void asset_image_unload(asset_image *img)
 {
     unload_image_layers(img);
     free((char *) img->id);
-    free((color_t *) img->data); // Freeing a const pointer - ugly but necessary
+    core_memory_free(MEMORY_TAG_ASSET, (color_t *) img->data); // Freeing a const pointer - ugly but necessary
     if (!img->is_reference) {
         free(img->img.top);
     }
@@ -462,6 +579,7 @@ void asset_image_unload(asset_image *img)
     img->id = 0;
     img->data = 0;
     img->active = 0;
+    img->is_deferred = 0;
     memset(&img->img, 0, sizeof(image));
 }
 
@@ -493,9 +611,49 @@ asset_image *asset_image_create(void)
     return result;
 }
 
-int asset_image_load_all(color_t **main_images, int *main_image_widths)
+#ifndef BUILDING_ASSET_PACKER
+static int can_defer_image(const asset_image *img)
+{
+    if (!img->active || img->is_reference || img->img.is_isometric) {
+        return 0;
+    }
+    for (const layer *l = &img->first_layer; l; l = l->next) {
+        if (l->calculated_image_id || !l->asset_image_path) {
+            return 0;
+        }
+    }
+    return graphics_renderer()->should_pack_image(img->img.width, img->img.height);
+}
+
+/**
+ * Marks the images whose loading can wait until their group is first used.
+ * Only plain images made from png files qualify. Images used by other images, either as a layer
+ * or as a reference, are always loaded right away, as the other images need their pixels or position.
+ */
+static void mark_deferred_images(void)
+{
+    asset_image *img;
+    array_foreach(data.asset_images, img) {
+        img->is_deferred = can_defer_image(img);
+    }
+    array_foreach(data.asset_images, img) {
+        for (const layer *l = &img->first_layer; l; l = l->next) {
+            asset_image *used_image = asset_image_get_from_id(l->calculated_image_id - IMAGE_MAIN_ENTRIES);
+            if (used_image) {
+                used_image->is_deferred = 0;
+            }
+        }
+    }
+}
+#endif
+
+int asset_image_load_all(color_t **main_images, int *main_image_widths, int defer_loading)
 {
 #ifndef BUILDING_ASSET_PACKER
+    if (defer_loading) {
+        mark_deferred_images();
+    }
+
     image_packer packer;
     int max_width, max_height;
     graphics_renderer()->get_max_image_size(&max_width, &max_height);
@@ -507,13 +665,18 @@ int asset_image_load_all(color_t **main_images, int *main_image_widths)
     packer.options.fail_policy = IMAGE_PACKER_NEW_IMAGE;
     packer.options.reduce_image_size = 1;
     packer.options.sort_by = IMAGE_PACKER_SORT_BY_AREA;
+    packer.options.algorithm = image_atlas_packer_algorithm();
 
     asset_image *current_image;
     int rect = 0;
+    unsigned int decoded_until = 0;
     array_foreach(data.asset_images, current_image) {
-        if (current_image->is_reference) {
+        if (current_image->is_reference || current_image->is_deferred) {
             continue;
         }
+        if (array_index >= decoded_until) {
+            decoded_until = decode_png_files_ahead(array_index, data.asset_images.size, 0);
+        }
         load_image(current_image, main_images, main_image_widths);
         int top_height = current_image->img.top ? current_image->img.top->height : 0;
 
@@ -557,7 +720,10 @@ int asset_image_load_all(color_t **main_images, int *main_image_widths)
     }
 
     png_unload();
+    png_clear_decoded_files();
+
     image_packer_pack(&packer);
+    image_log_atlas_packing("extra assets", &packer);
 
     const image_atlas_data *atlas_data = graphics_renderer()->prepare_image_atlas(ATLAS_EXTRA_ASSET,
         packer.result.images_needed, packer.result.last_image_width, packer.result.last_image_height);
@@ -570,13 +736,16 @@ int asset_image_load_all(color_t **main_images, int *main_image_widths)
     rect = 0;
 
     array_foreach(data.asset_images, current_image) {
+        if (current_image->is_deferred) {
+            continue;
+        }
         int top_height = current_image->img.top ? current_image->img.top->height : 0;
 
         if (current_image->is_reference) {
             if (current_image->first_layer.calculated_image_id >= IMAGE_MAIN_ENTRIES) {
                 translate_reference_position(current_image);
             } else if (image_is_external(image_get(current_image->first_layer.calculated_image_id))) {
-                free((color_t *) current_image->data); // Freeing a const pointer - ugly but necessary
+                core_memory_free(MEMORY_TAG_ASSET, (color_t *) current_image->data); // Freeing a const pointer
                 current_image->data = 0;
             }
         } else if (graphics_renderer()->should_pack_image(current_image->img.width, current_image->img.height + top_height)) {
@@ -622,7 +791,7 @@ int asset_image_load_all(color_t **main_images, int *main_image_widths)
                 image_copy(&copy);
             }
 
-            free((color_t *) current_image->data); // Freeing a const pointer - ugly but necessary
+            core_memory_free(MEMORY_TAG_ASSET, (color_t *) current_image->data); // Freeing a const pointer
 
             current_image->data = 0;
             rect++;
@@ -640,6 +809,166 @@ int asset_image_load_all(color_t **main_images, int *main_image_widths)
     return 1;
 }
 
+#ifndef BUILDING_ASSET_PACKER
+static void finish_deferred_images(int first_index, int last_index, int first_atlas_image)
+{
+    for (int i = first_index; i <= last_index; i++) {
+        asset_image *img = asset_image_get_from_id(i);
+        if (!img || !img->is_deferred) {
+            continue;
+        }
+        if (first_atlas_image < 0) {
+            img->img.width = 0;
+            img->img.height = 0;
+        } else {
+            img->img.atlas.id += (ATLAS_LAZY_EXTRA_ASSET << IMAGE_ATLAS_BIT_OFFSET) + first_atlas_image;
+        }
+        core_memory_free(MEMORY_TAG_ASSET, (color_t *) img->data); // Freeing a const pointer
+        img->data = 0;
+        img->is_deferred = 0;
+    }
+}
+
+static void free_atlas_buffers(color_t **buffers, int num_images)
+{
+    for (int i = 0; i < num_images; i++) {
+        core_memory_free(MEMORY_TAG_TEXTURE, buffers[i]);
+    }
+    free(buffers);
+}
+
+static color_t **create_atlas_buffers(const int *widths, const int *heights, int num_images)
+{
+    color_t **buffers = calloc(num_images, sizeof(color_t *));
+    if (!buffers) {
+        return 0;
+    }
+    for (int i = 0; i < num_images; i++) {
+        buffers[i] = core_memory_calloc(MEMORY_TAG_TEXTURE, (size_t) widths[i] * heights[i], sizeof(color_t));
+        if (!buffers[i]) {
+            free_atlas_buffers(buffers, num_images);
+            return 0;
+        }
+    }
+    return buffers;
+}
+
+/**
+ * Copies the packed deferred images to new atlas images and sends those to the renderer.
+ * Returns the index of the first new atlas image, or -1 on failure.
+ */
+static int copy_deferred_images_to_atlas(int first_index, int last_index, const image_packer *packer)
+{
+    int max_width, max_height;
+    graphics_renderer()->get_max_image_size(&max_width, &max_height);
+    int num_images = packer->result.images_needed;
+    int *sizes = malloc(sizeof(int) * 2 * num_images);
+    if (!sizes) {
+        log_error("Failed to create deferred images atlas - out of memory", 0, 0);
+        return -1;
+    }
+    int *widths = sizes;
+    int *heights = sizes + num_images;
+    for (int i = 0; i < num_images; i++) {
+        widths[i] = i == num_images - 1 ? packer->result.last_image_width : max_width;
+        heights[i] = i == num_images - 1 ? packer->result.last_image_height : max_height;
+    }
+    color_t **buffers = create_atlas_buffers(widths, heights, num_images);
+    if (!buffers) {
+        log_error("Failed to create deferred images atlas - out of memory", 0, 0);
+        free(sizes);
+        return -1;
+    }
+    int rect = 0;
+    for (int i = first_index; i <= last_index; i++) {
+        asset_image *img = asset_image_get_from_id(i);
+        if (!img || !img->is_deferred) {
+            continue;
+        }
+        const image_packer_rect *packed = &packer->rects[rect++];
+        int atlas_image = packed->output.image_index;
+        img->img.atlas.id = atlas_image;
+        img->img.atlas.x_offset = packed->output.x;
+        img->img.atlas.y_offset = packed->output.y;
+        image_copy_info copy = {
+            .src = { img->img.x_offset, img->img.y_offset,
+                img->img.original.width, img->img.original.height, img->data },
+            .dst = { img->img.atlas.x_offset, img->img.atlas.y_offset,
+                widths[atlas_image], heights[atlas_image], buffers[atlas_image] },
+            .rect = { 0, 0, img->img.width, img->img.height }
+        };
+        image_copy(&copy);
+    }
+    int first_atlas_image = graphics_renderer()->append_image_atlas(ATLAS_LAZY_EXTRA_ASSET,
+        buffers, widths, heights, num_images);
+    free_atlas_buffers(buffers, num_images);
+    free(sizes);
+    return first_atlas_image;
+}
+#endif
+
+int asset_image_load_deferred(int first_index, int last_index)
+{
+#ifndef BUILDING_ASSET_PACKER
+    int total_images = 0;
+    for (int i = first_index; i <= last_index; i++) {
+        const asset_image *img = asset_image_get_from_id(i);
+        if (img && img->is_deferred) {
+            total_images++;
+        }
+    }
+    if (!total_images) {
+        return 0;
+    }
+    image_packer packer;
+    int max_width, max_height;
+    graphics_renderer()->get_max_image_size(&max_width, &max_height);
+    if (image_packer_init(&packer, total_images, max_width, max_height) != IMAGE_PACKER_OK) {
+        log_error("Failed to init image packer", 0, 0);
+        finish_deferred_images(first_index, last_index, -1);
+        return 1;
+    }
+    packer.options.fail_policy = IMAGE_PACKER_NEW_IMAGE;
+    packer.options.reduce_image_size = 1;
+    packer.options.sort_by = IMAGE_PACKER_SORT_BY_AREA;
+    packer.options.algorithm = image_atlas_packer_algorithm();
+
+    data.loading_deferred_images = 1;
+    int rect = 0;
+    int decoded_until = first_index;
+    for (int i = first_index; i <= last_index; i++) {
+        asset_image *img = asset_image_get_from_id(i);
+        if (!img || !img->is_deferred) {
+            continue;
+        }
+        if (i >= decoded_until) {
+            decoded_until = decode_png_files_ahead(i, last_index + 1, 1);
+        }
+        if (load_image(img, 0, 0)) {
+            image_crop(&img->img, img->data);
+        } else {
+            img->img.width = 0;
+            img->img.height = 0;
+        }
+        packer.rects[rect].input.width = img->img.width;
+        packer.rects[rect].input.height = img->img.height;
+        rect++;
+    }
+    data.loading_deferred_images = 0;
+
+    png_unload();
+    png_clear_decoded_files();
+
+    image_packer_pack(&packer);
+    int first_atlas_image = copy_deferred_images_to_atlas(first_index, last_index, &packer);
+    image_packer_free(&packer);
+    finish_deferred_images(first_index, last_index, first_atlas_image);
+    return 1;
+#else
+    return 0;
+#endif
+}
+
 void asset_image_reload_climate(void)
 {
 #ifndef BUILDING_ASSET_PACKER
@@ -692,7 +1021,7 @@ const asset_image *asset_image_create_external(const char *filename)
     img->img.original.width = img->img.width;
     img->img.original.height = img->img.height;
 
-    color_t *pixels = malloc(sizeof(color_t) * img->img.width * img->img.height);
+    color_t *pixels = core_memory_alloc(MEMORY_TAG_ASSET, sizeof(color_t) * img->img.width * img->img.height);
     if (!pixels) {
         free(png);
         png_unload();
@@ -700,6 +1029,7 @@ const asset_image *asset_image_create_external(const char *filename)
         return 0;
     }
     if (!png_read(pixels, 0, 0, img->img.width, img->img.height, 0, 0, img->img.width, 0)) {
+        core_memory_free(MEMORY_TAG_ASSET, pixels);
         free(png);
         png_unload();
         asset_image_unload(img);
@@ -13,6 +13,7 @@ typedef struct {
     image img;
     const color_t *data;
     int is_reference;
+    int is_deferred;
 #ifdef BUILDING_ASSET_PACKER
     int has_frame_elements;
     int has_defined_size;
@@ -31,7 +32,8 @@ asset_image *asset_image_get_from_id(int image_id);
 
 int asset_image_init_array(void);
 asset_image *asset_image_create(void);
-int asset_image_load_all(color_t **main_images, int *main_image_widths);
+int asset_image_load_all(color_t **main_images, int *main_image_widths, int defer_loading);
+int asset_image_load_deferred(int first_index, int last_index);
 void asset_image_reload_climate(void);
 void asset_image_count_isometric(void);
 
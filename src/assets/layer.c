@@ -6,6 +6,7 @@
 #include "assets/xml.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/memory.h"
 #include "core/png_read.h"
 #include "core/string.h"
 
@@ -94,13 +95,12 @@ static void load_layer_from_another_image(layer *l, color_t **main_data, int *ma
     }
 
     size_t size = sizeof(color_t) * width * height;
-    color_t *data = malloc(size);
+    color_t *data = core_memory_calloc(MEMORY_TAG_ASSET, size, 1);
     if (!data) {
         log_error("Problem loading layer from image id - out of memory", 0, l->calculated_image_id);
         load_dummy_layer(l);
         return;
     }
-    memset(data, 0, size);
 
     if (asset_img) {
         int asset_img_width = asset_img->img.width;
@@ -137,7 +137,7 @@ static void load_layer_from_another_image(layer *l, color_t **main_data, int *ma
         }
     } else if (type == ATLAS_EXTERNAL) {
         if (!image_load_external_pixels(data, img, width)) {
-            free(data);
+            core_memory_free(MEMORY_TAG_ASSET, data);
             log_error("Problem loading layer from image id", 0, l->calculated_image_id);
             load_dummy_layer(l);
             return;
@@ -168,7 +168,7 @@ static void load_layer_from_another_image(layer *l, color_t **main_data, int *ma
         int atlas_width = main_image_widths[img->atlas.id & IMAGE_ATLAS_BIT_MASK];
         const color_t *atlas_pixels = main_data[img->atlas.id & IMAGE_ATLAS_BIT_MASK];
         if (!atlas_width || !atlas_pixels) {
-            free(data);
+            core_memory_free(MEMORY_TAG_ASSET, data);
             log_error("Problem loading layer from image id", 0, l->calculated_image_id);
             load_dummy_layer(l);
             return;
@@ -228,16 +228,15 @@ void layer_load(layer *l, color_t **main_data, int *main_image_widths)
     }
 
     size_t size = sizeof(color_t) * l->width * l->height;
-    color_t *data = malloc(size);
+    color_t *data = core_memory_calloc(MEMORY_TAG_ASSET, size, 1);
     if (!data) {
         log_error("Problem loading layer - out of memory", l->asset_image_path, 0);
         load_dummy_layer(l);
         return;
     }
-    memset(data, 0, size);
     if (!png_load_from_file(l->asset_image_path, 1) ||
         !png_read(data, l->src_x, l->src_y, l->width, l->height, 0, 0, l->width, 0)) {
-        free(data);
+        core_memory_free(MEMORY_TAG_ASSET, data);
         log_error("Problem loading layer from file", l->asset_image_path, 0);
         load_dummy_layer(l);
         return;
@@ -259,7 +258,7 @@ void layer_unload(layer *l)
     free(l->original_image_id);
 #endif
     if (!l->calculated_image_id && l->data != &DUMMY_LAYER_DATA) {
-        free((color_t *) l->data); // Freeing a const pointer. Ugly but necessary
+        core_memory_free(MEMORY_TAG_ASSET, (color_t *) l->data); // Freeing a const pointer. Ugly but necessary
     }
     if (l->prev) {
         free(l);
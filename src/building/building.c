@@ -1,6 +1,7 @@
 #include "building.h"
 
 #include "building/distribution.h"
+#include "building/figure.h"
 #include "building/industry.h"
 #include "building/granary.h"
 #include "building/menu.h"
@@ -13,6 +14,7 @@
 #include "building/variant.h"
 #include "city/buildings.h"
 #include "city/finance.h"
+#include "city/labor.h"
 #include "city/population.h"
 #include "city/warning.h"
 #include "core/array.h"
@@ -22,6 +24,7 @@
 #include "figure/figure.h"
 #include "figure/formation_legion.h"
 #include "game/difficulty.h"
+#include "game/replay.h"
 #include "game/save_version.h"
 #include "game/undo.h"
 #include "map/building_tiles.h"
@@ -192,6 +195,7 @@ building *building_create(building_type type, int x, int y)
     b->state = BUILDING_STATE_CREATED;
     b->faction_id = 1;
     b->type = type;
+    b->labor_category = city_labor_category_for_building_type(type);
     b->size = props->size;
     b->created_sequence = extra.created_sequence++;
     b->sentiment.house_happiness = 100;
@@ -212,6 +216,7 @@ building *building_create(building_type type, int x, int y)
     // subtype
     if (building_is_house(type)) {
         b->subtype.house_level = type - BUILDING_HOUSE_VACANT_LOT;
+        building_figure_house_changed(b);
     }
 
     b->output_resource_id = resource_get_from_industry(type);
@@ -264,8 +269,12 @@ void building_change_type(building *b, building_type type)
     if (b->type == type) {
         return;
     }
+    if (building_is_house(b->type) || building_is_house(type)) {
+        building_figure_house_changed(b);
+    }
     remove_adjacent_types(b);
     b->type = type;
+    b->labor_category = city_labor_category_for_building_type(type);
     fill_adjacent_types(b);
 }
 
@@ -518,6 +527,7 @@ int building_is_fort(building_type type)
 
 int building_mothball_toggle(building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_BUILDING_MOTHBALL_TOGGLE, b->id, 0, 0);
     if (b->state == BUILDING_STATE_IN_USE) {
         b->state = BUILDING_STATE_MOTHBALLED;
         b->num_workers = 0;
@@ -543,6 +553,7 @@ int building_mothball_set(building *b, int mothball)
 
 unsigned char building_stockpiling_toggle(building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_BUILDING_STOCKPILING_TOGGLE, b->id, 0, 0);
     b->data.industry.is_stockpiling = !b->data.industry.is_stockpiling;
     return b->data.industry.is_stockpiling;
 }
@@ -652,6 +663,7 @@ int building_is_close_to_water(const building *b)
 void building_save_state(buffer *buf, buffer *highest_id, buffer *highest_id_ever,
     buffer *sequence, buffer *corrupt_houses)
 {
+    building_figure_update_house_spawn_delays();
     int buf_size = sizeof(int32_t) + data.buildings.size * BUILDING_STATE_CURRENT_BUFFER_SIZE;
     uint8_t *buf_data = malloc(buf_size);
     buffer_init(buf, buf_data, buf_size);
@@ -31,6 +31,12 @@ typedef struct building {
     struct building *next_of_type;
 
     time_millis last_update;
+    struct {
+        unsigned char type;
+        unsigned int start_day;
+        unsigned int due_day;
+        unsigned char has_road_access;
+    } house_spawn; // not saved, rebuilt from figure_spawn_delay
 
     unsigned char state;
     unsigned char faction_id;
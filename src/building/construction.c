@@ -24,6 +24,7 @@
 #include "core/config.h"
 #include "core/image.h"
 #include "figure/formation.h"
+#include "game/replay.h"
 #include "game/undo.h"
 #include "graphics/window.h"
 #include "map/aqueduct.h"
@@ -1000,6 +1001,7 @@ void building_construction_place(void)
     if (!type) {
         return;
     }
+    game_replay_record_construction(type, x_start, y_start, x_end, y_end);
     if (city_finance_out_of_money()) {
         map_property_clear_constructing_and_deleted();
         city_warning_show(WARNING_OUT_OF_MONEY, NEW_WARNING_SLOT);
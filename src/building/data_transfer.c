@@ -4,6 +4,7 @@
 #include "building/roadblock.h"
 #include "building/storage.h"
 #include "city/warning.h"
+#include "game/replay.h"
 
 #include <string.h>
 
@@ -34,6 +35,7 @@ int building_data_transfer_possible(building *b)
 
 int building_data_transfer_copy(building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_DATA_TRANSFER_COPY, b->id, 0, 0);
     building_data_type data_type = building_data_transfer_data_type_from_building_type(b->type);
     if (data_type == DATA_TYPE_NOT_SUPPORTED) {
         city_warning_show(WARNING_DATA_COPY_NOT_SUPPORTED, NEW_WARNING_SLOT);
@@ -84,6 +86,7 @@ int building_data_transfer_copy(building *b)
 
 int building_data_transfer_paste(building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_DATA_TRANSFER_PASTE, b->id, 0, 0);
     building_data_type data_type = building_data_transfer_data_type_from_building_type(b->type);
 
     if (!building_data_transfer_possible(b)) {
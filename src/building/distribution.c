@@ -6,6 +6,7 @@
 #include "city/resource.h"
 #include "core/calc.h"
 #include "empire/city.h"
+#include "game/replay.h"
 
 #include <string.h>
 
@@ -26,6 +27,7 @@ int building_distribution_check_if_accepts_nothing(const building *b)
 
 void building_distribution_toggle_good_accepted(building *b, resource_type resource)
 {
+    game_replay_record_command(REPLAY_COMMAND_DISTRIBUTION_TOGGLE_GOOD_ACCEPTED, b->id, resource, 0);
     if (b->accepted_goods[resource] == 0) {
         b->accepted_goods[resource] = 1;
     } else {
@@ -40,6 +42,7 @@ void building_distribution_unaccept_all_goods(building *b)
 
 void building_distribution_accept_all_goods(building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_DISTRIBUTION_ACCEPT_ALL_GOODS, b->id, 0, 0);
     for (resource_type resource = 0; resource < RESOURCE_MAX_WITH_MONUMENT_RESOURCES; resource++) {
         b->accepted_goods[resource] = 1;
     }
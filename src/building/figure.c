@@ -24,6 +24,7 @@
 #include "core/calc.h"
 #include "core/config.h"
 #include "core/image.h"
+#include "core/log.h"
 #include "figure/figure.h"
 #include "figure/formation_legion.h"
 #include "figure/movement.h"
@@ -37,13 +38,48 @@
 #include "map/water.h"
 #include "scenario/scenario.h"
 
+#include <stdlib.h>
 
 
 #define BEGGAR_UNEMPLOYMENT_THRESHOLD 6
+#define BEGGAR_SPAWN_DELAY 16
+#define PATRICIAN_SPAWN_DELAY 40
+// Must be larger than the longest spawn delay, so a slot only holds houses due on a single day
+#define HOUSE_SPAWN_WHEEL_SIZE 64
+
+typedef enum {
+    HOUSE_SPAWN_NONE = 0,
+    HOUSE_SPAWN_BEGGAR = 1,
+    HOUSE_SPAWN_PATRICIAN = 2,
+    HOUSE_SPAWN_MAX = 3
+} house_spawn_type;
+
+typedef struct {
+    int building_id;
+    unsigned int due_day;
+} house_spawn_entry;
 
 static struct {
     int beggar_counter;
     int houses_needed_per_beggar;
+    // Houses only spawn beggars or patricians every few days, so instead of checking them all every day
+    // they wait in a timing wheel keyed by the day on which their figure_spawn_delay runs out.
+    // Beggar days only pass when unemployment is high enough, as the delay does not increase otherwise.
+    // A house is only looked at again when it changed type or when road access may have changed.
+    struct {
+        int *items;
+        int size;
+        int capacity;
+    } changed_houses;
+    unsigned int road_access_version;
+    struct {
+        unsigned int day;
+        struct {
+            house_spawn_entry *items;
+            int size;
+            int capacity;
+        } slots[HOUSE_SPAWN_WHEEL_SIZE];
+    } wheels[HOUSE_SPAWN_MAX];
 } data;
 
 static int worker_percentage(const building *b)
@@ -167,41 +203,217 @@ static void calculate_houses_needed_per_beggar(void)
 
 }
 
-static void spawn_beggar(building *b)
+static house_spawn_type get_house_spawn_type(const building *b)
 {
+    if (b->type >= BUILDING_HOUSE_SMALL_TENT && b->type <= BUILDING_HOUSE_GRAND_INSULA) {
+        return HOUSE_SPAWN_BEGGAR;
+    } else if (b->type >= BUILDING_HOUSE_SMALL_VILLA && b->type <= BUILDING_HOUSE_LUXURY_PALACE) {
+        return HOUSE_SPAWN_PATRICIAN;
+    }
+    return HOUSE_SPAWN_NONE;
+}
+
+static int get_house_spawn_delay(house_spawn_type type)
+{
+    return type == HOUSE_SPAWN_BEGGAR ? BEGGAR_SPAWN_DELAY : PATRICIAN_SPAWN_DELAY;
+}
+
+static void add_to_house_spawn_wheel(house_spawn_type type, int building_id, unsigned int due_day)
+{
+    int slot_index = due_day % HOUSE_SPAWN_WHEEL_SIZE;
+    if (data.wheels[type].slots[slot_index].size == data.wheels[type].slots[slot_index].capacity) {
+        int new_capacity = data.wheels[type].slots[slot_index].capacity ?
+            data.wheels[type].slots[slot_index].capacity * 2 : 64;
+        house_spawn_entry *items = realloc(data.wheels[type].slots[slot_index].items,
+            sizeof(house_spawn_entry) * new_capacity);
+        if (!items) {
+            log_error("Unable to allocate memory for house walker spawns", 0, 0);
+            return;
+        }
+        data.wheels[type].slots[slot_index].items = items;
+        data.wheels[type].slots[slot_index].capacity = new_capacity;
+    }
+    house_spawn_entry *entry =
+        &data.wheels[type].slots[slot_index].items[data.wheels[type].slots[slot_index].size++];
+    entry->building_id = building_id;
+    entry->due_day = due_day;
+}
+
+// Adds the days since the house was scheduled, up to the last day that was run, to its spawn delay.
+// As before, the days on which the house lacks road access are not counted. Road access is checked again
+// whenever it may have changed, so it was the same on all of these days.
+static void update_house_spawn_delay(building *b, unsigned int last_day)
+{
+    if (b->house_spawn.type == HOUSE_SPAWN_NONE || last_day < b->house_spawn.start_day) {
+        return;
+    }
+    if (b->house_spawn.has_road_access) {
+        int delay = b->figure_spawn_delay + (int) (last_day - b->house_spawn.start_day) + 1;
+        b->figure_spawn_delay = delay > 255 ? 255 : delay;
+    }
+    b->house_spawn.start_day = last_day + 1;
+}
+
+static void schedule_house_spawn(building *b, house_spawn_type type)
+{
+    unsigned int last_day = data.wheels[type].day;
+    // Saved delays keep their meaning, so loading never makes houses spawn all at once. A delay past its limit,
+    // like the one of a villa waiting for another patrician to spawn first, makes the house due tomorrow.
+    int days_left = get_house_spawn_delay(type) + 1 - b->figure_spawn_delay;
+    if (days_left < 1) {
+        days_left = 1;
+    }
+    b->house_spawn.type = type;
+    b->house_spawn.start_day = last_day + 1;
+    b->house_spawn.due_day = last_day + days_left;
+    add_to_house_spawn_wheel(type, b->id, b->house_spawn.due_day);
+}
+
+static void stop_house_spawn(building *b, house_spawn_type type)
+{
+    b->house_spawn.type = type;
+    b->house_spawn.start_day = data.wheels[type].day + 1;
+    b->house_spawn.due_day = 0;
+}
+
+static void check_house_spawn_schedule(building *b)
+{
+    house_spawn_type type = get_house_spawn_type(b);
     map_point road;
-    if (map_has_road_access(b->x, b->y, b->size, &road)) {
-        b->figure_spawn_delay++;
-        if (b->figure_spawn_delay > 16) {
-            b->figure_spawn_delay = 0;
-            if (data.beggar_counter > data.houses_needed_per_beggar) {
-                data.beggar_counter = 0;
-            } else {
-                data.beggar_counter++;
-                return;
+    int has_road_access = type != HOUSE_SPAWN_NONE && map_has_road_access(b->x, b->y, b->size, &road);
+    // A house that was restored by undo may still wait for a day that has already passed
+    if (b->house_spawn.type == type && b->house_spawn.has_road_access == has_road_access &&
+        (!has_road_access || b->house_spawn.due_day > data.wheels[type].day)) {
+        return;
+    }
+    // A house that evolved between insulae and villas keeps its delay, like before
+    update_house_spawn_delay(b, data.wheels[b->house_spawn.type].day);
+    b->house_spawn.has_road_access = has_road_access;
+    if (has_road_access) {
+        schedule_house_spawn(b, type);
+    } else {
+        stop_house_spawn(b, type);
+    }
+}
+
+void building_figure_house_changed(const building *b)
+{
+    if (data.changed_houses.size == data.changed_houses.capacity) {
+        int new_capacity = data.changed_houses.capacity ? data.changed_houses.capacity * 2 : 64;
+        int *items = realloc(data.changed_houses.items, sizeof(int) * new_capacity);
+        if (!items) {
+            log_error("Unable to allocate memory for house walker spawns", 0, 0);
+            return;
+        }
+        data.changed_houses.items = items;
+        data.changed_houses.capacity = new_capacity;
+    }
+    data.changed_houses.items[data.changed_houses.size++] = b->id;
+}
+
+static void check_house_spawn_schedules(void)
+{
+    unsigned int road_access_version = map_road_access_version();
+    if (road_access_version != data.road_access_version) {
+        data.road_access_version = road_access_version;
+        for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
+            for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
+                if (b->state == BUILDING_STATE_IN_USE) {
+                    check_house_spawn_schedule(b);
+                }
+            }
+        }
+    } else {
+        for (int i = 0; i < data.changed_houses.size; i++) {
+            int building_id = data.changed_houses.items[i];
+            if (building_id >= building_count()) {
+                continue;
+            }
+            building *b = building_get(building_id);
+            if (b->state == BUILDING_STATE_IN_USE && building_is_house(b->type)) {
+                check_house_spawn_schedule(b);
             }
-            figure *f = figure_create(FIGURE_BEGGAR, road.x, road.y, DIR_4_BOTTOM);
-            f->building_id = b->id;
         }
     }
+    data.changed_houses.size = 0;
 }
 
+void building_figure_update_house_spawn_delays(void)
+{
+    for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
+        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
+            update_house_spawn_delay(b, data.wheels[b->house_spawn.type].day);
+        }
+    }
+}
 
-static int spawn_patrician(building *b, int spawned)
+static void spawn_beggar(building *b, const map_point *road)
 {
-    map_point road;
-    if (map_has_road_access(b->x, b->y, b->size, &road)) {
-        b->figure_spawn_delay++;
-        if (b->figure_spawn_delay > 40 && !spawned) {
-            b->figure_spawn_delay = 0;
-            figure *f = figure_create(FIGURE_PATRICIAN, road.x, road.y, DIR_4_BOTTOM);
-            f->action_state = FIGURE_ACTION_125_ROAMING;
-            f->building_id = b->id;
-            figure_movement_init_roaming(f);
-            return 1;
+    b->figure_spawn_delay = 0;
+    if (data.beggar_counter > data.houses_needed_per_beggar) {
+        data.beggar_counter = 0;
+    } else {
+        data.beggar_counter++;
+        return;
+    }
+    figure *f = figure_create(FIGURE_BEGGAR, road->x, road->y, DIR_4_BOTTOM);
+    f->building_id = b->id;
+}
+
+static int spawn_patrician(building *b, const map_point *road, int spawned)
+{
+    // Only one patrician spawns per day, the other houses that are due try again tomorrow
+    if (spawned) {
+        return spawned;
+    }
+    b->figure_spawn_delay = 0;
+    figure *f = figure_create(FIGURE_PATRICIAN, road->x, road->y, DIR_4_BOTTOM);
+    f->action_state = FIGURE_ACTION_125_ROAMING;
+    f->building_id = b->id;
+    figure_movement_init_roaming(f);
+    return 1;
+}
+
+static int compare_house_spawn_entries(const void *a, const void *b)
+{
+    return ((const house_spawn_entry *) a)->building_id - ((const house_spawn_entry *) b)->building_id;
+}
+
+static void spawn_due_house_figures(house_spawn_type type)
+{
+    unsigned int day = ++data.wheels[type].day;
+    int slot_index = day % HOUSE_SPAWN_WHEEL_SIZE;
+    house_spawn_entry *entries = data.wheels[type].slots[slot_index].items;
+    int size = data.wheels[type].slots[slot_index].size;
+    data.wheels[type].slots[slot_index].size = 0;
+    if (!size) {
+        return;
+    }
+    // Houses spawn in the same order as when they were all checked every day
+    qsort(entries, size, sizeof(house_spawn_entry), compare_house_spawn_entries);
+    int spawned = 0;
+    for (int i = 0; i < size; i++) {
+        building *b = building_get(entries[i].building_id);
+        // Entries of houses that were removed, evolved to another kind or scheduled again are dropped
+        if (b->state != BUILDING_STATE_IN_USE || b->house_spawn.type != type ||
+            b->house_spawn.due_day != entries[i].due_day || get_house_spawn_type(b) != type) {
+            continue;
+        }
+        map_point road;
+        if (map_has_road_access(b->x, b->y, b->size, &road)) {
+            update_house_spawn_delay(b, day);
+            if (type == HOUSE_SPAWN_BEGGAR) {
+                spawn_beggar(b, &road);
+            } else {
+                spawned = spawn_patrician(b, &road, spawned);
+            }
+            schedule_house_spawn(b, type);
+        } else {
+            update_house_spawn_delay(b, day - 1);
+            b->house_spawn.has_road_access = 0;
+            stop_house_spawn(b, type);
         }
     }
-    return spawned;
 }
 
 static void spawn_figure_warehouse(building *b)
@@ -1972,8 +2184,8 @@ static void update_native_crop_progress(building *b)
 
 void building_figure_generate(void)
 {
-    int patrician_generated = 0;
     calculate_houses_needed_per_beggar();
+    check_house_spawn_schedules();
     for (int i = 1; i < building_count(); i++) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE) {
@@ -1987,12 +2199,8 @@ void building_figure_generate(void)
 
         b->show_on_problem_overlay = 0;
         // range of building types
-        if (b->type >= BUILDING_HOUSE_SMALL_TENT && b->type <= BUILDING_HOUSE_GRAND_INSULA) {
-            if (city_labor_unemployment_percentage() > BEGGAR_UNEMPLOYMENT_THRESHOLD) {
-                spawn_beggar(b);
-            }
-        } else if (b->type >= BUILDING_HOUSE_SMALL_VILLA && b->type <= BUILDING_HOUSE_LUXURY_PALACE) {
-            patrician_generated = spawn_patrician(b, patrician_generated);
+        if (b->type >= BUILDING_HOUSE_SMALL_TENT && b->type <= BUILDING_HOUSE_LUXURY_PALACE) {
+            // Houses spawn their walkers from the timing wheels below
         } else if (building_is_raw_resource_producer(b->type) ||
             building_is_farm(b->type) || building_is_workshop(b->type)) {
             spawn_figure_industry(b);
@@ -2148,4 +2356,8 @@ void building_figure_generate(void)
             }
         }
     }
+    spawn_due_house_figures(HOUSE_SPAWN_PATRICIAN);
+    if (city_labor_unemployment_percentage() > BEGGAR_UNEMPLOYMENT_THRESHOLD) {
+        spawn_due_house_figures(HOUSE_SPAWN_BEGGAR);
+    }
 }
@@ -1,6 +1,19 @@
 #ifndef BUILDING_FIGURE_H
 #define BUILDING_FIGURE_H
 
+#include "building/building.h"
+
 void building_figure_generate(void);
 
+/**
+ * Makes the next walker spawn check look at the house again, as it was created or changed type
+ * @param b The house
+ */
+void building_figure_house_changed(const building *b);
+
+/**
+ * Brings the walker spawn delay of every house up to date. Called before the buildings are saved.
+ */
+void building_figure_update_house_spawn_delays(void);
+
 #endif // BUILDING_FIGURE_H
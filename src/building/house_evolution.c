@@ -7,6 +7,7 @@
 #include "city/resource.h"
 #include "core/calc.h"
 #include "core/config.h"
+#include "core/log.h"
 #include "core/time.h"
 #include "game/resource.h"
 #include "game/time.h"
@@ -16,19 +17,62 @@
 #include "map/routing_terrain.h"
 #include "map/terrain.h"
 #include "map/tiles.h"
+#include "platform/thread_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
 
 #define DEVOLVE_DELAY 2
 #define DEVOLVE_DELAY_WITH_VENUS 20
 
+#define PARALLEL_EVOLVE_MIN_HOUSES 512
+#define HOUSES_PER_EVOLVE_TASK 128
+
 typedef enum {
     EVOLVE = 1,
     NONE = 0,
     DEVOLVE = -1
 } evolve_status;
 
+// Every house field the requirement checks read. A precalculated decision is only used
+// when none of these changed between the evaluation and the moment the house evolves.
+typedef struct {
+    building_type type;
+    short house_level;
+    unsigned char house_pantheon_access;
+    signed char desirability;
+    unsigned char has_water_access;
+    unsigned char has_well_access;
+    unsigned char has_latrines_access;
+    unsigned char entertainment;
+    unsigned char education;
+    unsigned char num_gods;
+    unsigned char barber;
+    unsigned char bathhouse;
+    unsigned char health;
+    short resources[RESOURCE_MAX];
+} house_evolve_inputs;
+
+typedef struct {
+    house_evolve_inputs inputs;
+    int status;
+    int desirability_status;
+    house_demands demands;
+} house_evolve_decision;
+
 static int active_devolve_delay;
 
-static int check_evolve_desirability(building *house, int bonus)
+static struct {
+    int pantheon_module_active;
+    building **houses;
+    house_evolve_decision *decisions;
+    int num_houses;
+    int capacity;
+    int *decision_index; // by building id, 0 means no decision
+    int decision_index_size;
+} evaluation;
+
+static int get_evolve_desirability_status(const building *house, int bonus)
 {
     int level = house->subtype.house_level;
     level -= bonus;
@@ -47,11 +91,10 @@ static int check_evolve_desirability(building *house, int bonus)
     } else {
         status = NONE;
     }
-    house->data.house.evolve_text_id = status; // BUG? -1 in an unsigned char?
     return status;
 }
 
-static int has_required_goods_and_services(building *house, int for_upgrade, int with_bonus, house_demands *demands)
+static int has_required_goods_and_services(const building *house, int for_upgrade, int with_bonus, house_demands *demands)
 {
     int level = house->subtype.house_level;
     if (for_upgrade) {
@@ -191,21 +234,102 @@ static int has_required_goods_and_services(building *house, int for_upgrade, int
     return 1;
 }
 
-static int check_requirements(building *house, house_demands *demands)
+static int get_requirements_status(const building *house, int pantheon_module_active,
+    house_demands *demands, int *desirability_status)
 {
-    int bonus = 0;
-    if (building_monument_pantheon_module_is_active(PANTHEON_MODULE_2_HOUSING_EVOLUTION) && house->house_pantheon_access) {
-        bonus++;
-    }
-    int status = check_evolve_desirability(house, bonus);
+    int bonus = pantheon_module_active && house->house_pantheon_access;
+    int status = get_evolve_desirability_status(house, bonus);
+    *desirability_status = status;
     if (!has_required_goods_and_services(house, 0, bonus, demands)) {
         status = DEVOLVE;
-    } else if (status == EVOLVE) {
+    } else if (status == EVOLVE && house->type != BUILDING_HOUSE_LUXURY_PALACE) {
         status = has_required_goods_and_services(house, 1, bonus, demands);
     }
     return status;
 }
 
+static void get_evolve_inputs(const building *house, house_evolve_inputs *inputs)
+{
+    memset(inputs, 0, sizeof(house_evolve_inputs));
+    inputs->type = house->type;
+    inputs->house_level = house->subtype.house_level;
+    inputs->house_pantheon_access = house->house_pantheon_access;
+    inputs->desirability = house->desirability;
+    inputs->has_water_access = house->has_water_access;
+    inputs->has_well_access = house->has_well_access;
+    inputs->has_latrines_access = house->has_latrines_access;
+    inputs->entertainment = house->data.house.entertainment;
+    inputs->education = house->data.house.education;
+    inputs->num_gods = house->data.house.num_gods;
+    inputs->barber = house->data.house.barber;
+    inputs->bathhouse = house->data.house.bathhouse;
+    inputs->health = house->data.house.health;
+    memcpy(inputs->resources, house->resources, sizeof(inputs->resources));
+}
+
+static void add_demands(house_demands *demands, const house_demands *added)
+{
+    demands->missing.well += added->missing.well;
+    demands->missing.fountain += added->missing.fountain;
+    demands->missing.entertainment += added->missing.entertainment;
+    demands->missing.more_entertainment += added->missing.more_entertainment;
+    demands->missing.education += added->missing.education;
+    demands->missing.more_education += added->missing.more_education;
+    demands->missing.religion += added->missing.religion;
+    demands->missing.second_religion += added->missing.second_religion;
+    demands->missing.third_religion += added->missing.third_religion;
+    demands->missing.barber += added->missing.barber;
+    demands->missing.bathhouse += added->missing.bathhouse;
+    demands->missing.clinic += added->missing.clinic;
+    demands->missing.hospital += added->missing.hospital;
+    demands->missing.food += added->missing.food;
+    demands->missing.second_wine += added->missing.second_wine;
+    demands->requiring.school += added->requiring.school;
+    demands->requiring.library += added->requiring.library;
+    demands->requiring.barber += added->requiring.barber;
+    demands->requiring.bathhouse += added->requiring.bathhouse;
+    demands->requiring.clinic += added->requiring.clinic;
+    demands->requiring.religion += added->requiring.religion;
+}
+
+static const house_evolve_decision *take_decision(const building *house)
+{
+    if (!evaluation.num_houses || house->id >= (unsigned int) evaluation.decision_index_size) {
+        return 0;
+    }
+    int index = evaluation.decision_index[house->id];
+    if (!index) {
+        return 0;
+    }
+    evaluation.decision_index[house->id] = 0;
+    const house_evolve_decision *decision = &evaluation.decisions[index - 1];
+    house_evolve_inputs inputs;
+    get_evolve_inputs(house, &inputs);
+    // Merges and the corruption check may have changed the house since it was evaluated
+    if (memcmp(&inputs, &decision->inputs, sizeof(house_evolve_inputs)) != 0) {
+        return 0;
+    }
+    return decision;
+}
+
+static int check_requirements(building *house, house_demands *demands)
+{
+    int desirability_status;
+    int status;
+    const house_evolve_decision *decision = take_decision(house);
+    if (decision) {
+        add_demands(demands, &decision->demands);
+        desirability_status = decision->desirability_status;
+        status = decision->status;
+    } else {
+        status = get_requirements_status(house,
+            building_monument_pantheon_module_is_active(PANTHEON_MODULE_2_HOUSING_EVOLUTION),
+            demands, &desirability_status);
+    }
+    house->data.house.evolve_text_id = desirability_status; // BUG? -1 in an unsigned char?
+    return status;
+}
+
 static int has_devolve_delay(building *house, evolve_status status)
 {
     if (status == DEVOLVE && house->data.house.devolve_delay < active_devolve_delay) {
@@ -503,11 +627,7 @@ static int evolve_large_palace(building *house, house_demands *demands)
 
 static int evolve_luxury_palace(building *house, house_demands *demands)
 {
-    int bonus = (int) (building_monument_pantheon_module_is_active(PANTHEON_MODULE_2_HOUSING_EVOLUTION) && house->house_pantheon_access);
-    int status = check_evolve_desirability(house, bonus);
-    if (!has_required_goods_and_services(house, 0, bonus, demands)) {
-        status = DEVOLVE;
-    }
+    int status = check_requirements(house, demands);
     if (!has_devolve_delay(house, status) && status == DEVOLVE) {
         building_house_change_to(house, BUILDING_HOUSE_LARGE_PALACE);
     }
@@ -566,6 +686,103 @@ static int (*evolve_callback[])(building *, house_demands *) = {
     evolve_small_palace, evolve_medium_palace, evolve_large_palace, evolve_luxury_palace
 };
 
+static void evaluate_houses(int task, int worker, void *userdata)
+{
+    int first = task * HOUSES_PER_EVOLVE_TASK;
+    int last = first + HOUSES_PER_EVOLVE_TASK;
+    if (last > evaluation.num_houses) {
+        last = evaluation.num_houses;
+    }
+    for (int i = first; i < last; i++) {
+        const building *house = evaluation.houses[i];
+        house_evolve_decision *decision = &evaluation.decisions[i];
+        get_evolve_inputs(house, &decision->inputs);
+        memset(&decision->demands, 0, sizeof(house_demands));
+        decision->status = get_requirements_status(house, evaluation.pantheon_module_active,
+            &decision->demands, &decision->desirability_status);
+    }
+}
+
+static int reserve_evaluation_memory(int num_houses)
+{
+    if (num_houses > evaluation.capacity) {
+        building **houses = realloc(evaluation.houses, num_houses * sizeof(building *));
+        if (houses) {
+            evaluation.houses = houses;
+        }
+        house_evolve_decision *decisions = realloc(evaluation.decisions, num_houses * sizeof(house_evolve_decision));
+        if (decisions) {
+            evaluation.decisions = decisions;
+        }
+        if (!houses || !decisions) {
+            return 0;
+        }
+        evaluation.capacity = num_houses;
+    }
+    int index_size = building_count();
+    if (index_size > evaluation.decision_index_size) {
+        int *decision_index = realloc(evaluation.decision_index, index_size * sizeof(int));
+        if (!decision_index) {
+            return 0;
+        }
+        memset(decision_index + evaluation.decision_index_size, 0,
+            (index_size - evaluation.decision_index_size) * sizeof(int));
+        evaluation.decision_index = decision_index;
+        evaluation.decision_index_size = index_size;
+    }
+    return 1;
+}
+
+/**
+ * Evaluates the requirements of all houses on the thread pool before any of them evolves.
+ * The decisions are applied by check_requirements in the usual order, which falls back to
+ * evaluating a house again if it changed in the meantime, so the outcome is identical to a serial pass.
+ */
+static void evaluate_houses_in_parallel(time_millis last_update)
+{
+    evaluation.num_houses = 0;
+    if (!config_get(CONFIG_GP_PARALLEL_HOUSE_EVOLUTION) || platform_thread_pool_worker_count() < 2) {
+        return;
+    }
+    int num_houses = 0;
+    for (building_type type = BUILDING_HOUSE_VACANT_LOT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
+        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
+            if (b->state == BUILDING_STATE_IN_USE && b->last_update != last_update && !b->has_plague) {
+                num_houses++;
+            }
+        }
+    }
+    if (num_houses < PARALLEL_EVOLVE_MIN_HOUSES) {
+        return;
+    }
+    if (!reserve_evaluation_memory(num_houses)) {
+        log_error("Unable to allocate memory for house evolution, evaluating houses serially.", 0, 0);
+        return;
+    }
+    for (building_type type = BUILDING_HOUSE_VACANT_LOT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
+        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
+            if (b->state == BUILDING_STATE_IN_USE && b->last_update != last_update && !b->has_plague) {
+                evaluation.houses[evaluation.num_houses++] = b;
+            }
+        }
+    }
+    evaluation.pantheon_module_active =
+        building_monument_pantheon_module_is_active(PANTHEON_MODULE_2_HOUSING_EVOLUTION);
+    int num_tasks = (evaluation.num_houses + HOUSES_PER_EVOLVE_TASK - 1) / HOUSES_PER_EVOLVE_TASK;
+    platform_thread_pool_run(num_tasks, evaluate_houses, 0);
+    for (int i = 0; i < evaluation.num_houses; i++) {
+        evaluation.decision_index[evaluation.houses[i]->id] = i + 1;
+    }
+}
+
+static void clear_house_evaluation(void)
+{
+    for (int i = 0; i < evaluation.num_houses; i++) {
+        evaluation.decision_index[evaluation.houses[i]->id] = 0;
+    }
+    evaluation.num_houses = 0;
+}
+
 void building_house_process_evolve_and_consume_goods(void)
 {
     city_houses_reset_demands();
@@ -579,6 +796,7 @@ void building_house_process_evolve_and_consume_goods(void)
     }
 
     time_millis last_update = time_get_millis();
+    evaluate_houses_in_parallel(last_update);
 
     for (building_type type = BUILDING_HOUSE_VACANT_LOT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
         building *next_of_type = 0; // evolve_callback changes the building type
@@ -598,6 +816,7 @@ void building_house_process_evolve_and_consume_goods(void)
             b->last_update = last_update;
         }
     }
+    clear_house_evaluation();
     if (has_expanded) {
         map_routing_update_land();
     }
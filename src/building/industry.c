@@ -12,6 +12,7 @@
 #include "core/image.h"
 #include "core/random.h"
 #include "figure/figure.h"
+#include "game/replay.h"
 #include "game/time.h"
 #include "map/building_tiles.h"
 #include "scenario/property.h"
@@ -332,6 +333,20 @@ int building_industry_has_produced_resource(building *b)
     return b->data.industry.progress >= building_industry_get_max_progress(b);
 }
 
+void building_industry_switch_city_mint_output(building *b)
+{
+    game_replay_record_command(REPLAY_COMMAND_CITY_MINT_SWITCH_OUTPUT, b->id, 0, 0);
+    if (b->output_resource_id == RESOURCE_DENARII) {
+        b->output_resource_id = RESOURCE_GOLD;
+    } else {
+        b->output_resource_id = RESOURCE_DENARII;
+    }
+    b->data.industry.progress = 0;
+    b->data.industry.age_months = 0;
+    b->data.industry.average_production_per_month = 0;
+    b->data.industry.production_current_month = 0;
+}
+
 void building_industry_start_new_production(building *b)
 {
     if (b->type == BUILDING_CITY_MINT && b->output_resource_id == RESOURCE_GOLD &&
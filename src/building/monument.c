@@ -11,6 +11,7 @@
 #include "core/calc.h"
 #include "core/log.h"
 #include "empire/city.h"
+#include "game/replay.h"
 #include "map/building_tiles.h"
 #include "map/grid.h"
 #include "map/orientation.h"
@@ -266,6 +267,7 @@ int building_monument_access_point(building *b, map_point *dst)
 
 int building_monument_add_module(building *b, int module)
 {
+    game_replay_record_command(REPLAY_COMMAND_MONUMENT_ADD_MODULE, b->id, module, 0);
     if (!building_monument_is_monument(b) ||
         b->monument.phase != MONUMENT_FINISHED ||
         (b->monument.upgrades && b->type != BUILDING_CARAVANSERAI && b->type != BUILDING_LIGHTHOUSE)) {
@@ -773,6 +775,7 @@ int building_monument_is_construction_halted(building *b)
 
 int building_monument_toggle_construction_halted(building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_MONUMENT_TOGGLE_CONSTRUCTION_HALTED, b->id, 0, 0);
     if (b->state == BUILDING_STATE_MOTHBALLED) {
         b->state = BUILDING_STATE_IN_USE;
         return 0;
@@ -2,9 +2,11 @@
 
 #include "building/building.h"
 #include "building/type.h"
+#include "game/replay.h"
 
 void building_roadblock_set_permission(roadblock_permission p, building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_ROADBLOCK_SET_PERMISSION, b->id, p, 0);
     if (building_type_is_roadblock(b->type)) {
         int permission_bit = 1 << p;
         b->data.roadblock.exceptions ^= permission_bit;
@@ -45,6 +47,7 @@ int building_type_is_roadblock(building_type type)
 
 void building_roadblock_accept_none(building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_ROADBLOCK_ACCEPT_NONE, b->id, 0, 0);
     if (building_type_is_roadblock(b->type)) {
         b->data.roadblock.exceptions = 0;
     }
@@ -52,6 +55,7 @@ void building_roadblock_accept_none(building *b)
 
 void building_roadblock_accept_all(building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_ROADBLOCK_ACCEPT_ALL, b->id, 0, 0);
     if (building_type_is_roadblock(b->type)) {
         b->data.roadblock.exceptions = ROADBLOCK_PERMISSION_ALL;
     }
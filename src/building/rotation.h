@@ -11,6 +11,12 @@ int building_rotation_get_delta_with_rotation(int default_delta);
 void building_rotation_get_offset_with_rotation(int offset, int rotation, int *x, int *y);
 int building_rotation_get_rotation(void);
 
+/**
+ * Gets the complete rotation state used when placing a building, so the placement can be repeated later
+ */
+void building_rotation_get_state(int *rotation, int *extra_rotation, int *road_orientation);
+void building_rotation_set_state(int rotation, int extra_rotation, int road_orientation);
+
 int building_rotation_get_rotation_with_limit(int limit);
 
 int building_rotation_get_corner(int rot);
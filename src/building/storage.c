@@ -9,6 +9,7 @@
 #include "core/calc.h"
 #include "core/config.h"
 #include "core/log.h"
+#include "game/replay.h"
 #include "game/resource.h"
 #include "game/save_version.h"
 
@@ -81,6 +82,14 @@ void building_storage_reset_building_ids(void)
     }
 }
 
+static void set_all_states(int storage_id, building_storage_state state)
+{
+    data_storage *s = array_item(storages, storage_id);
+    for (int r = RESOURCE_MIN; r < RESOURCE_MAX; r++) {
+        s->storage.resource_state[r].state = state;
+    }
+}
+
 int building_storage_create(int building_id)
 {
     data_storage *storage;
@@ -96,9 +105,9 @@ int building_storage_create(int building_id)
     }
 
     if (config_get(CONFIG_GP_CH_WAREHOUSES_DONT_ACCEPT)) {
-        building_storage_accept_none(storage->id);
+        set_all_states(storage->id, BUILDING_STORAGE_STATE_NOT_ACCEPTING);
     } else {
-        building_storage_accept_all(storage->id);
+        set_all_states(storage->id, BUILDING_STORAGE_STATE_ACCEPTING);
     }
     return storage->id;
 }
@@ -146,6 +155,7 @@ void building_storage_set_data(int storage_id, building_storage new_data)
 
 void building_storage_toggle_empty_all(int storage_id)
 {
+    game_replay_record_command(REPLAY_COMMAND_STORAGE_TOGGLE_EMPTY_ALL, storage_id, 0, 0);
     array_item(storages, storage_id)->storage.empty_all ^= 1;
 }
 
@@ -234,6 +244,7 @@ resource_type building_storage_get_highest_quantity_resource(building *b)
 
 void building_storage_cycle_resource_state(int storage_id, resource_type resource_id)
 {
+    game_replay_record_command(REPLAY_COMMAND_STORAGE_CYCLE_RESOURCE_STATE, storage_id, resource_id, 0);
     resource_storage_entry *entry = &array_item(storages, storage_id)->storage.resource_state[resource_id];
 
     switch (entry->state) {
@@ -257,6 +268,7 @@ void building_storage_cycle_resource_state(int storage_id, resource_type resourc
 
 void building_storage_toggle_permission(building_storage_permission_states p, building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_STORAGE_TOGGLE_PERMISSION, b->id, p, 0);
     int permission_bit = 1 << p;
     array_item(storages, b->storage_id)->storage.permissions ^= permission_bit;
 }
@@ -270,6 +282,7 @@ int building_storage_get_permission(building_storage_permission_states p, buildi
 
 void building_storage_set_permission(building_storage_permission_states p, building *b, int enable)
 {
+    game_replay_record_command(REPLAY_COMMAND_STORAGE_SET_PERMISSION, b->id, p, enable);
     int permission_bit = 1 << p;
     int *permissions = &array_item(storages, b->storage_id)->storage.permissions;
 
@@ -282,6 +295,7 @@ void building_storage_set_permission(building_storage_permission_states p, build
 
 void building_storage_cycle_partial_resource_state(int storage_id, resource_type resource_id, int reverse_order)
 {
+    game_replay_record_command(REPLAY_COMMAND_STORAGE_CYCLE_PARTIAL_RESOURCE_STATE, storage_id, resource_id, reverse_order);
     resource_storage_entry *entry = &array_item(storages, storage_id)->storage.resource_state[resource_id];
 
     if (entry->state == BUILDING_STORAGE_STATE_NOT_ACCEPTING) {
@@ -317,19 +331,15 @@ void building_storage_cycle_partial_resource_state(int storage_id, resource_type
 
 void building_storage_accept_none(int storage_id)
 {
-    data_storage *s = array_item(storages, storage_id);
-    for (int r = RESOURCE_MIN; r < RESOURCE_MAX; r++) {
-        s->storage.resource_state[r].state = BUILDING_STORAGE_STATE_NOT_ACCEPTING;
-    }
+    game_replay_record_command(REPLAY_COMMAND_STORAGE_ACCEPT_NONE, storage_id, 0, 0);
+    set_all_states(storage_id, BUILDING_STORAGE_STATE_NOT_ACCEPTING);
 }
 
 
 void building_storage_accept_all(int storage_id)
 {
-    data_storage *s = array_item(storages, storage_id);
-    for (int r = RESOURCE_MIN; r < RESOURCE_MAX; r++) {
-        s->storage.resource_state[r].state = BUILDING_STORAGE_STATE_ACCEPTING;
-    }
+    game_replay_record_command(REPLAY_COMMAND_STORAGE_ACCEPT_ALL, storage_id, 0, 0);
+    set_all_states(storage_id, BUILDING_STORAGE_STATE_ACCEPTING);
 }
 
 int building_storage_check_if_accepts_nothing(int storage_id)
@@ -455,7 +465,7 @@ void building_storage_load_state(buffer *buf, int version)
             s->storage.empty_all = buffer_read_u8(buf);
 
             if (config_get(CONFIG_GP_CH_WAREHOUSES_DONT_ACCEPT)) {
-                building_storage_accept_none(s->id);
+                set_all_states(s->id, BUILDING_STORAGE_STATE_NOT_ACCEPTING);
             }
 
             for (int r = 0; r < num_resources; r++) {
@@ -505,7 +515,7 @@ void building_storage_load_state(buffer *buf, int version)
         s->storage.empty_all = buffer_read_u8(buf);
 
         if (config_get(CONFIG_GP_CH_WAREHOUSES_DONT_ACCEPT)) {
-            building_storage_accept_none(s->id);
+            set_all_states(s->id, BUILDING_STORAGE_STATE_NOT_ACCEPTING);
         }
 
         for (int r = 0; r < num_resources; r++) {
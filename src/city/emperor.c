@@ -8,6 +8,7 @@
 #include "figure/formation.h"
 #include "game/campaign.h"
 #include "game/difficulty.h"
+#include "game/replay.h"
 #include "game/time.h"
 #include "scenario/property.h"
 #include "scenario/invasion.h"
@@ -27,6 +28,12 @@ static const struct {
 
 static int cheated_invasion = 0;
 
+static void set_salary_rank(int rank)
+{
+    city_data.emperor.salary_rank = rank;
+    city_data.emperor.salary_amount = city_emperor_salary_for_rank(rank);
+}
+
 void city_emperor_init_scenario(int rank)
 {
     city_data.ratings.favor = scenario_starting_favor();
@@ -45,7 +52,7 @@ void city_emperor_init_scenario(int rank)
     if (salary_rank > 10) {
         salary_rank = 10;
     }
-    city_emperor_set_salary_rank(salary_rank);
+    set_salary_rank(salary_rank);
 }
 
 static void update_debt_state(void)
@@ -223,6 +230,7 @@ void city_emperor_calculate_gift_costs(void)
 
 void city_emperor_send_gift(void)
 {
+    game_replay_record_command(REPLAY_COMMAND_EMPEROR_SEND_GIFT, city_data.emperor.selected_gift_size, 0, 0);
     int size = city_data.emperor.selected_gift_size;
     if (size < GIFT_MODEST || size > GIFT_LAVISH) {
         return;
@@ -293,8 +301,8 @@ int city_emperor_salary_for_rank(int rank)
 
 void city_emperor_set_salary_rank(int rank)
 {
-    city_data.emperor.salary_rank = rank;
-    city_data.emperor.salary_amount = city_emperor_salary_for_rank(rank);
+    game_replay_record_command(REPLAY_COMMAND_EMPEROR_SET_SALARY_RANK, rank, 0, 0);
+    set_salary_rank(rank);
 }
 
 int city_emperor_salary_rank(void)
@@ -355,6 +363,7 @@ void city_emperor_change_donation_amount(int change)
 
 void city_emperor_donate_savings_to_city(void)
 {
+    game_replay_record_command(REPLAY_COMMAND_EMPEROR_DONATE_SAVINGS, city_data.emperor.donate_amount, 0, 0);
     city_finance_process_donation(city_data.emperor.donate_amount);
     city_data.emperor.personal_savings -= city_data.emperor.donate_amount;
     city_finance_calculate_totals();
@@ -10,6 +10,7 @@
 #include "city/population.h"
 #include "core/calc.h"
 #include "core/random.h"
+#include "game/replay.h"
 #include "game/time.h"
 #include "scenario/data.h"
 #include "scenario/property.h"
@@ -173,6 +174,7 @@ int city_labor_wages(void)
 
 void city_labor_change_wages(int amount)
 {
+    game_replay_record_wages_change(amount);
     city_data.labor.wages += amount;
     city_data.labor.wages = calc_bound(city_data.labor.wages, 0, 100);
 }
@@ -269,29 +271,60 @@ static int should_have_workers(building *b, int category, int check_access)
     return 1;
 }
 
+unsigned char city_labor_category_for_building_type(building_type type)
+{
+    return (unsigned char) (CATEGORY_FOR_BUILDING_TYPE[type] - 1);
+}
+
+static struct {
+    int initialized;
+    int total[LABOR_CATEGORY_MAX];
+    building_type types[LABOR_CATEGORY_MAX][BUILDING_TYPE_MAX];
+} category_types;
+
+static void init_category_types(void)
+{
+    if (category_types.initialized) {
+        return;
+    }
+    for (building_type type = 0; type < BUILDING_TYPE_MAX; type++) {
+        int cat = CATEGORY_FOR_BUILDING_TYPE[type];
+        if (cat != LABOR_CATEGORY_NONE) {
+            category_types.types[cat][category_types.total[cat]++] = type;
+        }
+    }
+    category_types.initialized = 1;
+}
+
 static void calculate_workers_needed_per_category(void)
 {
+    init_category_types();
     for (int cat = 0; cat < LABOR_CATEGORY_MAX; cat++) {
         city_data.labor.categories[cat].buildings = 0;
         city_data.labor.categories[cat].total_houses_covered = 0;
         city_data.labor.categories[cat].workers_allocated = 0;
         city_data.labor.categories[cat].workers_needed = 0;
     }
-    for (int i = 1; i < building_count(); i++) {
-        building *b = building_get(i);
-        if (b->state != BUILDING_STATE_IN_USE) {
-            continue;
-        }
-        int category = CATEGORY_FOR_BUILDING_TYPE[b->type];
-        b->labor_category = category - 1;
-        if (!should_have_workers(b, category, 1)) {
-            continue;
+    // Only buildings that employ workers are visited, through the per-type lists of each category.
+    // Buildings without workers get their labor_category when they are created or change type.
+    for (int category = LABOR_CATEGORY_NONE + 1; category < LABOR_CATEGORY_MAX; category++) {
+        labor_category_data *data = &city_data.labor.categories[category - 1];
+        for (int i = 0; i < category_types.total[category]; i++) {
+            building_type type = category_types.types[category][i];
+            int laborers = building_get_laborers(type);
+            for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
+                if (b->state != BUILDING_STATE_IN_USE) {
+                    continue;
+                }
+                b->labor_category = category - 1;
+                if (!should_have_workers(b, category, 1)) {
+                    continue;
+                }
+                data->workers_needed += laborers;
+                data->total_houses_covered += b->houses_covered;
+                data->buildings++;
+            }
         }
-
-        city_data.labor.categories[category - 1].workers_needed += building_get_laborers(b->type);
-
-        city_data.labor.categories[category - 1].total_houses_covered += b->houses_covered;
-        city_data.labor.categories[category - 1].buildings++;
     }
 }
 
@@ -432,29 +465,32 @@ static void allocate_workers_to_water(void)
     } else {
         workers_per_building = water_cat->workers_allocated / (water_cat->buildings - buildings_to_skip);
     }
-    int building_id = start_building_id;
+    int first_building_id = start_building_id;
     start_building_id = 0;
-    for (int guard = 1; guard < building_count(); guard++, building_id++) {
-        if (building_id >= building_count()) {
-            building_id = 1;
-        }
-        building *b = building_get(building_id);
-        if (b->state != BUILDING_STATE_IN_USE || CATEGORY_FOR_BUILDING_TYPE[b->type] != LABOR_CATEGORY_WATER) {
-            continue;
-        }
-        b->num_workers = 0;
-        if (b->percentage_houses_covered > 0) {
-            if (percentage_not_filled > 0) {
-                if (buildings_to_skip) {
-                    --buildings_to_skip;
-                } else if (start_building_id) {
-                    b->num_workers = workers_per_building;
-                } else {
-                    start_building_id = building_id;
-                    b->num_workers = workers_per_building;
+    // Visit water buildings in id order, starting at first_building_id and wrapping around.
+    // Fountains are the only water building type, so walking the type list keeps the id order.
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < category_types.total[LABOR_CATEGORY_WATER]; i++) {
+            building_type type = category_types.types[LABOR_CATEGORY_WATER][i];
+            for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
+                if ((pass == 0) != (b->id >= first_building_id) || b->state != BUILDING_STATE_IN_USE) {
+                    continue;
+                }
+                b->num_workers = 0;
+                if (b->percentage_houses_covered > 0) {
+                    if (percentage_not_filled > 0) {
+                        if (buildings_to_skip) {
+                            --buildings_to_skip;
+                        } else if (start_building_id) {
+                            b->num_workers = workers_per_building;
+                        } else {
+                            start_building_id = b->id;
+                            b->num_workers = workers_per_building;
+                        }
+                    } else {
+                        b->num_workers = building_get_laborers(b->type);
+                    }
                 }
-            } else {
-                b->num_workers = building_get_laborers(b->type);
             }
         }
     }
@@ -547,6 +583,7 @@ static void allocate_workers_to_non_water_buildings(void)
 
 static void allocate_workers_to_buildings(void)
 {
+    init_category_types();
     set_building_worker_weight();
     allocate_workers_to_water();
     allocate_workers_to_non_water_buildings();
@@ -567,6 +604,7 @@ void city_labor_update(void)
 
 void city_labor_set_priority(int category, int new_priority)
 {
+    game_replay_record_command(REPLAY_COMMAND_LABOR_SET_PRIORITY, category, new_priority, 0);
     int old_priority = city_data.labor.categories[category].priority;
     if (old_priority == new_priority) {
         return;
@@ -1,6 +1,8 @@
 #ifndef CITY_LABOR_H
 #define CITY_LABOR_H
 
+#include "building/type.h"
+
 typedef struct {
     int workers_needed;
     int workers_allocated;
@@ -25,6 +27,13 @@ int city_labor_lower_wages_rome(void);
 
 const labor_category_data *city_labor_category(int category);
 
+/**
+ * Gets the labor category a building type belongs to, as stored in building->labor_category
+ * @param type The building type
+ * @return The index of the category for city_labor_category(), or 255 if the type employs no workers
+ */
+unsigned char city_labor_category_for_building_type(building_type type);
+
 void city_labor_calculate_workers(int num_plebs, int num_patricians);
 
 void city_labor_allocate_workers(void);
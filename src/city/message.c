@@ -10,6 +10,7 @@
 #include "figure/formation.h"
 #include "game/resource.h"
 #include "game/settings.h"
+#include "game/speed.h"
 #include "game/time.h"
 #include "graphics/window.h"
 #include "sound/effect.h"
@@ -152,6 +153,19 @@ static int is_invasion_message(int message_type)
     }
 }
 
+static int is_request_message(int message_type)
+{
+    switch (message_type) {
+        case MESSAGE_CAESAR_REQUESTS_GOODS:
+        case MESSAGE_CAESAR_REQUESTS_MONEY:
+        case MESSAGE_CAESAR_REQUESTS_ARMY:
+        case MESSAGE_REQUEST_REMINDER:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
 static void show_message_popup(int message_id)
 {
     city_message *msg = &data.messages[message_id];
@@ -219,6 +233,11 @@ void city_message_post(int use_popup, int message_type, int param1, int param2)
     if (is_invasion_message(msg->message_type) && setting_game_speed() > 70) {
         setting_set_default_game_speed();
     }
+    if (is_invasion_message(msg->message_type)) {
+        game_speed_fast_forward_notify(FAST_FORWARD_STOP_ON_INVASION);
+    } else if (is_request_message(msg->message_type)) {
+        game_speed_fast_forward_notify(FAST_FORWARD_STOP_ON_REQUEST);
+    }
     if (use_popup && window_is(WINDOW_CITY)) {
         show_message_popup(id);
     } else if (use_popup) {
@@ -6,6 +6,8 @@
 #include "city/finance.h"
 #include "city/message.h"
 #include "core/config.h"
+#include "game/replay.h"
+#include "game/speed.h"
 #include "game/time.h"
 #include "scenario/criteria.h"
 #include "scenario/property.h"
@@ -127,6 +129,7 @@ void city_victory_check(void)
         data.state = VICTORY_STATE_WON;
     }
     if (data.state != VICTORY_STATE_NONE) {
+        game_speed_fast_forward_notify(FAST_FORWARD_STOP_ON_VICTORY);
         building_construction_clear_type();
         if (data.state == VICTORY_STATE_LOST) {
             if (city_data.mission.fired_message_shown) {
@@ -159,6 +162,7 @@ void city_victory_update_months_to_govern(void)
 
 void city_victory_continue_governing(int months)
 {
+    game_replay_record_command(REPLAY_COMMAND_VICTORY_CONTINUE_GOVERNING, months, 0, 0);
     city_data.mission.victory_message_shown = 0;
     city_data.mission.has_won = 1;
     city_data.mission.continue_months_left += months;
@@ -170,6 +174,7 @@ void city_victory_continue_governing(int months)
 
 void city_victory_stop_governing(void)
 {
+    game_replay_record_command(REPLAY_COMMAND_VICTORY_STOP_GOVERNING, 0, 0, 0);
     city_data.mission.has_won = 0;
     city_data.mission.continue_months_left = 0;
     city_data.mission.continue_months_chosen = 0;
@@ -1,17 +1,19 @@
 #include "array.h"
 
+#include "core/memory.h"
+
 int array_add_blocks(void ***data, unsigned int *blocks, unsigned int items_per_block, unsigned int item_size, unsigned int num_blocks)
 {
     if (num_blocks == 0) {
         return 1;
     }
-    void **new_block_pointer = realloc(*data, sizeof(void *) * (*blocks + num_blocks));
+    void **new_block_pointer = core_memory_realloc(MEMORY_TAG_ARRAY, *data, sizeof(void *) * (*blocks + num_blocks));
     if (!new_block_pointer) {
         return 0;
     }
     *data = new_block_pointer;
     for (unsigned int i = 0; i < num_blocks; i++) {
-        void *new_block = malloc((size_t) item_size * items_per_block);
+        void *new_block = core_memory_alloc(MEMORY_TAG_ARRAY, (size_t) item_size * items_per_block);
         if (!new_block) {
             return 0;
         }
@@ -24,7 +26,7 @@ int array_add_blocks(void ***data, unsigned int *blocks, unsigned int items_per_
 void array_free(void **data, unsigned int blocks)
 {
     for (unsigned int i = 0; i < blocks; i++) {
-        free(data[i]);
+        core_memory_free(MEMORY_TAG_ARRAY, data[i]);
     }
-    free(data);
+    core_memory_free(MEMORY_TAG_ARRAY, data);
 }
@@ -3,6 +3,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Saved data is little endian, so arrays can be copied as they are on little endian hosts
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+#define HOST_IS_LITTLE_ENDIAN
+#endif
+
 void buffer_init(buffer *buf, void *data, int size)
 {
     buf->data = data;
@@ -89,6 +94,40 @@ void buffer_write_raw(buffer *buf, const void *value, size_t size)
     }
 }
 
+void buffer_write_u16_array(buffer *buf, const uint16_t *values, size_t count)
+{
+    if (!check_size(buf, count * 2)) {
+        return;
+    }
+#ifdef HOST_IS_LITTLE_ENDIAN
+    memcpy(&buf->data[buf->index], values, count * 2);
+    buf->index += count * 2;
+#else
+    for (size_t i = 0; i < count; i++) {
+        buf->data[buf->index++] = values[i] & 0xff;
+        buf->data[buf->index++] = (values[i] >> 8) & 0xff;
+    }
+#endif
+}
+
+void buffer_write_u32_array(buffer *buf, const uint32_t *values, size_t count)
+{
+    if (!check_size(buf, count * 4)) {
+        return;
+    }
+#ifdef HOST_IS_LITTLE_ENDIAN
+    memcpy(&buf->data[buf->index], values, count * 4);
+    buf->index += count * 4;
+#else
+    for (size_t i = 0; i < count; i++) {
+        buf->data[buf->index++] = values[i] & 0xff;
+        buf->data[buf->index++] = (values[i] >> 8) & 0xff;
+        buf->data[buf->index++] = (values[i] >> 16) & 0xff;
+        buf->data[buf->index++] = (values[i] >> 24) & 0xff;
+    }
+#endif
+}
+
 uint8_t buffer_read_u8(buffer *buf)
 {
     if (check_size(buf, 1)) {
@@ -166,6 +205,46 @@ size_t buffer_read_raw(buffer *buf, void *value, size_t max_size)
     return size;
 }
 
+void buffer_read_u16_array(buffer *buf, uint16_t *values, size_t count)
+{
+    if (!check_size(buf, count * 2)) {
+        // Read what's there one by one, so the missing values are zero like with buffer_read_u16()
+        for (size_t i = 0; i < count; i++) {
+            values[i] = buffer_read_u16(buf);
+        }
+        return;
+    }
+#ifdef HOST_IS_LITTLE_ENDIAN
+    memcpy(values, &buf->data[buf->index], count * 2);
+    buf->index += count * 2;
+#else
+    for (size_t i = 0; i < count; i++) {
+        values[i] = (uint16_t) (buf->data[buf->index] | (buf->data[buf->index + 1] << 8));
+        buf->index += 2;
+    }
+#endif
+}
+
+void buffer_read_u32_array(buffer *buf, uint32_t *values, size_t count)
+{
+    if (!check_size(buf, count * 4)) {
+        for (size_t i = 0; i < count; i++) {
+            values[i] = buffer_read_u32(buf);
+        }
+        return;
+    }
+#ifdef HOST_IS_LITTLE_ENDIAN
+    memcpy(values, &buf->data[buf->index], count * 4);
+    buf->index += count * 4;
+#else
+    for (size_t i = 0; i < count; i++) {
+        values[i] = (uint32_t) buf->data[buf->index] | ((uint32_t) buf->data[buf->index + 1] << 8) |
+            ((uint32_t) buf->data[buf->index + 2] << 16) | ((uint32_t) buf->data[buf->index + 3] << 24);
+        buf->index += 4;
+    }
+#endif
+}
+
 void buffer_skip(buffer *buf, size_t size)
 {
     buf->index += size;
@@ -90,6 +90,22 @@ void buffer_write_i32(buffer *buffer, int32_t value);
  */
 void buffer_write_raw(buffer *buffer, const void *value, size_t size);
 
+/**
+ * Writes an array of unsigned 16-bit integers, checking the buffer size only once
+ * @param buffer Buffer
+ * @param values Values to write
+ * @param count Number of values
+ */
+void buffer_write_u16_array(buffer *buffer, const uint16_t *values, size_t count);
+
+/**
+ * Writes an array of unsigned 32-bit integers, checking the buffer size only once
+ * @param buffer Buffer
+ * @param values Values to write
+ * @param count Number of values
+ */
+void buffer_write_u32_array(buffer *buffer, const uint32_t *values, size_t count);
+
 /**
  * Reads an unsigned 8-bit integer
  * @param buffer Buffer
@@ -141,6 +157,22 @@ int32_t buffer_read_i32(buffer *buffer);
  */
 size_t buffer_read_raw(buffer *buffer, void *value, size_t max_size);
 
+/**
+ * Reads an array of unsigned 16-bit integers, checking the buffer size only once
+ * @param buffer Buffer
+ * @param values Values to read into
+ * @param count Number of values
+ */
+void buffer_read_u16_array(buffer *buffer, uint16_t *values, size_t count);
+
+/**
+ * Reads an array of unsigned 32-bit integers, checking the buffer size only once
+ * @param buffer Buffer
+ * @param values Values to read into
+ * @param count Number of values
+ */
+void buffer_read_u32_array(buffer *buffer, uint32_t *values, size_t count);
+
 /**
  * Skip data in the buffer
  * @param buffer Buffer
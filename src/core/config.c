@@ -95,6 +95,10 @@ static const char *ini_keys[] = {
     [CONFIG_WT_SNOW_SPEED] = "weather_snow_speed",
     [CONFIG_WT_SANDSTORM_SPEED] = "weather_sandstorm_speed",
     [CONFIG_UI_EMPIRE_SIDEBAR_WIDTH] = "ui_empire_sidebar_width",
+    [CONFIG_GP_BATCH_ROUTING] = "gameplay_batch_routing",
+    [CONFIG_GP_PARALLEL_HOUSE_EVOLUTION] = "gameplay_parallel_house_evolution",
+    [CONFIG_GENERAL_LAZY_ASSET_LOADING] = "lazy_asset_loading",
+    [CONFIG_GENERAL_SKYLINE_ATLAS_PACKER] = "skyline_atlas_packer",
 };
 
 static const char *ini_string_keys[] = {
@@ -137,7 +141,11 @@ static int default_values[CONFIG_MAX_ENTRIES] = {
     [CONFIG_WT_RAIN_LENGTH] = 10,
     [CONFIG_WT_SNOW_SPEED] = 1,
     [CONFIG_WT_SANDSTORM_SPEED] = 2,
-    [CONFIG_UI_EMPIRE_SIDEBAR_WIDTH] = 25
+    [CONFIG_UI_EMPIRE_SIDEBAR_WIDTH] = 25,
+    [CONFIG_GP_BATCH_ROUTING] = 0,
+    [CONFIG_GP_PARALLEL_HOUSE_EVOLUTION] = 0,
+    [CONFIG_GENERAL_LAZY_ASSET_LOADING] = 0,
+    [CONFIG_GENERAL_SKYLINE_ATLAS_PACKER] = 0
 };
 
 static const char default_string_values[CONFIG_STRING_MAX_ENTRIES][CONFIG_STRING_VALUE_MAX] = { 0 };
@@ -85,6 +85,10 @@ typedef enum {
     CONFIG_WT_SNOW_SPEED,
     CONFIG_WT_SANDSTORM_SPEED,
     CONFIG_UI_EMPIRE_SIDEBAR_WIDTH,
+    CONFIG_GP_BATCH_ROUTING,
+    CONFIG_GP_PARALLEL_HOUSE_EVOLUTION,
+    CONFIG_GENERAL_LAZY_ASSET_LOADING,
+    CONFIG_GENERAL_SKYLINE_ATLAS_PACKER,
     CONFIG_MAX_ENTRIES
 } config_key;
 
@@ -4,17 +4,21 @@
 #include "building/building.h"
 #include "building/image.h"
 #include "core/buffer.h"
+#include "core/config.h"
 #include "core/file.h"
 #include "core/image_packer.h"
 #include "core/io.h"
 #include "core/log.h"
 #include "graphics/font.h"
 #include "graphics/renderer.h"
+#include "graphics/rich_text.h"
+#include "graphics/text.h"
 #include "map/building_tiles.h"
 #include "map/image.h"
 #include "map/terrain.h"
 #include "scenario/property.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -348,6 +352,7 @@ static int crop_and_pack_images(buffer *buf, image *images, image_draw_data *dra
     data.packer.options.fail_policy = IMAGE_PACKER_NEW_IMAGE;
     data.packer.options.reduce_image_size = 1;
     data.packer.options.sort_by = IMAGE_PACKER_SORT_BY_AREA;
+    data.packer.options.algorithm = image_atlas_packer_algorithm();
 
     int offset = 4;
     for (int i = 1, rect = 1; i < num_images; i++, rect++) {
@@ -406,6 +411,7 @@ static int crop_and_pack_images(buffer *buf, image *images, image_draw_data *dra
     }
 
     image_packer_pack(&data.packer);
+    image_log_atlas_packing(type == ATLAS_MAIN ? "main" : type == ATLAS_ENEMY ? "enemy" : "font", &data.packer);
 
     for (int i = 0, rect = 0; i < num_images; i++, rect++) {
         image *img = &images[i];
@@ -1021,6 +1027,7 @@ static int load_multibyte_font(multibyte_font_type type)
     data.packer.options.fail_policy = IMAGE_PACKER_NEW_IMAGE;
     data.packer.options.reduce_image_size = 1;
     data.packer.options.sort_by = IMAGE_PACKER_SORT_BY_AREA;
+    data.packer.options.algorithm = image_atlas_packer_algorithm();
 
     multibyte_font_sizes *font_sizes;
     int (*parse_multibyte_font)(buffer * input, color_t * pixels, multibyte_font_sizes * font_size,
@@ -1103,6 +1110,10 @@ int image_load_fonts(encoding_type encoding)
 {
     graphics_renderer()->get_max_image_size(&data.max_image_width, &data.max_image_height);
 
+    // Letter widths may change, so any text laid out with the old fonts is no longer valid
+    text_layout_cache_clear();
+    rich_text_clear_layout_cache();
+
     if (encoding == ENCODING_CYRILLIC) {
         return load_external_fonts(CYRILLIC_FONT_BASE_OFFSET);
     } else if (encoding == ENCODING_GREEK) {
@@ -1365,6 +1376,20 @@ void image_crop(image *img, const color_t *pixels)
     img->height = y_last_opaque - y_first_opaque + 1;
 }
 
+image_packer_algorithm image_atlas_packer_algorithm(void)
+{
+    return config_get(CONFIG_GENERAL_SKYLINE_ATLAS_PACKER) ?
+        IMAGE_PACKER_ALGORITHM_SKYLINE : IMAGE_PACKER_ALGORITHM_EMPTY_AREAS;
+}
+
+void image_log_atlas_packing(const char *atlas_name, const image_packer *packer)
+{
+    char details[100];
+    snprintf(details, sizeof(details), "%s - %u pages, %u%% occupied, packed in %u ms", atlas_name,
+        packer->result.images_needed, packer->result.occupancy_percentage, packer->result.pack_time_ms);
+    log_info("Packed image atlas", details, 0);
+}
+
 int image_group(int group)
 {
     return data.group_image_ids[group];
@@ -3,6 +3,7 @@
 
 #include "core/encoding.h"
 #include "core/image_group.h"
+#include "core/image_packer.h"
 #include "graphics/color.h"
 
 #define IMAGE_MAIN_ENTRIES 10000
@@ -147,6 +148,19 @@ int image_get_external_dimensions(const image *img, int *width, int *height);
  */
 void image_crop(image *img, const color_t *pixels);
 
+/**
+ * Gets the algorithm to pack the image atlases with, as set in the config
+ * @return The image packer algorithm
+ */
+image_packer_algorithm image_atlas_packer_algorithm(void);
+
+/**
+ * Logs the number of pages, occupancy and packing time of a packed image atlas
+ * @param atlas_name The name of the atlas
+ * @param packer The packer that packed the atlas
+ */
+void image_log_atlas_packing(const char *atlas_name, const image_packer *packer);
+
 /**
  * Gets the image id of the first image in the group
  * @param group Image group
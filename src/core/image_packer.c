@@ -1,8 +1,10 @@
 #include "image_packer.h"
 
+#include <limits.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 typedef struct empty_area {
     unsigned int x, y;
@@ -11,11 +13,24 @@ typedef struct empty_area {
     struct empty_area *prev, *next;
 } empty_area;
 
+typedef struct {
+    unsigned int x, y;
+    unsigned int width;
+} skyline_segment;
+
 typedef struct {
     image_packer_rect **sorted_rects;
     unsigned int num_rects;
     unsigned int image_width;
     unsigned int image_height;
+    image_packer_algorithm algorithm;
+    struct {
+        skyline_segment *segments;
+        unsigned int count;
+        unsigned int size;
+        unsigned int width;
+        unsigned int height;
+    } skyline;
     struct {
         struct empty_area *first;
         struct empty_area *last;
@@ -315,6 +330,148 @@ static int pack_rect(internal_data *data, image_packer_rect *rect, int allow_rot
     return 0;
 }
 
+static void reset_skyline(internal_data *data, unsigned int width, unsigned int height)
+{
+    data->skyline.width = width;
+    data->skyline.height = height;
+    // The skyline starts as a single segment at the top of the image spanning its whole width
+    data->skyline.segments[0].x = 0;
+    data->skyline.segments[0].y = 0;
+    data->skyline.segments[0].width = width;
+    data->skyline.count = 1;
+}
+
+static int skyline_fits(const internal_data *data, unsigned int index, unsigned int width, unsigned int height,
+    unsigned int *y)
+{
+    const skyline_segment *segment = &data->skyline.segments[index];
+    if (segment->x + width > data->skyline.width) {
+        return 0;
+    }
+    unsigned int top = 0;
+    int width_left = width;
+    while (width_left > 0 && index < data->skyline.count) {
+        segment = &data->skyline.segments[index++];
+        if (segment->y > top) {
+            top = segment->y;
+        }
+        if (top + height > data->skyline.height) {
+            return 0;
+        }
+        width_left -= segment->width;
+    }
+    *y = top;
+    return width_left <= 0;
+}
+
+static void skyline_add_segment(internal_data *data, unsigned int index, unsigned int x, unsigned int y,
+    unsigned int width)
+{
+    skyline_segment *segments = data->skyline.segments;
+    memmove(&segments[index + 1], &segments[index], (data->skyline.count - index) * sizeof(skyline_segment));
+    segments[index].x = x;
+    segments[index].y = y;
+    segments[index].width = width;
+    data->skyline.count++;
+
+    // Shrink or remove the segments now covered by the new one
+    unsigned int end = x + width;
+    unsigned int next = index + 1;
+    while (next < data->skyline.count && segments[next].x < end) {
+        unsigned int covered = end - segments[next].x;
+        if (covered < segments[next].width) {
+            segments[next].x += covered;
+            segments[next].width -= covered;
+            break;
+        }
+        data->skyline.count--;
+        memmove(&segments[next], &segments[next + 1], (data->skyline.count - next) * sizeof(skyline_segment));
+    }
+
+    // Merge neighbouring segments of the same height
+    for (unsigned int i = 0; i + 1 < data->skyline.count;) {
+        if (segments[i].y == segments[i + 1].y) {
+            segments[i].width += segments[i + 1].width;
+            data->skyline.count--;
+            memmove(&segments[i + 1], &segments[i + 2], (data->skyline.count - i - 1) * sizeof(skyline_segment));
+        } else {
+            i++;
+        }
+    }
+}
+
+static int pack_rect_skyline(internal_data *data, image_packer_rect *rect, int allow_rotation)
+{
+    if (!rect->input.width || !rect->input.height) {
+        return 1;
+    }
+    unsigned int best_index = 0;
+    unsigned int best_x = 0;
+    unsigned int best_y = 0;
+    unsigned int best_top = UINT_MAX;
+    unsigned int best_segment_width = UINT_MAX;
+    int best_rotated = 0;
+    int found = 0;
+
+    for (int rotated = 0; rotated <= allow_rotation; rotated++) {
+        unsigned int width = rotated ? rect->input.height : rect->input.width;
+        unsigned int height = rotated ? rect->input.width : rect->input.height;
+        for (unsigned int i = 0; i < data->skyline.count; i++) {
+            unsigned int y;
+            if (!skyline_fits(data, i, width, height, &y)) {
+                continue;
+            }
+            const skyline_segment *segment = &data->skyline.segments[i];
+            if (y + height < best_top || (y + height == best_top && segment->width < best_segment_width)) {
+                best_index = i;
+                best_x = segment->x;
+                best_y = y;
+                best_top = y + height;
+                best_segment_width = segment->width;
+                best_rotated = rotated;
+                found = 1;
+            }
+        }
+    }
+    if (!found) {
+        rect->output.rotated = 0;
+        return 0;
+    }
+    rect->output.x = best_x;
+    rect->output.y = best_y;
+    rect->output.rotated = best_rotated;
+    rect->output.packed = 1;
+    skyline_add_segment(data, best_index, best_x, best_top,
+        best_rotated ? rect->input.height : rect->input.width);
+    return 1;
+}
+
+static void reset_image(internal_data *data, unsigned int width, unsigned int height)
+{
+    if (data->algorithm == IMAGE_PACKER_ALGORITHM_SKYLINE) {
+        reset_skyline(data, width, height);
+    } else {
+        reset_empty_areas(data, width, height);
+    }
+}
+
+static int pack_rect_in_image(internal_data *data, image_packer_rect *rect, int allow_rotation)
+{
+    if (data->algorithm == IMAGE_PACKER_ALGORITHM_SKYLINE) {
+        return pack_rect_skyline(data, rect, allow_rotation);
+    }
+    return pack_rect(data, rect, allow_rotation);
+}
+
+static int image_is_empty(const internal_data *data)
+{
+    if (data->algorithm == IMAGE_PACKER_ALGORITHM_SKYLINE) {
+        return data->skyline.count == 1 && data->skyline.segments[0].y == 0;
+    }
+    return data->empty_areas.first && data->empty_areas.first->width == data->image_width &&
+        data->empty_areas.first->height == data->image_height;
+}
+
 static int create_last_image(image_packer *packer, unsigned int remaining_area)
 {
     internal_data *data = packer->internal_data;
@@ -344,7 +501,7 @@ static int create_last_image(image_packer *packer, unsigned int remaining_area)
         int images_packed_in_loop = 0;
         int area_packed_in_loop = 0;
 
-        reset_empty_areas(data, packer->result.last_image_width, packer->result.last_image_height);
+        reset_image(data, packer->result.last_image_width, packer->result.last_image_height);
 
         int failed = 0;
 
@@ -354,7 +511,7 @@ static int create_last_image(image_packer *packer, unsigned int remaining_area)
             if (rect->output.packed && rect->output.image_index != packer->result.images_needed) {
                 continue;
             }
-            if (!pack_rect(data, rect, packer->options.allow_rotation)) {
+            if (!pack_rect_in_image(data, rect, packer->options.allow_rotation)) {
                 failed = 1;
                 if (packer->result.last_image_width < data->image_width ||
                     packer->result.last_image_height < data->image_height) {
@@ -417,6 +574,12 @@ int image_packer_init(image_packer *packer, unsigned int num_rectangles, unsigne
     }
     data->empty_areas.size = size;
 
+    data->skyline.segments = (skyline_segment *) malloc(size * sizeof(skyline_segment));
+    if (!data->skyline.segments) {
+        return IMAGE_PACKER_ERROR_NO_MEMORY;
+    }
+    data->skyline.size = size;
+
     return IMAGE_PACKER_OK;
 }
 
@@ -427,14 +590,15 @@ void image_packer_resize_image(image_packer *packer, unsigned int image_width, u
     data->image_height = image_height;
 }
 
-int image_packer_pack(image_packer *packer)
+static int pack_rects(image_packer *packer)
 {
     internal_data *data = packer->internal_data;
 
-    if (!data->num_rects || !data->image_width || !data->image_height ||
-        !packer->rects || data->empty_areas.size != data->num_rects + 1) {
+    if (!data->num_rects || !data->image_width || !data->image_height || !packer->rects ||
+        data->empty_areas.size != data->num_rects + 1 || data->skyline.size != data->num_rects + 1) {
         return IMAGE_PACKER_ERROR_WRONG_PARAMETERS;
     }
+    data->algorithm = packer->options.algorithm;
     if (packer->options.rects_are_sorted != 1 || !data->sorted_rects) {
         if (!sort_rects(packer)) {
             return IMAGE_PACKER_ERROR_NO_MEMORY;
@@ -451,7 +615,7 @@ int image_packer_pack(image_packer *packer)
     unsigned int available_area = packer->options.reduce_image_size == 1 ? data->image_width * data->image_height : 0;
 
     while (remaining_area > available_area) {
-        reset_empty_areas(data, data->image_width, data->image_height);
+        reset_image(data, data->image_width, data->image_height);
 
         area_used_in_last_image = 0;
 
@@ -462,7 +626,7 @@ int image_packer_pack(image_packer *packer)
                 continue;
             }
             rect->output.packed = 0;
-            if (!pack_rect(data, rect, packer->options.allow_rotation)) {
+            if (!pack_rect_in_image(data, rect, packer->options.allow_rotation)) {
                 if (packer->options.fail_policy == IMAGE_PACKER_CONTINUE) {
                     remaining_area -= rect->input.width * rect->input.height;
                     continue;
@@ -471,8 +635,7 @@ int image_packer_pack(image_packer *packer)
                     packer->result.last_image_height = data->image_height;
                     return i;
                 }
-                if (data->empty_areas.first->width == data->image_width &&
-                    data->empty_areas.first->height == data->image_height) {
+                if (image_is_empty(data)) {
                     packer->result.images_needed--;
                     packer->result.last_image_width = data->image_width;
                     packer->result.last_image_height = data->image_height;
@@ -499,10 +662,37 @@ int image_packer_pack(image_packer *packer)
     return packed_rects;
 }
 
+static unsigned int calculate_occupancy_percentage(const image_packer *packer)
+{
+    if (!packer->result.images_needed) {
+        return 0;
+    }
+    const internal_data *data = packer->internal_data;
+    double packed_area = 0;
+    for (unsigned int i = 0; i < data->num_rects; i++) {
+        if (packer->rects[i].output.packed) {
+            packed_area += (double) packer->rects[i].input.width * packer->rects[i].input.height;
+        }
+    }
+    double total_area = (double) (packer->result.images_needed - 1) * data->image_width * data->image_height +
+        (double) packer->result.last_image_width * packer->result.last_image_height;
+    return total_area > 0 ? (unsigned int) (packed_area * 100 / total_area) : 0;
+}
+
+int image_packer_pack(image_packer *packer)
+{
+    clock_t start = clock();
+    int result = pack_rects(packer);
+    packer->result.pack_time_ms = (unsigned int) ((clock() - start) * 1000 / CLOCKS_PER_SEC);
+    packer->result.occupancy_percentage = result < 0 ? 0 : calculate_occupancy_percentage(packer);
+    return result;
+}
+
 void image_packer_free(image_packer *packer)
 {
     internal_data *data = packer->internal_data;
     if (data) {
+        free(data->skyline.segments);
         free(data->empty_areas.list);
         free(data->sorted_rects);
         free(data);
@@ -21,6 +21,11 @@ typedef enum {
     IMAGE_PACKER_SORT_BY_WIDTH = 3
 } image_packer_sort_type;
 
+typedef enum {
+    IMAGE_PACKER_ALGORITHM_EMPTY_AREAS = 0, /**< Sorted list of empty areas that are split and merged */
+    IMAGE_PACKER_ALGORITHM_SKYLINE = 1 /**< Skyline bottom-left, with the best fitting segment on ties */
+} image_packer_algorithm;
+
 typedef enum {
     IMAGE_PACKER_OK = 0,
     IMAGE_PACKER_ERROR_WRONG_PARAMETERS = -1,
@@ -49,11 +54,14 @@ typedef struct {
         int reduce_image_size;
         image_packer_sort_type sort_by;
         image_packer_fail_policy fail_policy;
+        image_packer_algorithm algorithm;
     } options;
     struct {
         unsigned int images_needed;
         unsigned int last_image_width;
         unsigned int last_image_height;
+        unsigned int pack_time_ms; /**< Time spent in the last call to image_packer_pack() */
+        unsigned int occupancy_percentage; /**< Area of the packed rects relative to the area of all images */
     } result;
     void *internal_data;
 } image_packer;
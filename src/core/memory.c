@@ -0,0 +1,208 @@
+#include "memory.h"
+
+#include "core/file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Sound is mixed on its own thread, so the counters are updated atomically where the compiler allows it
+#if defined(__GNUC__) || defined(__clang__)
+#define counter_add(c, v) __atomic_add_fetch(&(c), (v), __ATOMIC_RELAXED)
+#define counter_sub(c, v) __atomic_sub_fetch(&(c), (v), __ATOMIC_RELAXED)
+#define counter_get(c) __atomic_load_n(&(c), __ATOMIC_RELAXED)
+#define counter_set(c, v) __atomic_store_n(&(c), (v), __ATOMIC_RELAXED)
+#define counter_raise(c, v) \
+{ \
+    size_t counter_old = __atomic_load_n(&(c), __ATOMIC_RELAXED); \
+    while ((v) > counter_old && \
+        !__atomic_compare_exchange_n(&(c), &counter_old, (v), 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) { \
+    } \
+}
+#else
+#define counter_add(c, v) ((c) += (v))
+#define counter_sub(c, v) ((c) -= (v))
+#define counter_get(c) (c)
+#define counter_set(c, v) ((c) = (v))
+#define counter_raise(c, v) \
+{ \
+    if ((v) > (c)) { \
+        (c) = (v); \
+    } \
+}
+#endif
+
+// Stores the size in front of every allocation, keeping the returned memory suitably aligned
+typedef union {
+    size_t size;
+    long double alignment_long_double;
+    long long alignment_long_long;
+    void *alignment_pointer;
+} allocation_header;
+
+typedef struct {
+    size_t current_bytes;
+    size_t peak_bytes;
+    size_t total_allocations;
+    size_t live_allocations;
+    size_t allocations_this_frame;
+    size_t allocations_last_frame;
+    size_t max_allocations_per_frame;
+    size_t allocations_this_tick;
+    size_t allocations_last_tick;
+    size_t max_allocations_per_tick;
+} tag_counters;
+
+static const char *TAG_NAMES[MEMORY_TAG_MAX] = {
+    "Arrays",
+    "Memory blocks",
+    "Textures",
+    "Assets",
+    "Video",
+    "Sound"
+};
+
+static struct {
+    tag_counters tags[MEMORY_TAG_MAX];
+    size_t total_bytes;
+    size_t peak_total_bytes;
+} data;
+
+static void count_allocation(memory_tag tag, size_t size)
+{
+    tag_counters *counters = &data.tags[tag];
+    size_t current = counter_add(counters->current_bytes, size);
+    counter_raise(counters->peak_bytes, current);
+    size_t total = counter_add(data.total_bytes, size);
+    counter_raise(data.peak_total_bytes, total);
+    counter_add(counters->total_allocations, 1);
+    counter_add(counters->live_allocations, 1);
+    counter_add(counters->allocations_this_frame, 1);
+    counter_add(counters->allocations_this_tick, 1);
+}
+
+static void count_free(memory_tag tag, size_t size)
+{
+    tag_counters *counters = &data.tags[tag];
+    counter_sub(counters->current_bytes, size);
+    counter_sub(data.total_bytes, size);
+    counter_sub(counters->live_allocations, 1);
+}
+
+void *core_memory_alloc(memory_tag tag, size_t size)
+{
+    allocation_header *header = malloc(sizeof(allocation_header) + size);
+    if (!header) {
+        return 0;
+    }
+    header->size = size;
+    count_allocation(tag, size);
+    return header + 1;
+}
+
+void *core_memory_calloc(memory_tag tag, size_t count, size_t size)
+{
+    if (size && count > ((size_t) -1 - sizeof(allocation_header)) / size) {
+        return 0;
+    }
+    void *ptr = core_memory_alloc(tag, count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void *core_memory_realloc(memory_tag tag, void *ptr, size_t size)
+{
+    if (!ptr) {
+        return core_memory_alloc(tag, size);
+    }
+    allocation_header *header = (allocation_header *) ptr - 1;
+    size_t old_size = header->size;
+    allocation_header *new_header = realloc(header, sizeof(allocation_header) + size);
+    if (!new_header) {
+        return 0;
+    }
+    new_header->size = size;
+    count_free(tag, old_size);
+    count_allocation(tag, size);
+    return new_header + 1;
+}
+
+void core_memory_free(memory_tag tag, void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    allocation_header *header = (allocation_header *) ptr - 1;
+    count_free(tag, header->size);
+    free(header);
+}
+
+void core_memory_get_stats(memory_tag tag, memory_stats *stats)
+{
+    tag_counters *counters = &data.tags[tag];
+    stats->current_bytes = counter_get(counters->current_bytes);
+    stats->peak_bytes = counter_get(counters->peak_bytes);
+    stats->total_allocations = counter_get(counters->total_allocations);
+    stats->live_allocations = counter_get(counters->live_allocations);
+    stats->allocations_last_frame = counter_get(counters->allocations_last_frame);
+    stats->max_allocations_per_frame = counter_get(counters->max_allocations_per_frame);
+    stats->allocations_last_tick = counter_get(counters->allocations_last_tick);
+    stats->max_allocations_per_tick = counter_get(counters->max_allocations_per_tick);
+}
+
+size_t core_memory_total_bytes(size_t *peak_bytes)
+{
+    if (peak_bytes) {
+        *peak_bytes = counter_get(data.peak_total_bytes);
+    }
+    return counter_get(data.total_bytes);
+}
+
+void core_memory_start_frame(void)
+{
+    for (int i = 0; i < MEMORY_TAG_MAX; i++) {
+        tag_counters *counters = &data.tags[i];
+        size_t allocations = counter_get(counters->allocations_this_frame);
+        counter_sub(counters->allocations_this_frame, allocations);
+        counter_set(counters->allocations_last_frame, allocations);
+        counter_raise(counters->max_allocations_per_frame, allocations);
+    }
+}
+
+void core_memory_start_tick(void)
+{
+    for (int i = 0; i < MEMORY_TAG_MAX; i++) {
+        tag_counters *counters = &data.tags[i];
+        size_t allocations = counter_get(counters->allocations_this_tick);
+        counter_sub(counters->allocations_this_tick, allocations);
+        counter_set(counters->allocations_last_tick, allocations);
+        counter_raise(counters->max_allocations_per_tick, allocations);
+    }
+}
+
+int core_memory_write_report(const char *filename)
+{
+    FILE *fp = file_open(filename, "w");
+    if (!fp) {
+        return 0;
+    }
+    size_t peak_total;
+    size_t total = core_memory_total_bytes(&peak_total);
+    fprintf(fp, "Tracked memory: %llu bytes, peak %llu bytes\n\n",
+        (unsigned long long) total, (unsigned long long) peak_total);
+    fprintf(fp, "%-14s %14s %14s %12s %12s %12s %12s %12s %12s\n", "Subsystem", "Bytes", "Peak bytes",
+        "Allocations", "Live", "Last frame", "Max/frame", "Last tick", "Max/tick");
+    for (int i = 0; i < MEMORY_TAG_MAX; i++) {
+        memory_stats stats;
+        core_memory_get_stats(i, &stats);
+        fprintf(fp, "%-14s %14llu %14llu %12llu %12llu %12llu %12llu %12llu %12llu\n", TAG_NAMES[i],
+            (unsigned long long) stats.current_bytes, (unsigned long long) stats.peak_bytes,
+            (unsigned long long) stats.total_allocations, (unsigned long long) stats.live_allocations,
+            (unsigned long long) stats.allocations_last_frame, (unsigned long long) stats.max_allocations_per_frame,
+            (unsigned long long) stats.allocations_last_tick, (unsigned long long) stats.max_allocations_per_tick);
+    }
+    file_close(fp);
+    return 1;
+}
@@ -0,0 +1,75 @@
+#ifndef CORE_MEMORY_H
+#define CORE_MEMORY_H
+
+#include <stddef.h>
+
+/**
+ * @file
+ * Tracked memory allocation.
+ *
+ * Memory allocated through these functions is counted per subsystem, so the current and peak usage
+ * of every subsystem and the number of allocations per frame and per game tick can be reported.
+ * Memory allocated here must be reallocated and freed here as well, with the same tag.
+ */
+
+typedef enum {
+    MEMORY_TAG_ARRAY,
+    MEMORY_TAG_MEMORY_BLOCK,
+    MEMORY_TAG_TEXTURE,
+    MEMORY_TAG_ASSET,
+    MEMORY_TAG_VIDEO,
+    MEMORY_TAG_SOUND,
+    MEMORY_TAG_MAX
+} memory_tag;
+
+typedef struct {
+    size_t current_bytes;
+    size_t peak_bytes;
+    size_t total_allocations;
+    size_t live_allocations;
+    size_t allocations_last_frame;
+    size_t max_allocations_per_frame;
+    size_t allocations_last_tick;
+    size_t max_allocations_per_tick;
+} memory_stats;
+
+void *core_memory_alloc(memory_tag tag, size_t size);
+
+void *core_memory_calloc(memory_tag tag, size_t count, size_t size);
+
+void *core_memory_realloc(memory_tag tag, void *ptr, size_t size);
+
+void core_memory_free(memory_tag tag, void *ptr);
+
+/**
+ * Gets the statistics of a subsystem
+ * @param tag The subsystem
+ * @param stats The statistics to fill
+ */
+void core_memory_get_stats(memory_tag tag, memory_stats *stats);
+
+/**
+ * Gets the number of bytes currently allocated by all subsystems
+ * @param peak_bytes Optional, receives the highest number of bytes that was allocated at the same time
+ * @return The allocated bytes
+ */
+size_t core_memory_total_bytes(size_t *peak_bytes);
+
+/**
+ * Marks the start of a new frame, for the allocations per frame
+ */
+void core_memory_start_frame(void);
+
+/**
+ * Marks the start of a new game tick, for the allocations per tick
+ */
+void core_memory_start_tick(void);
+
+/**
+ * Writes a report of all statistics to a text file
+ * @param filename The file to write
+ * @return 1 if the report was written, 0 otherwise
+ */
+int core_memory_write_report(const char *filename);
+
+#endif // CORE_MEMORY_H
@@ -1,10 +1,10 @@
 #include "memory_block.h"
 
-#include <stdlib.h>
+#include "core/memory.h"
 
 int core_memory_block_init(memory_block *block, size_t initial_size)
 {
-    block->memory = calloc(initial_size, sizeof(char));
+    block->memory = core_memory_calloc(MEMORY_TAG_MEMORY_BLOCK, initial_size, sizeof(char));
     if (!block->memory) {
         block->size = 0;
         return 0;
@@ -18,7 +18,7 @@ int core_memory_block_ensure_size(memory_block *block, size_t size)
     if (size <= block->size) {
         return 1;
     }
-    void *new_mem = realloc(block->memory, sizeof(char) * size);
+    void *new_mem = core_memory_realloc(MEMORY_TAG_MEMORY_BLOCK, block->memory, sizeof(char) * size);
     if (!new_mem) {
         return 0;
     }
@@ -29,6 +29,7 @@ int core_memory_block_ensure_size(memory_block *block, size_t size)
 
 void core_memory_block_free(memory_block *block)
 {
-    free(block->memory);
+    core_memory_free(MEMORY_TAG_MEMORY_BLOCK, block->memory);
+    block->memory = 0;
     block->size = 0;
 }
@@ -19,6 +19,13 @@ typedef enum {
     CACHE_TYPE_MEMORY
 } cache_type;
 
+typedef struct {
+    char *path;
+    int width;
+    int height;
+    color_t *pixels;
+} decoded_file;
+
 static struct {
     spng_ctx *ctx;
     FILE *fp;
@@ -29,15 +36,41 @@ static struct {
         int width;
         int height;
         color_t *pixels;
+        int pixels_are_decoded_file;
     } cache;
+    struct {
+        decoded_file *items;
+        int size;
+        int capacity;
+    } decoded_files;
 } data;
 
+static const decoded_file *get_decoded_file(const char *path)
+{
+    for (int i = 0; i < data.decoded_files.size; i++) {
+        if (strcmp(data.decoded_files.items[i].path, path) == 0) {
+            return &data.decoded_files.items[i];
+        }
+    }
+    return 0;
+}
+
 int png_load_from_file(const char *path, int is_asset)
 {
     if (data.cache.type == CACHE_TYPE_FILE && strcmp(path, data.cache.path) == 0) {
         return 1;
     }
     png_unload();
+    const decoded_file *file = is_asset ? get_decoded_file(path) : 0;
+    if (file) {
+        data.cache.type = CACHE_TYPE_FILE;
+        snprintf(data.cache.path, FILE_NAME_MAX, "%s", path);
+        data.cache.width = file->width;
+        data.cache.height = file->height;
+        data.cache.pixels = file->pixels;
+        data.cache.pixels_are_decoded_file = 1;
+        return 1;
+    }
     data.fp = is_asset ? file_open_asset(path, "rb") : file_open(path, "rb");
     if (!data.fp) {
         log_error("Unable to open png file", path, 0);
@@ -200,6 +233,81 @@ int png_read(color_t *pixels, int src_x, int src_y, int width, int height,
 void png_unload(void)
 {
     close_png();
-    free(data.cache.pixels);
+    if (!data.cache.pixels_are_decoded_file) {
+        free(data.cache.pixels);
+    }
     memset(&data.cache, 0, sizeof(data.cache));
 }
+
+color_t *png_decode_from_buffer(const uint8_t *buffer, size_t length, int *width, int *height)
+{
+    if (!buffer) {
+        return 0;
+    }
+    spng_ctx *ctx = spng_ctx_new(0);
+    if (!ctx) {
+        return 0;
+    }
+    color_t *pixels = 0;
+    struct spng_ihdr ihdr;
+    size_t image_size;
+    if (!spng_set_png_buffer(ctx, buffer, length) && !spng_get_ihdr(ctx, &ihdr) &&
+        !spng_decoded_image_size(ctx, SPNG_FMT_RGBA8, &image_size)) {
+        pixels = malloc(image_size);
+        if (pixels && spng_decode_image(ctx, pixels, image_size, SPNG_FMT_RGBA8, SPNG_DECODE_TRNS)) {
+            free(pixels);
+            pixels = 0;
+        }
+    }
+    spng_ctx_free(ctx);
+    if (!pixels) {
+        return 0;
+    }
+    *width = (int) ihdr.width;
+    *height = (int) ihdr.height;
+    convert_image_to_argb(pixels, *width * *height);
+    return pixels;
+}
+
+int png_add_decoded_file(const char *path, color_t *pixels, int width, int height)
+{
+    if (data.decoded_files.size == data.decoded_files.capacity) {
+        int capacity = data.decoded_files.capacity ? data.decoded_files.capacity * 2 : 32;
+        decoded_file *items = realloc(data.decoded_files.items, sizeof(decoded_file) * capacity);
+        if (!items) {
+            return 0;
+        }
+        data.decoded_files.items = items;
+        data.decoded_files.capacity = capacity;
+    }
+    size_t path_length = strlen(path) + 1;
+    char *path_copy = malloc(path_length);
+    if (!path_copy) {
+        return 0;
+    }
+    memcpy(path_copy, path, path_length);
+    decoded_file *file = &data.decoded_files.items[data.decoded_files.size++];
+    file->path = path_copy;
+    file->width = width;
+    file->height = height;
+    file->pixels = pixels;
+    return 1;
+}
+
+int png_has_decoded_file(const char *path)
+{
+    return get_decoded_file(path) != 0;
+}
+
+void png_clear_decoded_files(void)
+{
+    if (data.cache.pixels_are_decoded_file) {
+        png_unload();
+    }
+    for (int i = 0; i < data.decoded_files.size; i++) {
+        free(data.decoded_files.items[i].path);
+        free(data.decoded_files.items[i].pixels);
+    }
+    free(data.decoded_files.items);
+    memset(&data.decoded_files, 0, sizeof(data.decoded_files));
+}
@@ -16,4 +16,32 @@ int png_read(color_t *pixels, int src_x, int src_y, int width, int height,
 
 void png_unload(void);
 
+/**
+ * Decodes a png file that is fully in memory.
+ * Unlike the other functions, this one keeps no state and can be called from any thread.
+ * @param buffer The png file data
+ * @param length The length of the png file data
+ * @param width Receives the width of the image
+ * @param height Receives the height of the image
+ * @return The decoded pixels, to be freed with free(), or 0 on error
+ */
+color_t *png_decode_from_buffer(const uint8_t *buffer, size_t length, int *width, int *height);
+
+/**
+ * Keeps already decoded pixels for an asset file, so png_load_from_file does not decode it again
+ * @param path The asset path, as passed to png_load_from_file
+ * @param pixels The decoded pixels, owned by the png reader afterwards
+ * @param width The width of the image
+ * @param height The height of the image
+ * @return 1 if the pixels were added, 0 if there was not enough memory
+ */
+int png_add_decoded_file(const char *path, color_t *pixels, int width, int height);
+
+int png_has_decoded_file(const char *path);
+
+/**
+ * Frees all pixels added with png_add_decoded_file
+ */
+void png_clear_decoded_files(void);
+
 #endif // CORE_PNG_H
@@ -17,6 +17,11 @@ static struct {
     int pool_index;
     int32_t pool[MAX_RANDOM];
     time_t last_seed;
+    struct {
+        int active;
+        uint32_t seed;
+        uint32_t state;
+    } deterministic_stdlib;
 } data;
 
 void random_init(void)
@@ -96,7 +101,23 @@ void random_save_state(buffer *buf)
     buffer_write_u32(buf, data.iv2);
 }
 
+void random_set_deterministic_stdlib(int active, uint32_t seed)
+{
+    data.deterministic_stdlib.active = active;
+    data.deterministic_stdlib.seed = seed;
+    data.deterministic_stdlib.state = seed;
+}
+
+void random_reseed_deterministic_stdlib(uint32_t tick)
+{
+    data.deterministic_stdlib.state = data.deterministic_stdlib.seed ^ (tick * 0x9e3779b9u);
+}
+
 int random_from_stdlib(void) {
+    if (data.deterministic_stdlib.active) {
+        data.deterministic_stdlib.state = data.deterministic_stdlib.state * 1103515245u + 12345u;
+        return (int) ((data.deterministic_stdlib.state >> 1) % ((unsigned int) RAND_MAX + 1u));
+    }
     time_t t;
     t = time(&t);
     if (data.last_seed != t) {
@@ -68,6 +68,21 @@ void random_save_state(buffer *buf);
  */
 void random_load_state(buffer *buf);
 
+/**
+ * Replaces the time-seeded standard library generator with a seeded one, so that
+ * recorded games can be played back with the same results
+ * @param active Whether to use the seeded generator
+ * @param seed Seed of the generator
+ */
+void random_set_deterministic_stdlib(int active, uint32_t seed);
+
+/**
+ * Resets the seeded generator for the given game tick. Calls made outside of game ticks,
+ * for example while drawing, then never change the values seen by the simulation.
+ * @param tick Number of the game tick that is about to run
+ */
+void random_reseed_deterministic_stdlib(uint32_t tick);
+
 int random_from_stdlib(void);
 
 int random_between_from_stdlib(int min, int max);
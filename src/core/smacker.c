@@ -2,6 +2,7 @@
 
 #include "core/file.h"
 #include "core/log.h"
+#include "core/memory.h"
 
 #include <stdint.h>
 #include <stdlib.h>
@@ -496,14 +497,14 @@ static int read_trees_data(smacker s)
 
 static int allocate_frame_memory(smacker s)
 {
-    s->frame_data.video = clear_malloc(sizeof(uint8_t) * s->width * s->height);
+    s->frame_data.video = core_memory_calloc(MEMORY_TAG_VIDEO, (size_t) s->width * s->height, sizeof(uint8_t));
     if (!s->frame_data.video) {
         log_error("SMK: no memory for video frame", 0, 0);
         return 0;
     }
     for (int i = 0; i < MAX_TRACKS; i++) {
         if (s->audio_rate[i] & AUDIO_FLAG_HAS_TRACK) {
-            s->frame_data.audio[i] = clear_malloc(s->audio_size[i]);
+            s->frame_data.audio[i] = core_memory_calloc(MEMORY_TAG_VIDEO, s->audio_size[i], 1);
             if (!s->frame_data.audio[i]) {
                 log_error("SMK: no memory for audio track", 0, i);
                 return 0;
@@ -552,9 +553,9 @@ void smacker_close(smacker s)
     free_tree16(s->full_tree);
     free_tree16(s->type_tree);
     for (int i = 0; i < MAX_TRACKS; i++) {
-        free(s->frame_data.audio[i]);
+        core_memory_free(MEMORY_TAG_VIDEO, s->frame_data.audio[i]);
     }
-    free(s->frame_data.video);
+    core_memory_free(MEMORY_TAG_VIDEO, s->frame_data.video);
     free(s);
 }
 
@@ -815,14 +816,14 @@ static uint8_t *read_frame_data(smacker s, int frame_id)
         return NULL;
     }
     size_t frame_size = s->frame_sizes[frame_id];
-    uint8_t *frame_data = (uint8_t *) clear_malloc(frame_size);
+    uint8_t *frame_data = core_memory_alloc(MEMORY_TAG_VIDEO, frame_size);
     if (!frame_data) {
         log_error("SMK: no memory for frame data", 0, frame_id);
         return NULL;
     }
     if (fread(frame_data, 1, frame_size, s->fp) != frame_size) {
         log_error("SMK: unable to read data for frame", 0, frame_id);
-        free(frame_data);
+        core_memory_free(MEMORY_TAG_VIDEO, frame_data);
         return NULL;
     }
     return frame_data;
@@ -830,7 +831,7 @@ static uint8_t *read_frame_data(smacker s, int frame_id)
 
 static void free_frame_data(uint8_t *frame_data)
 {
-    free(frame_data);
+    core_memory_free(MEMORY_TAG_VIDEO, frame_data);
 }
 
 static smacker_frame_status decode_frame(smacker s)
@@ -902,6 +903,11 @@ int smacker_get_frame_audio_size(const smacker s, int track)
     return s->frame_data.audio_len[track];
 }
 
+int smacker_get_max_frame_audio_size(const smacker s, int track)
+{
+    return (s->audio_rate[track] & AUDIO_FLAG_HAS_TRACK) ? s->audio_size[track] : 0;
+}
+
 const uint8_t *smacker_get_frame_audio(const smacker s, int track)
 {
     return s->frame_data.audio[track];
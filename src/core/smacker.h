@@ -100,6 +100,14 @@ const uint8_t *smacker_get_frame_video(const smacker s);
  */
 int smacker_get_frame_audio_size(const smacker s, int track);
 
+/**
+ * Get the largest length of audio data any frame can have for the track
+ * @param s Smacker object
+ * @param track Audio track (0-6)
+ * @return Maximum number of audio bytes returned by smacker_get_audio() for a frame
+ */
+int smacker_get_max_frame_audio_size(const smacker s, int track);
+
 /**
  * Get audio data for the current frame.
  * Note that for 16-bit audio, the bytes are in system endian-ness.
@@ -18,6 +18,7 @@
 #include "empire/type.h"
 #include "figuretype/trader.h"
 #include "game/campaign.h"
+#include "game/replay.h"
 #include "game/resource.h"
 #include "game/save_version.h"
 #include "scenario/allowed_building.h"
@@ -444,6 +445,7 @@ static int generate_trader(int city_id, empire_city *city)
 
 void empire_city_open_trade(int city_id, int apply_cost)
 {
+    game_replay_record_command(REPLAY_COMMAND_EMPIRE_OPEN_TRADE, city_id, apply_cost, 0);
     empire_city *city = array_item(cities, city_id);
     if (apply_cost) {
         city_finance_process_sundry(city->cost_to_open);
@@ -3,6 +3,8 @@
 #include "city/entertainment.h"
 #include "city/figures.h"
 #include "figure/figure.h"
+#include "figure/route.h"
+#include "figure/schedule.h"
 #include "figuretype/animal.h"
 #include "figuretype/cartpusher.h"
 #include "figuretype/crime.h"
@@ -87,9 +89,9 @@ static void (*figure_action_callbacks[])(figure *f) = {
     figure_nobody_action,
     figure_enemy_caesar_legionary_action,
     figure_native_trader_action,
-    figure_arrow_action,
-    figure_javelin_action, //60
-    figure_bolt_action,
+    figure_nobody_action, // missile, see figure_missile_update_all
+    figure_nobody_action, //60 missile, see figure_missile_update_all
+    figure_nobody_action, // missile, see figure_missile_update_all
     figure_ballista_action,
     figure_nobody_action,
     figure_missionary_action,
@@ -99,7 +101,7 @@ static void (*figure_action_callbacks[])(figure *f) = {
     figure_sheep_action,
     figure_wolf_action,
     figure_zebra_action, //70
-    figure_spear_action,
+    figure_nobody_action, // missile, see figure_missile_update_all
     figure_hippodrome_horse_action,
     figure_workcamp_worker_action,
     figure_workcamp_slave_action,
@@ -112,7 +114,7 @@ static void (*figure_action_callbacks[])(figure *f) = {
     figure_tourist_action,
     figure_watchman_action,
     figure_watchtower_archer_action,
-    figure_friendly_arrow_action,
+    figure_nobody_action, // missile, see figure_missile_update_all
     figure_supplier_action,
     figure_robber_action,
     figure_looter_action,
@@ -124,13 +126,15 @@ static void (*figure_action_callbacks[])(figure *f) = {
     figure_beggar_action,
     figure_soldier_action,
     figure_enemy_catapult_action,
-    figure_catapult_missile_action,
+    figure_nobody_action, // missile, see figure_missile_update_all
 };
 
 void figure_action_handle(void)
 {
     city_figures_reset();
     city_entertainment_set_hippodrome_has_race(0);
+    figure_schedule_start_tick();
+    figure_missile_update_all();
     for (int i = 1; i < figure_count(); i++) {
         figure *f = figure_get(i);
         if (f->state) {
@@ -143,10 +147,18 @@ void figure_action_handle(void)
                     f->targeted_by_figure_id = 0;
                 }
             }
+            if (figure_schedule_is_sleeping(f)) {
+                if (f->state == FIGURE_STATE_ALIVE && !figure_schedule_must_wake(f)) {
+                    continue;
+                }
+                figure_schedule_wake(f);
+            }
             figure_action_callbacks[f->type](f);
             if (f->state == FIGURE_STATE_DEAD) {
                 figure_delete(f);
             }
         }
     }
+    figure_route_process_requests();
+    figure_schedule_end_tick();
 }
@@ -10,7 +10,9 @@
 #include "game/save_version.h"
 #include "empire/city.h"
 #include "figure/name.h"
+#include "figure/projectile.h"
 #include "figure/route.h"
+#include "figure/schedule.h"
 #include "figure/trader.h"
 #include "figure/visited_buildings.h"
 #include "map/figure.h"
@@ -23,6 +25,10 @@
 // around 12 bytes left free in the current buffer size - save version 0xa7, August 2025
 static struct {
     int created_sequence;
+    // Every figure below this id is in use, so searching for a free slot can start here.
+    // Short-lived figures such as missiles and explosions are created and deleted all the time during battles,
+    // and this keeps their slots from being found by scanning the whole figure array every time.
+    unsigned int first_free_id;
     array(figure) figures;
 } data;
 
@@ -39,10 +45,16 @@ int figure_count(void)
 figure *figure_create(figure_type type, int x, int y, direction_type dir)
 {
     figure *f = 0;
-    array_new_item_after_index(data.figures, 1, f);
+    if (data.first_free_id < 1) {
+        data.first_free_id = 1;
+    } else if (data.first_free_id > data.figures.size) {
+        data.first_free_id = data.figures.size;
+    }
+    array_new_item_after_index(data.figures, data.first_free_id, f);
     if (!f) {
         return array_first(data.figures);
     }
+    data.first_free_id = f->id + 1;
 
     f->state = FIGURE_STATE_ALIVE;
     f->faction_id = 1;
@@ -198,11 +210,16 @@ void figure_delete(figure *f)
     }
     figure_visited_buildings_remove_list(f->last_visited_index);
     figure_route_remove(f);
+    figure_schedule_remove(f);
+    figure_projectile_remove(f);
     map_figure_delete(f);
 
     int figure_id = f->id;
     memset(f, 0, sizeof(figure));
     f->id = figure_id;
+    if ((unsigned int) figure_id < data.first_free_id) {
+        data.first_free_id = figure_id;
+    }
 
     array_trim(data.figures);
 }
@@ -244,6 +261,9 @@ void figure_init_scenario(void)
         log_error("Unable to create figures array. The game will now crash.", 0, 0);
     }
     data.created_sequence = 0;
+    data.first_free_id = 1;
+    figure_schedule_clear();
+    figure_projectile_clear();
 }
 
 void figure_kill_all(void)
@@ -518,6 +538,7 @@ static void figure_load(buffer *buf, figure *f, int figure_buf_size, int version
 
 void figure_save_state(buffer *list, buffer *seq)
 {
+    figure_schedule_wake_all();
     buffer_write_i32(seq, data.created_sequence);
 
     int buf_size = 4 + data.figures.size * FIGURE_CURRENT_BUFFER_SIZE;
@@ -561,4 +582,7 @@ void figure_load_state(buffer *list, buffer *seq, int version)
         }
     }
     data.figures.size = highest_id_in_use + 1;
+    data.first_free_id = 1;
+    figure_schedule_clear();
+    figure_projectile_restore();
 }
@@ -14,6 +14,7 @@
 #include "figure/formation_herd.h"
 #include "figure/formation_legion.h"
 #include "figure/properties.h"
+#include "game/replay.h"
 #include "game/save_version.h"
 #include "game/cheats.h"
 #include "map/grid.h"
@@ -178,6 +179,7 @@ void formation_set_selected(int formation_id)
 
 void formation_toggle_empire_service(int formation_id)
 {
+    game_replay_record_command(REPLAY_COMMAND_LEGION_TOGGLE_EMPIRE_SERVICE, formation_id, 0, 0);
     array_item(formations, formation_id)->empire_service ^= 1;
 }
 
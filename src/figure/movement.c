@@ -305,12 +305,15 @@ static void walk_ticks(figure *f, int num_ticks, int roaming_enabled)
         if (f->progress_on_tile < 15) {
             advance_tick(f);
         } else {
-            if (f->faction_id != FIGURE_FACTION_ROAMER_PREVIEW) {
+            // A figure that waited for a queued route already gave coverage when it asked for it
+            if (f->faction_id != FIGURE_FACTION_ROAMER_PREVIEW && !figure_route_take_delivered(f)) {
                 figure_service_provide_coverage(f);
             }
             f->progress_on_tile = 15;
-            if (f->routing_path_id <= 0) {
-                figure_route_add(f);
+            if (f->routing_path_id <= 0 && !figure_route_prepare(f)) {
+                // keep heading the same way until the queued route arrives
+                f->direction = f->previous_tile_direction;
+                break;
             }
             set_next_route_tile_direction(f);
             advance_route_tile(f, roaming_enabled);
@@ -0,0 +1,271 @@
+#include "projectile.h"
+
+#include "core/log.h"
+#include "map/figure.h"
+#include "map/grid.h"
+#include "map/terrain.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define POOL_SIZE_STEP 256
+
+// Missiles are kept sorted by figure id, so they hit in the same order as they would by running their actions,
+// also after the pool is rebuilt when a saved game is loaded
+static struct {
+    int size;
+    int capacity;
+    int *figure_id;
+    short *cross_country_x;
+    short *cross_country_y;
+    short *destination_x;
+    short *destination_y;
+    short *delta_x;
+    short *delta_y;
+    short *delta_xy;
+    unsigned char *cc_direction;
+    unsigned char *missile_height;
+    unsigned char *is_at_destination;
+} pool;
+
+int figure_projectile_is_projectile_type(figure_type type)
+{
+    switch (type) {
+        case FIGURE_ARROW:
+        case FIGURE_JAVELIN:
+        case FIGURE_BOLT:
+        case FIGURE_SPEAR:
+        case FIGURE_FRIENDLY_ARROW:
+        case FIGURE_CATAPULT_MISSILE:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static int resize(void **items, size_t item_size, int capacity)
+{
+    void *new_items = realloc(*items, item_size * capacity);
+    if (!new_items) {
+        return 0;
+    }
+    *items = new_items;
+    return 1;
+}
+
+static int ensure_capacity(void)
+{
+    if (pool.size < pool.capacity) {
+        return 1;
+    }
+    int capacity = pool.capacity + POOL_SIZE_STEP;
+    if (!resize((void **) &pool.figure_id, sizeof(int), capacity) ||
+        !resize((void **) &pool.cross_country_x, sizeof(short), capacity) ||
+        !resize((void **) &pool.cross_country_y, sizeof(short), capacity) ||
+        !resize((void **) &pool.destination_x, sizeof(short), capacity) ||
+        !resize((void **) &pool.destination_y, sizeof(short), capacity) ||
+        !resize((void **) &pool.delta_x, sizeof(short), capacity) ||
+        !resize((void **) &pool.delta_y, sizeof(short), capacity) ||
+        !resize((void **) &pool.delta_xy, sizeof(short), capacity) ||
+        !resize((void **) &pool.cc_direction, sizeof(unsigned char), capacity) ||
+        !resize((void **) &pool.missile_height, sizeof(unsigned char), capacity) ||
+        !resize((void **) &pool.is_at_destination, sizeof(unsigned char), capacity)) {
+        log_error("Unable to allocate memory for missiles", 0, 0);
+        return 0;
+    }
+    pool.capacity = capacity;
+    return 1;
+}
+
+// Returns the index of the missile with the figure id, or the index where it would be inserted
+static int find_index(int figure_id)
+{
+    int low = 0;
+    int high = pool.size;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (pool.figure_id[middle] < figure_id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static int get_index(int figure_id)
+{
+    int index = find_index(figure_id);
+    return index < pool.size && pool.figure_id[index] == figure_id ? index : -1;
+}
+
+#define MOVE_COLUMN(column, to, from, count) \
+    memmove(&pool.column[to], &pool.column[from], sizeof(*pool.column) * (count))
+
+// Moves the missiles from index "from" to the end of the pool so they start at index "to"
+static void move_entries(int to, int from)
+{
+    int count = pool.size - from;
+    if (count <= 0) {
+        return;
+    }
+    MOVE_COLUMN(figure_id, to, from, count);
+    MOVE_COLUMN(cross_country_x, to, from, count);
+    MOVE_COLUMN(cross_country_y, to, from, count);
+    MOVE_COLUMN(destination_x, to, from, count);
+    MOVE_COLUMN(destination_y, to, from, count);
+    MOVE_COLUMN(delta_x, to, from, count);
+    MOVE_COLUMN(delta_y, to, from, count);
+    MOVE_COLUMN(delta_xy, to, from, count);
+    MOVE_COLUMN(cc_direction, to, from, count);
+    MOVE_COLUMN(missile_height, to, from, count);
+    MOVE_COLUMN(is_at_destination, to, from, count);
+}
+
+void figure_projectile_clear(void)
+{
+    pool.size = 0;
+}
+
+void figure_projectile_add(const figure *f)
+{
+    if (!f->id) {
+        return;
+    }
+    int index = find_index(f->id);
+    if (index == pool.size || pool.figure_id[index] != f->id) {
+        if (!ensure_capacity()) {
+            return;
+        }
+        move_entries(index + 1, index);
+        pool.size++;
+    }
+    pool.figure_id[index] = f->id;
+    pool.cross_country_x[index] = f->cross_country_x;
+    pool.cross_country_y[index] = f->cross_country_y;
+    pool.destination_x[index] = f->cc_destination_x;
+    pool.destination_y[index] = f->cc_destination_y;
+    pool.delta_x[index] = f->cc_delta_x;
+    pool.delta_y[index] = f->cc_delta_y;
+    pool.delta_xy[index] = f->cc_delta_xy;
+    pool.cc_direction[index] = f->cc_direction;
+    pool.missile_height[index] = f->missile_height;
+    pool.is_at_destination[index] = 0;
+}
+
+void figure_projectile_remove(const figure *f)
+{
+    int index = get_index(f->id);
+    if (index < 0) {
+        return;
+    }
+    move_entries(index, index + 1);
+    pool.size--;
+}
+
+void figure_projectile_restore(void)
+{
+    figure_projectile_clear();
+    for (int i = 1; i < figure_count(); i++) {
+        figure *f = figure_get(i);
+        if (f->state == FIGURE_STATE_ALIVE && figure_projectile_is_projectile_type(f->type)) {
+            figure_projectile_add(f);
+        }
+    }
+}
+
+static int step_towards(int position, int destination)
+{
+    return position + (position < destination) - (position > destination);
+}
+
+// Same line walk as the cross country movement of figures, for all missiles at once
+void figure_projectile_move_all(int num_ticks)
+{
+    for (int i = 0; i < pool.size; i++) {
+        int x = pool.cross_country_x[i];
+        int y = pool.cross_country_y[i];
+        int destination_x = pool.destination_x[i];
+        int destination_y = pool.destination_y[i];
+        int delta_x = pool.delta_x[i];
+        int delta_y = pool.delta_y[i];
+        int delta_xy = pool.delta_xy[i];
+        int height = pool.missile_height[i];
+        int is_at_destination = 0;
+        for (int tick = 0; tick < num_ticks; tick++) {
+            if (height > 0) {
+                height--;
+            }
+            if (delta_x + delta_y <= 0) {
+                is_at_destination = 1;
+                break;
+            }
+            if (pool.cc_direction[i] == 2) {
+                delta_xy += delta_xy >= 0 ? 2 * (delta_x - delta_y) : 2 * delta_x;
+                delta_y--;
+                y = step_towards(y, destination_y);
+                if (delta_xy >= 0) {
+                    delta_x--;
+                    x = step_towards(x, destination_x);
+                }
+            } else {
+                delta_xy += delta_xy >= 0 ? 2 * (delta_y - delta_x) : 2 * delta_y;
+                delta_x--;
+                x = step_towards(x, destination_x);
+                if (delta_xy >= 0) {
+                    delta_y--;
+                    y = step_towards(y, destination_y);
+                }
+            }
+        }
+        pool.cross_country_x[i] = x;
+        pool.cross_country_y[i] = y;
+        pool.delta_x[i] = delta_x;
+        pool.delta_y[i] = delta_y;
+        pool.delta_xy[i] = delta_xy;
+        pool.missile_height[i] = height;
+        pool.is_at_destination[i] = is_at_destination;
+    }
+}
+
+int figure_projectile_count(void)
+{
+    return pool.size;
+}
+
+figure *figure_projectile_get(int index)
+{
+    return figure_get(pool.figure_id[index]);
+}
+
+int figure_projectile_apply_move(figure *f)
+{
+    int index = get_index(f->id);
+    if (index < 0) {
+        return 1;
+    }
+    f->cross_country_x = pool.cross_country_x[index];
+    f->cross_country_y = pool.cross_country_y[index];
+    f->cc_delta_x = pool.delta_x[index];
+    f->cc_delta_y = pool.delta_y[index];
+    f->cc_delta_xy = pool.delta_xy[index];
+    f->missile_height = pool.missile_height[index];
+
+    int x = f->cross_country_x / 15;
+    int y = f->cross_country_y / 15;
+    int grid_offset = map_grid_offset(x, y);
+    // Only a missile that changes tiles has to move between the figure lists of the tiles
+    if (grid_offset != f->grid_offset) {
+        map_figure_delete(f);
+        f->x = x;
+        f->y = y;
+        f->grid_offset = grid_offset;
+        map_figure_add(f);
+    }
+    if (map_terrain_is(f->grid_offset, TERRAIN_BUILDING)) {
+        f->in_building_wait_ticks = 8;
+    } else if (f->in_building_wait_ticks) {
+        f->in_building_wait_ticks--;
+    }
+    return pool.is_at_destination[index];
+}
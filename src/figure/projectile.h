@@ -0,0 +1,69 @@
+#ifndef FIGURE_PROJECTILE_H
+#define FIGURE_PROJECTILE_H
+
+#include "figure/figure.h"
+
+/**
+ * @file
+ * Pool of the missiles in flight: arrows, spears, javelins, bolts and catapult rocks.
+ *
+ * Missiles stay figures, so they are saved, drawn and found on their tile like any other figure.
+ * Their flight path is also kept in the pool as a structure of arrays, so all missiles move in one
+ * tight loop that touches no figure, and each figure only receives the result.
+ */
+
+/**
+ * Checks whether figures of a type are missiles kept in the pool
+ * @param type The figure type
+ * @return 1 if the type is a missile, 0 otherwise
+ */
+int figure_projectile_is_projectile_type(figure_type type);
+
+/**
+ * Empties the pool. Used when figures are reset.
+ */
+void figure_projectile_clear(void);
+
+/**
+ * Adds a missile to the pool, copying its flight path. Must be called once the path is set.
+ * @param f The missile
+ */
+void figure_projectile_add(const figure *f);
+
+/**
+ * Removes a missile from the pool. Called when a figure is deleted.
+ * @param f The figure
+ */
+void figure_projectile_remove(const figure *f);
+
+/**
+ * Refills the pool from the missiles in the figure array. Used after figures are loaded.
+ */
+void figure_projectile_restore(void);
+
+/**
+ * Moves every missile in the pool along its flight path
+ * @param num_ticks The number of movement steps for each missile
+ */
+void figure_projectile_move_all(int num_ticks);
+
+/**
+ * @return The number of missiles in the pool
+ */
+int figure_projectile_count(void);
+
+/**
+ * Gets a missile from the pool. Missiles are kept in figure id order.
+ * @param index The index in the pool, from 0 to figure_projectile_count() - 1
+ * @return The missile figure
+ */
+figure *figure_projectile_get(int index);
+
+/**
+ * Copies the result of figure_projectile_move_all() into the missile and moves it to its new tile
+ * @param f The missile
+ * @return 1 if the missile reached its destination, 0 otherwise
+ */
+int figure_projectile_apply_move(figure *f);
+
+#endif // FIGURE_PROJECTILE_H
@@ -1,12 +1,22 @@
 #include "route.h"
 
 #include "core/array.h"
+#include "core/config.h"
 #include "core/log.h"
 #include "map/routing.h"
 #include "map/routing_path.h"
+#include "platform/thread_pool.h"
+
+#include <string.h>
 
 #define ARRAY_SIZE_STEP 600
+#define REQUESTS_ARRAY_SIZE_STEP 100
 #define MAX_PATH_LENGTH 500
+#define MAX_ROUTING_WORKERS 8
+
+// Values of routing_path_id while a route is handled by figure_route_process_requests()
+#define ROUTE_PENDING -1
+#define ROUTE_NOT_FOUND -2
 
 typedef struct {
     unsigned int id;
@@ -14,8 +24,25 @@ typedef struct {
     uint8_t directions[MAX_PATH_LENGTH];
 } figure_path_data;
 
+typedef struct {
+    int figure_id;
+    int x;
+    int y;
+    int destination_x;
+    int destination_y;
+    int path_length;
+    uint8_t directions[MAX_PATH_LENGTH];
+} route_request;
+
 static array(figure_path_data) paths;
 
+static struct {
+    array(route_request) requests;
+    array(int) delivered_figure_ids;
+    routing_context *contexts[MAX_ROUTING_WORKERS];
+    int num_contexts;
+} batch;
+
 static void create_new_path(figure_path_data *path, unsigned int position)
 {
     path->id = position;
@@ -30,6 +57,8 @@ void figure_route_clear_all(void)
 {
     paths.size = 0;
     array_trim(paths);
+    batch.requests.size = 0;
+    batch.delivered_figure_ids.size = 0;
 }
 
 void figure_route_clean(void)
@@ -45,106 +74,108 @@ void figure_route_clean(void)
         }
     }
     array_trim(paths);
+    // Queued requests are not saved, so figures waiting for one have to ask again
+    for (int i = 1; i < figure_count(); i++) {
+        figure *f = figure_get(i);
+        if (f->routing_path_id == ROUTE_PENDING) {
+            f->routing_path_id = 0;
+        }
+    }
+    batch.requests.size = 0;
+    batch.delivered_figure_ids.size = 0;
 }
 
-void figure_route_add(figure *f)
+static int calculate_path(routing_context *ctx, const figure *f, uint8_t *directions)
 {
-    f->routing_path_id = 0;
-    f->routing_path_current_tile = 0;
-    f->routing_path_length = 0;
     int direction_limit = 8;
     if (f->disallow_diagonal) {
         direction_limit = 4;
     }
-    if (!paths.blocks && !array_init(paths, ARRAY_SIZE_STEP, create_new_path, path_is_used)) {
-        log_error("Unable to create paths array. The game will likely crash.", 0, 0);
-        return;
-    }
-    figure_path_data *path;
-    array_new_item_after_index(paths, 1, path);
-    if (!path) {
-        return;
-    }
-    int path_length;
     if (f->is_boat) {
         if (f->is_boat == 2) { // flotsam
-            map_routing_calculate_distances_water_flotsam(f->x, f->y);
-            path_length = map_routing_get_path_on_water(path->directions,
-                f->destination_x, f->destination_y, 1);
+            map_routing_context_calculate_distances_water_flotsam(ctx, f->x, f->y);
+            return map_routing_context_get_path_on_water(ctx, directions, f->destination_x, f->destination_y, 1);
         } else {
-            map_routing_calculate_distances_water_boat(f->x, f->y);
-            path_length = map_routing_get_path_on_water(path->directions,
-                f->destination_x, f->destination_y, 0);
+            map_routing_context_calculate_distances_water_boat(ctx, f->x, f->y);
+            return map_routing_context_get_path_on_water(ctx, directions, f->destination_x, f->destination_y, 0);
         }
-    } else {
-        // land figure
-        int can_travel;
-        switch (f->terrain_usage) {
-            case TERRAIN_USAGE_ENEMY:
-                // check to see if we can reach our destination by going around the city walls
-                can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit, f->destination_building_id, 5000);
-                if (!can_travel) {
-                    can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
-                        f->destination_x, f->destination_y, direction_limit, 0, 25000);
-                    if (!can_travel) {
-                        can_travel = map_routing_noncitizen_can_travel_through_everything(
-                            f->x, f->y, f->destination_x, f->destination_y, direction_limit);
-                    }
-                }
-                break;
-            case TERRAIN_USAGE_WALLS:
-                can_travel = map_routing_can_travel_over_walls(f->x, f->y,
-                    f->destination_x, f->destination_y, 4);
-                break;
-            case TERRAIN_USAGE_ANIMAL:
-                can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit, -1, 5000);
-                break;
-            case TERRAIN_USAGE_PREFER_ROADS:
-                can_travel = map_routing_citizen_can_travel_over_road_garden(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit);
-                if (!can_travel) {
-                    can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
-                        f->destination_x, f->destination_y, direction_limit);
-                }
-                break;
-            case TERRAIN_USAGE_ROADS:
-                can_travel = map_routing_citizen_can_travel_over_road_garden(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit);
-                break;
-            case TERRAIN_USAGE_PREFER_ROADS_HIGHWAY:
-                can_travel = map_routing_citizen_can_travel_over_road_garden_highway(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit);
+    }
+    // land figure
+    int can_travel;
+    switch (f->terrain_usage) {
+        case TERRAIN_USAGE_ENEMY:
+            // check to see if we can reach our destination by going around the city walls
+            can_travel = map_routing_context_noncitizen_can_travel_over_land(ctx, f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit, f->destination_building_id, 5000);
+            if (!can_travel) {
+                can_travel = map_routing_context_noncitizen_can_travel_over_land(ctx, f->x, f->y,
+                    f->destination_x, f->destination_y, direction_limit, 0, 25000);
                 if (!can_travel) {
-                    can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
-                        f->destination_x, f->destination_y, direction_limit);
+                    can_travel = map_routing_context_noncitizen_can_travel_through_everything(ctx,
+                        f->x, f->y, f->destination_x, f->destination_y, direction_limit);
                 }
-                break;
-            case TERRAIN_USAGE_ROADS_HIGHWAY:
-                can_travel = map_routing_citizen_can_travel_over_road_garden_highway(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit);
-                break;
-            default:
-                can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
+            }
+            break;
+        case TERRAIN_USAGE_WALLS:
+            can_travel = map_routing_context_can_travel_over_walls(ctx, f->x, f->y,
+                f->destination_x, f->destination_y, 4);
+            break;
+        case TERRAIN_USAGE_ANIMAL:
+            can_travel = map_routing_context_noncitizen_can_travel_over_land(ctx, f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit, -1, 5000);
+            break;
+        case TERRAIN_USAGE_PREFER_ROADS:
+            can_travel = map_routing_context_citizen_can_travel_over_road_garden(ctx, f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit);
+            if (!can_travel) {
+                can_travel = map_routing_context_citizen_can_travel_over_land(ctx, f->x, f->y,
                     f->destination_x, f->destination_y, direction_limit);
-                break;
-        }
-        if (can_travel) {
-            if (f->terrain_usage == TERRAIN_USAGE_WALLS) {
-                path_length = map_routing_get_path(path->directions, f->destination_x, f->destination_y, 4);
-                if (path_length <= 0) {
-                    path_length = map_routing_get_path(path->directions,
-                        f->destination_x, f->destination_y, direction_limit);
-                }
-            } else {
-                path_length = map_routing_get_path(path->directions,
+            }
+            break;
+        case TERRAIN_USAGE_ROADS:
+            can_travel = map_routing_context_citizen_can_travel_over_road_garden(ctx, f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit);
+            break;
+        case TERRAIN_USAGE_PREFER_ROADS_HIGHWAY:
+            can_travel = map_routing_context_citizen_can_travel_over_road_garden_highway(ctx, f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit);
+            if (!can_travel) {
+                can_travel = map_routing_context_citizen_can_travel_over_land(ctx, f->x, f->y,
                     f->destination_x, f->destination_y, direction_limit);
             }
-        } else { // cannot travel
-            path_length = 0;
+            break;
+        case TERRAIN_USAGE_ROADS_HIGHWAY:
+            can_travel = map_routing_context_citizen_can_travel_over_road_garden_highway(ctx, f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit);
+            break;
+        default:
+            can_travel = map_routing_context_citizen_can_travel_over_land(ctx, f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit);
+            break;
+    }
+    if (!can_travel) {
+        return 0;
+    }
+    if (f->terrain_usage == TERRAIN_USAGE_WALLS) {
+        int path_length = map_routing_context_get_path(ctx, directions, f->destination_x, f->destination_y, 4);
+        if (path_length > 0) {
+            return path_length;
         }
     }
+    return map_routing_context_get_path(ctx, directions, f->destination_x, f->destination_y, direction_limit);
+}
+
+static int init_paths(void)
+{
+    if (!paths.blocks && !array_init(paths, ARRAY_SIZE_STEP, create_new_path, path_is_used)) {
+        log_error("Unable to create paths array. The game will likely crash.", 0, 0);
+        return 0;
+    }
+    return 1;
+}
+
+static void assign_path(figure *f, figure_path_data *path, int path_length)
+{
     if (path_length) {
         path->figure_id = f->id;
         f->routing_path_id = path->id;
@@ -152,6 +183,176 @@ void figure_route_add(figure *f)
     }
 }
 
+void figure_route_add(figure *f)
+{
+    f->routing_path_id = 0;
+    f->routing_path_current_tile = 0;
+    f->routing_path_length = 0;
+    if (!init_paths()) {
+        return;
+    }
+    figure_path_data *path;
+    array_new_item_after_index(paths, 1, path);
+    if (!path) {
+        return;
+    }
+    int path_length = calculate_path(map_routing_get_default_context(), f, path->directions);
+    assign_path(f, path, path_length);
+}
+
+int figure_route_prepare(figure *f)
+{
+    if (f->routing_path_id == ROUTE_PENDING) {
+        return 0;
+    }
+    if (f->routing_path_id == ROUTE_NOT_FOUND) {
+        f->routing_path_id = 0;
+        return 1;
+    }
+    if (!config_get(CONFIG_GP_BATCH_ROUTING) || f->faction_id == FIGURE_FACTION_ROAMER_PREVIEW) {
+        figure_route_add(f);
+        return 1;
+    }
+    if (!batch.requests.blocks &&
+        !array_init(batch.requests, REQUESTS_ARRAY_SIZE_STEP, 0, 0)) {
+        log_error("Unable to create route requests array, calculating the route right away.", 0, 0);
+        figure_route_add(f);
+        return 1;
+    }
+    route_request *request = array_advance(batch.requests);
+    if (!request) {
+        figure_route_add(f);
+        return 1;
+    }
+    request->figure_id = f->id;
+    request->x = f->x;
+    request->y = f->y;
+    request->destination_x = f->destination_x;
+    request->destination_y = f->destination_y;
+    request->path_length = 0;
+    f->routing_path_id = ROUTE_PENDING;
+    f->routing_path_current_tile = 0;
+    f->routing_path_length = 0;
+    return 0;
+}
+
+static int init_contexts(void)
+{
+    if (batch.num_contexts) {
+        return 1;
+    }
+    int workers = platform_thread_pool_worker_count();
+    if (workers > MAX_ROUTING_WORKERS) {
+        workers = MAX_ROUTING_WORKERS;
+    }
+    for (int i = 0; i < workers; i++) {
+        batch.contexts[i] = map_routing_context_create();
+        if (!batch.contexts[i]) {
+            break;
+        }
+        batch.num_contexts++;
+    }
+    return batch.num_contexts > 0;
+}
+
+static void solve_request(int task, int worker, void *userdata)
+{
+    route_request *request = array_item(batch.requests, task);
+    request->path_length = calculate_path(batch.contexts[worker], figure_get(request->figure_id), request->directions);
+}
+
+static void apply_request(route_request *request)
+{
+    figure *f = figure_get(request->figure_id);
+    if (f->state != FIGURE_STATE_ALIVE || f->routing_path_id != ROUTE_PENDING) {
+        return;
+    }
+    int *delivered = batch.delivered_figure_ids.blocks ? array_advance(batch.delivered_figure_ids) : 0;
+    if (delivered) {
+        *delivered = f->id;
+    }
+    if (f->x != request->x || f->y != request->y ||
+        f->destination_x != request->destination_x || f->destination_y != request->destination_y) {
+        f->routing_path_id = 0;
+        return;
+    }
+    f->routing_path_id = ROUTE_NOT_FOUND;
+    if (!request->path_length) {
+        return;
+    }
+    figure_path_data *path;
+    array_new_item_after_index(paths, 1, path);
+    if (!path) {
+        return;
+    }
+    f->routing_path_id = 0;
+    memcpy(path->directions, request->directions, MAX_PATH_LENGTH);
+    assign_path(f, path, request->path_length);
+}
+
+void figure_route_process_requests(void)
+{
+    // Figures that got a route in the previous tick have resumed walking by now
+    batch.delivered_figure_ids.size = 0;
+    if (!batch.requests.size) {
+        return;
+    }
+    if (!init_paths() || !init_contexts()) {
+        batch.requests.size = 0;
+        return;
+    }
+    if (!batch.delivered_figure_ids.blocks &&
+        !array_init(batch.delivered_figure_ids, REQUESTS_ARRAY_SIZE_STEP, 0, 0)) {
+        log_error("Unable to create delivered routes array, figures may give coverage twice.", 0, 0);
+    }
+    for (int i = 0; i < batch.num_contexts; i++) {
+        map_routing_context_clear_cache(batch.contexts[i]);
+    }
+    // Nothing may change the map or the figures while the requests are solved
+    if (platform_thread_pool_worker_count() <= batch.num_contexts) {
+        platform_thread_pool_run(batch.requests.size, solve_request, 0);
+    } else {
+        // not enough memory for a context per worker
+        for (unsigned int i = 0; i < batch.requests.size; i++) {
+            solve_request(i, 0, 0);
+        }
+    }
+    for (int i = 0; i < batch.num_contexts; i++) {
+        map_routing_context_merge_stats(batch.contexts[i]);
+    }
+    // Requests were queued in figure id order, so applying them in order hands out the same path ids every run
+    route_request *request;
+    array_foreach(batch.requests, request) {
+        apply_request(request);
+    }
+    batch.requests.size = 0;
+}
+
+int figure_route_take_delivered(const figure *f)
+{
+    // Requests were applied in figure id order, so the ids are sorted
+    int low = 0;
+    int high = (int) batch.delivered_figure_ids.size - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        int *item = array_item(batch.delivered_figure_ids, middle);
+        // Taken ids are negated to keep the order
+        int id = *item < 0 ? -*item : *item;
+        if (id == f->id) {
+            if (*item < 0) {
+                return 0;
+            }
+            *item = -id;
+            return 1;
+        } else if (id < f->id) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return 0;
+}
+
 void figure_route_remove(figure *f)
 {
     if (f->routing_path_id > 0) {
@@ -159,6 +360,9 @@ void figure_route_remove(figure *f)
             array_item(paths, f->routing_path_id)->figure_id = 0;
         }
         f->routing_path_id = 0;
+    } else if (f->routing_path_id < 0) {
+        // a queued request, if any, is dropped when the results are applied
+        f->routing_path_id = 0;
     }
     array_trim(paths);
 }
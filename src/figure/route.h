@@ -10,6 +10,27 @@ void figure_route_clean(void);
 
 void figure_route_add(figure *f);
 
+/**
+ * Makes sure the figure has a route to its destination. The route is calculated right away unless
+ * route batching is enabled, in which case it is queued for figure_route_process_requests().
+ * @param f The figure
+ * @return 1 if the route, or the lack of one, is known, 0 if the figure has to wait for it
+ */
+int figure_route_prepare(figure *f);
+
+/**
+ * Calculates all queued routes on the worker threads and hands them to their figures in figure id order.
+ * Called once per tick after all figures have acted.
+ */
+void figure_route_process_requests(void);
+
+/**
+ * Checks whether the figure was waiting for a queued route that has been handed to it since
+ * @param f The figure
+ * @return 1 the first time it is called for a figure after its queued route was handed out, 0 otherwise
+ */
+int figure_route_take_delivered(const figure *f);
+
 void figure_route_remove(figure *f);
 
 int figure_route_get_direction(int path_id, int index);
@@ -0,0 +1,190 @@
+#include "schedule.h"
+
+#include "core/log.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Sleeping figures are kept in a timing wheel, keyed by the tick in which they wake.
+// Sleeps longer than the wheel stay in their slot until their tick comes around.
+#define WHEEL_SIZE 256
+
+typedef struct {
+    int figure_id;
+    unsigned int wake_tick;
+} wheel_entry;
+
+typedef struct {
+    unsigned int start_tick;
+    unsigned int wake_tick; // 0 when awake
+    figure_catch_up_callback catch_up;
+    figure_wake_check_callback wake_check;
+} sleeper;
+
+static struct {
+    // Number of the figure action tick being run, or the next one to run between ticks
+    unsigned int tick;
+    struct {
+        sleeper *items;
+        int size;
+    } sleepers;
+    struct {
+        wheel_entry *items;
+        int size;
+        int capacity;
+    } wheel[WHEEL_SIZE];
+} data = { 1 };
+
+static sleeper *get_sleeper(int figure_id)
+{
+    if (figure_id <= 0 || figure_id >= data.sleepers.size) {
+        return 0;
+    }
+    return &data.sleepers.items[figure_id];
+}
+
+static int ensure_sleeper(int figure_id)
+{
+    if (figure_id < data.sleepers.size) {
+        return 1;
+    }
+    int new_size = data.sleepers.size ? data.sleepers.size : 1024;
+    while (new_size <= figure_id) {
+        new_size *= 2;
+    }
+    sleeper *items = realloc(data.sleepers.items, sizeof(sleeper) * new_size);
+    if (!items) {
+        log_error("Unable to allocate memory for sleeping figures", 0, 0);
+        return 0;
+    }
+    memset(&items[data.sleepers.size], 0, sizeof(sleeper) * (new_size - data.sleepers.size));
+    data.sleepers.items = items;
+    data.sleepers.size = new_size;
+    return 1;
+}
+
+static int add_to_wheel(int figure_id, unsigned int wake_tick)
+{
+    int slot_index = wake_tick % WHEEL_SIZE;
+    if (data.wheel[slot_index].size == data.wheel[slot_index].capacity) {
+        int new_capacity = data.wheel[slot_index].capacity ? data.wheel[slot_index].capacity * 2 : 16;
+        wheel_entry *items = realloc(data.wheel[slot_index].items, sizeof(wheel_entry) * new_capacity);
+        if (!items) {
+            log_error("Unable to allocate memory for sleeping figures", 0, 0);
+            return 0;
+        }
+        data.wheel[slot_index].items = items;
+        data.wheel[slot_index].capacity = new_capacity;
+    }
+    wheel_entry *entry = &data.wheel[slot_index].items[data.wheel[slot_index].size++];
+    entry->figure_id = figure_id;
+    entry->wake_tick = wake_tick;
+    return 1;
+}
+
+static void wake_figure(int figure_id, sleeper *s)
+{
+    // Only the ticks before the current one are caught up
+    int skipped_ticks = (int) (data.tick - s->start_tick - 1);
+    figure_catch_up_callback catch_up = s->catch_up;
+    s->wake_tick = 0;
+    s->catch_up = 0;
+    s->wake_check = 0;
+    if (catch_up && skipped_ticks > 0) {
+        catch_up(figure_get(figure_id), skipped_ticks);
+    }
+}
+
+void figure_schedule_clear(void)
+{
+    if (data.sleepers.items) {
+        memset(data.sleepers.items, 0, sizeof(sleeper) * data.sleepers.size);
+    }
+    for (int i = 0; i < WHEEL_SIZE; i++) {
+        data.wheel[i].size = 0;
+    }
+}
+
+void figure_schedule_sleep(figure *f, int ticks, figure_catch_up_callback catch_up,
+    figure_wake_check_callback wake_check)
+{
+    if (ticks <= 0 || !f->id || !ensure_sleeper(f->id)) {
+        return;
+    }
+    unsigned int wake_tick = data.tick + ticks + 1;
+    if (!add_to_wheel(f->id, wake_tick)) {
+        return;
+    }
+    sleeper *s = &data.sleepers.items[f->id];
+    s->start_tick = data.tick;
+    s->wake_tick = wake_tick;
+    s->catch_up = catch_up;
+    s->wake_check = wake_check;
+}
+
+void figure_schedule_wake(figure *f)
+{
+    sleeper *s = get_sleeper(f->id);
+    if (s && s->wake_tick) {
+        wake_figure(f->id, s);
+    }
+}
+
+void figure_schedule_wake_all(void)
+{
+    for (int i = 1; i < data.sleepers.size; i++) {
+        if (data.sleepers.items[i].wake_tick) {
+            wake_figure(i, &data.sleepers.items[i]);
+        }
+    }
+    for (int i = 0; i < WHEEL_SIZE; i++) {
+        data.wheel[i].size = 0;
+    }
+}
+
+void figure_schedule_remove(const figure *f)
+{
+    sleeper *s = get_sleeper(f->id);
+    if (s) {
+        s->wake_tick = 0;
+        s->catch_up = 0;
+        s->wake_check = 0;
+    }
+}
+
+int figure_schedule_is_sleeping(const figure *f)
+{
+    const sleeper *s = get_sleeper(f->id);
+    return s && s->wake_tick;
+}
+
+int figure_schedule_must_wake(const figure *f)
+{
+    const sleeper *s = get_sleeper(f->id);
+    return s && s->wake_tick && s->wake_check && s->wake_check(f);
+}
+
+void figure_schedule_start_tick(void)
+{
+    int slot_index = data.tick % WHEEL_SIZE;
+    wheel_entry *entries = data.wheel[slot_index].items;
+    int kept = 0;
+    for (int i = 0; i < data.wheel[slot_index].size; i++) {
+        wheel_entry entry = entries[i];
+        if (entry.wake_tick > data.tick) {
+            entries[kept++] = entry;
+            continue;
+        }
+        // Entries of figures that were woken early, removed or put to sleep again are dropped
+        sleeper *s = get_sleeper(entry.figure_id);
+        if (s && s->wake_tick == entry.wake_tick) {
+            wake_figure(entry.figure_id, s);
+        }
+    }
+    data.wheel[slot_index].size = kept;
+}
+
+void figure_schedule_end_tick(void)
+{
+    data.tick++;
+}
@@ -0,0 +1,84 @@
+#ifndef FIGURE_SCHEDULE_H
+#define FIGURE_SCHEDULE_H
+
+#include "figure/figure.h"
+
+/**
+ * @file
+ * Lets figures sleep for a number of ticks, so their action is not run while they only wait.
+ *
+ * A sleeping figure must be brought back to the exact state it would have had if its action had run
+ * every tick. This is done by a catch up callback, which receives the number of ticks that were skipped.
+ * A figure whose wait can be cut short, e.g. because its building is destroyed, also passes a wake check,
+ * which is run instead of its action on every tick it sleeps.
+ * Figures are woken when their time is up, when their wake check asks for it, when figure_schedule_wake()
+ * is called, and before the game is saved or the city is rotated, so the sleeping state itself never
+ * needs to be saved.
+ */
+
+/**
+ * Brings a figure up to date after sleeping
+ * @param f The figure
+ * @param skipped_ticks The number of ticks in which the figure's action was not run
+ */
+typedef void (*figure_catch_up_callback)(figure *f, int skipped_ticks);
+
+/**
+ * Checks whether a sleeping figure has to wake before its time
+ * @param f The figure
+ * @return 1 if something the figure waits on has changed and its action must run this tick, 0 otherwise
+ */
+typedef int (*figure_wake_check_callback)(const figure *f);
+
+/**
+ * Clears all sleeping figures, without catching them up. Used when figures are reset or loaded.
+ */
+void figure_schedule_clear(void);
+
+/**
+ * Puts a figure to sleep. Must be called from the figure's action.
+ * @param f The figure
+ * @param ticks The number of following ticks in which the figure's action will not be run
+ * @param catch_up The callback that catches the figure up when it wakes
+ * @param wake_check The callback that checks whether the figure has to wake early, or 0 if it never has to
+ */
+void figure_schedule_sleep(figure *f, int ticks, figure_catch_up_callback catch_up,
+    figure_wake_check_callback wake_check);
+
+/**
+ * Wakes a figure right away, catching it up to the last tick that was run
+ * @param f The figure
+ */
+void figure_schedule_wake(figure *f);
+
+/**
+ * Wakes all sleeping figures. Called before the figures are saved and when the city is rotated.
+ */
+void figure_schedule_wake_all(void);
+
+/**
+ * Forgets a figure without catching it up. Called when a figure is deleted.
+ * @param f The figure
+ */
+void figure_schedule_remove(const figure *f);
+
+int figure_schedule_is_sleeping(const figure *f);
+
+/**
+ * Runs the wake check of a sleeping figure
+ * @param f The figure
+ * @return 1 if the figure has to wake this tick, 0 if it can keep sleeping
+ */
+int figure_schedule_must_wake(const figure *f);
+
+/**
+ * Starts a new figure action tick, waking the figures whose sleep is over
+ */
+void figure_schedule_start_tick(void);
+
+/**
+ * Ends the current figure action tick
+ */
+void figure_schedule_end_tick(void);
+
+#endif // FIGURE_SCHEDULE_H
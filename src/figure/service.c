@@ -18,22 +18,19 @@
 #define MAX_COVERAGE 96
 #define TOURISM_COOLDOWN 96
 
+// Coverage callbacks give the same coverage however often they're called, so each house in the area
+// is only visited once, while still counting every one of its tiles as serviced
 static int provide_culture(int x, int y, void (*callback)(building *))
 {
     int serviced = 0;
-    int x_min, y_min, x_max, y_max;
-    map_grid_get_area(x, y, 1, 2, &x_min, &y_min, &x_max, &y_max);
-    for (int yy = y_min; yy <= y_max; yy++) {
-        for (int xx = x_min; xx <= x_max; xx++) {
-            int grid_offset = map_grid_offset(xx, yy);
-            int building_id = map_building_at(grid_offset);
-            if (building_id) {
-                building *b = building_get(building_id);
-                if (b->house_size && b->house_population > 0) {
-                    callback(b);
-                    serviced++;
-                }
-            }
+    const uint16_t *building_ids;
+    const uint8_t *tiles;
+    int num_buildings = map_building_service_area(x, y, &building_ids, &tiles);
+    for (int i = 0; i < num_buildings; i++) {
+        building *b = building_get(building_ids[i]);
+        if (b->house_size && b->house_population > 0) {
+            callback(b);
+            serviced += tiles[i];
         }
     }
     return serviced;
@@ -62,19 +59,14 @@ static void provide_sickness(int x, int y, void (*callback)(building *, int sick
 static int provide_entertainment(int x, int y, int shows, void (*callback)(building *, int))
 {
     int serviced = 0;
-    int x_min, y_min, x_max, y_max;
-    map_grid_get_area(x, y, 1, 2, &x_min, &y_min, &x_max, &y_max);
-    for (int yy = y_min; yy <= y_max; yy++) {
-        for (int xx = x_min; xx <= x_max; xx++) {
-            int grid_offset = map_grid_offset(xx, yy);
-            int building_id = map_building_at(grid_offset);
-            if (building_id) {
-                building *b = building_get(building_id);
-                if (b->house_size && b->house_population > 0) {
-                    callback(b, shows);
-                    serviced++;
-                }
-            }
+    const uint16_t *building_ids;
+    const uint8_t *tiles;
+    int num_buildings = map_building_service_area(x, y, &building_ids, &tiles);
+    for (int i = 0; i < num_buildings; i++) {
+        building *b = building_get(building_ids[i]);
+        if (b->house_size && b->house_population > 0) {
+            callback(b, shows);
+            serviced += tiles[i];
         }
     }
     return serviced;
@@ -7,95 +7,239 @@
 #include "figure/figure.h"
 
 #define VISITED_BUILDINGS_ARRAY_SIZE_STEP 100
-#define VISITED_BUILDINGS_BUFFER_SIZE (sizeof(int32_t) * 2)
+#define VISITED_BUILDINGS_INITIAL_CAPACITY 8
+#define VISITED_BUILDINGS_LEGACY_BUFFER_SIZE (sizeof(int32_t) * 2)
 
-static array(visited_building) visited_buildings;
+static array(visited_building_set) visited_sets;
 
-static void visited_building_create(visited_building *visited, unsigned int index)
+static void visited_set_create(visited_building_set *set, unsigned int index)
 {
-    visited->index = index;
+    set->index = index;
 }
 
-static int visited_building_in_use(const visited_building *visited)
+static int visited_set_in_use(const visited_building_set *set)
 {
-    return visited->building_id != 0;
+    return set->count != 0;
 }
 
-void figure_visited_buildings_init(void)
+static void visited_set_free(visited_building_set *set)
+{
+    free(set->building_ids);
+    set->building_ids = 0;
+    set->capacity = 0;
+    set->count = 0;
+}
+
+static void init_sets(void)
 {
-    if (!array_init(visited_buildings, VISITED_BUILDINGS_ARRAY_SIZE_STEP, visited_building_create, visited_building_in_use)) {
-        log_error("Unable to allocate enough memory for the visited docks array. The game will now crash.", 0, 0);
+    visited_building_set *set;
+    array_foreach(visited_sets, set) {
+        free(set->building_ids);
+    }
+    if (!array_init(visited_sets, VISITED_BUILDINGS_ARRAY_SIZE_STEP, visited_set_create, visited_set_in_use) ||
+        !array_next(visited_sets)) { // Index 0 means "no set", so it is never handed out
+        log_error("Unable to allocate enough memory for the visited buildings array. The game will now crash.", 0, 0);
     }
 }
 
-int figure_visited_building_in_list(int index, int building_id)
+static unsigned int hash_slot(int building_id, unsigned int capacity)
+{
+    unsigned int hash = (unsigned int) building_id * 2654435761u;
+    return (hash ^ (hash >> 16)) & (capacity - 1);
+}
+
+static int set_contains(const visited_building_set *set, int building_id)
 {
-    while (index) {
-        const visited_building *visited = array_item(visited_buildings, index);
-        if (visited->building_id == building_id) {
+    if (!set->capacity) {
+        return 0;
+    }
+    unsigned int slot = hash_slot(building_id, set->capacity);
+    while (set->building_ids[slot]) {
+        if (set->building_ids[slot] == building_id) {
             return 1;
         }
-        index = visited->prev_index;
+        slot = (slot + 1) & (set->capacity - 1);
     }
     return 0;
 }
 
+static void set_insert_unchecked(int *building_ids, unsigned int capacity, int building_id)
+{
+    unsigned int slot = hash_slot(building_id, capacity);
+    while (building_ids[slot]) {
+        slot = (slot + 1) & (capacity - 1);
+    }
+    building_ids[slot] = building_id;
+}
+
+static int set_grow(visited_building_set *set)
+{
+    unsigned int new_capacity = set->capacity ? set->capacity * 2 : VISITED_BUILDINGS_INITIAL_CAPACITY;
+    int *new_ids = calloc(new_capacity, sizeof(int));
+    if (!new_ids) {
+        log_error("Unable to allocate memory for a visited buildings set.", 0, 0);
+        return 0;
+    }
+    for (unsigned int i = 0; i < set->capacity; i++) {
+        if (set->building_ids[i]) {
+            set_insert_unchecked(new_ids, new_capacity, set->building_ids[i]);
+        }
+    }
+    free(set->building_ids);
+    set->building_ids = new_ids;
+    set->capacity = new_capacity;
+    return 1;
+}
+
+static void set_add(visited_building_set *set, int building_id)
+{
+    if (set_contains(set, building_id)) {
+        return;
+    }
+    // Keep the load factor at or below 3/4 so probe sequences stay short
+    if ((set->count + 1) * 4 > set->capacity * 3 && !set_grow(set)) {
+        return;
+    }
+    set_insert_unchecked(set->building_ids, set->capacity, building_id);
+    set->count++;
+}
+
+static visited_building_set *get_set(int index)
+{
+    if (index <= 0 || (unsigned int) index >= visited_sets.size) {
+        return 0;
+    }
+    return array_item(visited_sets, index);
+}
+
+static visited_building_set *new_set(void)
+{
+    visited_building_set *set;
+    array_new_item_after_index(visited_sets, 1, set);
+    if (set && !set_grow(set)) {
+        return 0;
+    }
+    return set;
+}
+
+void figure_visited_buildings_init(void)
+{
+    init_sets();
+}
+
+int figure_visited_building_in_list(int index, int building_id)
+{
+    const visited_building_set *set = get_set(index);
+    return set && set_contains(set, building_id);
+}
+
 int figure_visited_buildings_add(int index, int building_id)
 {
-    if (figure_visited_building_in_list(index, building_id)) {
+    if (building_id <= 0) {
         return index;
     }
-    visited_building *visited;
-    array_new_item_after_index(visited_buildings, 1, visited);
-    visited->building_id = building_id;
-    visited->prev_index = index;
-    return visited->index;
+    visited_building_set *set = get_set(index);
+    if (!set || !set->count) {
+        set = new_set();
+        if (!set) {
+            return index;
+        }
+    }
+    set_add(set, building_id);
+    return set->index;
 }
 
 void figure_visited_buildings_remove_list(int index)
 {
-    while (index) {
-        visited_building *visited = array_item(visited_buildings, index);
-        index = visited->prev_index;
-        visited->prev_index = 0;
-        visited->building_id = 0;
+    visited_building_set *set = get_set(index);
+    if (!set) {
+        return;
     }
-    array_trim(visited_buildings);
+    visited_set_free(set);
+    array_trim(visited_sets);
 }
 
 void figure_visited_buildings_save_state(buffer *buf)
 {
-    int buf_size = sizeof(int32_t) + visited_buildings.size * VISITED_BUILDINGS_BUFFER_SIZE;
+    int buf_size = sizeof(int32_t);
+    const visited_building_set *set;
+    array_foreach(visited_sets, set) {
+        buf_size += sizeof(int32_t) * (1 + set->count);
+    }
     uint8_t *buf_data = malloc(buf_size);
     buffer_init(buf, buf_data, buf_size);
-    buffer_write_i32(buf, VISITED_BUILDINGS_BUFFER_SIZE);
-    const visited_building *visited;
-    array_foreach(visited_buildings, visited) {
-        buffer_write_i32(buf, visited->building_id);
-        buffer_write_i32(buf, visited->prev_index);
+    buffer_write_i32(buf, visited_sets.size);
+    array_foreach(visited_sets, set) {
+        buffer_write_i32(buf, set->count);
+        for (unsigned int i = 0; i < set->capacity; i++) {
+            if (set->building_ids[i]) {
+                buffer_write_i32(buf, set->building_ids[i]);
+            }
+        }
     }
 }
 
-void figure_visited_buildings_load_state(buffer *buf)
+static void load_linked_list_state(buffer *buf)
 {
-    int visited_buildings_to_load = (int) (buf->size - sizeof(int32_t)) / buffer_read_i32(buf);
+    int entry_size = buffer_read_i32(buf);
+    if (entry_size <= 0) {
+        return;
+    }
+    int entries = (int) (buf->size - sizeof(int32_t)) / entry_size;
+    int32_t *building_ids = malloc(sizeof(int32_t) * 2 * entries);
+    if (!building_ids) {
+        log_error("Unable to allocate memory to migrate the visited buildings list. The game will now crash.", 0, 0);
+        return;
+    }
+    int32_t *prev_indexes = building_ids + entries;
+    for (int i = 0; i < entries; i++) {
+        building_ids[i] = buffer_read_i32(buf);
+        prev_indexes[i] = buffer_read_i32(buf);
+        buffer_skip(buf, entry_size - VISITED_BUILDINGS_LEGACY_BUFFER_SIZE);
+    }
+    for (int i = 0; i < figure_count(); i++) {
+        figure *f = figure_get(i);
+        int index = f->last_visited_index;
+        f->last_visited_index = 0;
+        if (f->state == FIGURE_STATE_DEAD) {
+            continue;
+        }
+        // Guard against cycles in corrupt lists by capping the walk at the number of entries
+        for (int steps = 0; index > 0 && index < entries && steps < entries; steps++) {
+            f->last_visited_index = figure_visited_buildings_add(f->last_visited_index, building_ids[index]);
+            index = prev_indexes[index];
+        }
+    }
+    free(building_ids);
+}
 
-    if (!array_init(visited_buildings, VISITED_BUILDINGS_ARRAY_SIZE_STEP, visited_building_create, visited_building_in_use) ||
-        !array_expand(visited_buildings, visited_buildings_to_load)) {
-        log_error("Unable to allocate enough memory for the visited docks array. The game will now crash.", 0, 0);
+void figure_visited_buildings_load_state(buffer *buf, int includes_hash_sets)
+{
+    init_sets();
+    if (!includes_hash_sets) {
+        load_linked_list_state(buf);
+        return;
     }
-    for (int i = 0; i < visited_buildings_to_load; i++) {
-        visited_building *visited = array_next(visited_buildings);
-        visited->building_id = buffer_read_i32(buf);
-        visited->prev_index = buffer_read_i32(buf);
+    int sets_to_load = buffer_read_i32(buf);
+    if (!array_expand(visited_sets, sets_to_load)) {
+        log_error("Unable to allocate enough memory for the visited buildings array. The game will now crash.", 0, 0);
+        return;
+    }
+    for (int i = 0; i < sets_to_load; i++) {
+        visited_building_set *set = i == 0 ? array_first(visited_sets) : array_next(visited_sets);
+        int count = buffer_read_i32(buf);
+        for (int j = 0; j < count; j++) {
+            int building_id = buffer_read_i32(buf);
+            if (i && building_id > 0) {
+                set_add(set, building_id);
+            }
+        }
     }
 }
 
 void figure_visited_buildings_migrate(void)
 {
-    if (!array_init(visited_buildings, VISITED_BUILDINGS_ARRAY_SIZE_STEP, visited_building_create, visited_building_in_use)) {
-        log_error("Unable to allocate enough memory for the visited docks array. The game will now crash.", 0, 0);
-    }
+    init_sets();
     for (int i = 0; i < figure_count(); i++) {
         figure *f = figure_get(i);
         if (f->type != FIGURE_TRADE_SHIP || f->state == FIGURE_STATE_DEAD || !f->building_id) {
@@ -107,11 +251,7 @@ void figure_visited_buildings_migrate(void)
                 continue;
             }
             if (f->building_id & (1 << j)) {
-                visited_building *visited;
-                array_new_item_after_index(visited_buildings, 1, visited);
-                visited->building_id = dock_id;
-                visited->prev_index = f->last_visited_index;
-                f->last_visited_index = visited->index;
+                f->last_visited_index = figure_visited_buildings_add(f->last_visited_index, dock_id);
             }
         }
         f->building_id = 0;
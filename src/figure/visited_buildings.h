@@ -3,11 +3,16 @@
 
 #include "core/buffer.h"
 
+/**
+ * Per-figure set of visited building ids, stored as an open-addressing hash table with linear probing.
+ * Slots holding 0 are empty. The set index is what figures keep in last_visited_index.
+ */
 typedef struct {
     unsigned int index;
-    int building_id;
-    int prev_index;
-} visited_building;
+    unsigned int capacity;
+    unsigned int count;
+    int *building_ids;
+} visited_building_set;
 
 /**
  * Initializes the visited buildings list
@@ -15,8 +20,8 @@ typedef struct {
 void figure_visited_buildings_init(void);
 
 /**
- * Checks if a specific building has already on the visited list
- * @param index The index of the last element of the list
+ * Checks if a specific building is already on the visited list
+ * @param index The index of the figure's visited set
  * @param building_id The building to check
  * @return 1 if the building is already on the list, 0 otherwise
  */
@@ -24,19 +29,15 @@ int figure_visited_building_in_list(int index, int building_id);
 
 /**
  * Adds a building to the list of visited buildings
- * @param index The index of the last element of the list
+ * @param index The index of the figure's visited set, or 0 if the figure has no set yet
  * @param building_id The building to add
- * @return A new list index if the building was added or the same index if the building was already on the list
+ * @return The index of the set holding the building, which is only different from index when a new set was created
  */
 int figure_visited_buildings_add(int index, int building_id);
 
 /**
- * Removes an entire list of visited buildings, started at index.
- *
- * The function recursively removes the current index and all last indexes associated to the index
- * To prevent dangling lists, make sure you remove from the last actual index for the list!
- *
- * @param index The index of the last element on the list to remove
+ * Removes an entire list of visited buildings
+ * @param index The index of the figure's visited set
  */
 void figure_visited_buildings_remove_list(int index);
 
@@ -54,7 +55,8 @@ void figure_visited_buildings_save_state(buffer *buf);
 /**
  * Load state from buffer
  * @param buf Buffer
+ * @param includes_hash_sets Whether the buffer uses the set format. If not, the old linked lists are converted
  */
-void figure_visited_buildings_load_state(buffer *buf);
+void figure_visited_buildings_load_state(buffer *buf, int includes_hash_sets);
 
 #endif // FIGURE_VISITED_BUILDINGS_H
@@ -17,11 +17,13 @@
 #include "figure/image.h"
 #include "figure/movement.h"
 #include "figure/route.h"
+#include "figure/schedule.h"
 #include "game/resource.h"
 #include "map/road_network.h"
 #include "map/routing_terrain.h"
 #include "map/terrain.h"
 
+#define CARTPUSHER_INITIAL_WAIT_TICKS 30
 #define NON_STORABLE_RESOURCE_CARTPUSHER_MAX_WAIT_TICKS 300
 #define VALID_MONUMENT_RECHECK_TICKS 60
 #define GRANARY_EMPTY_ALL_CARTLOADS 8
@@ -346,6 +348,21 @@ static void reroute_cartpusher(figure *f)
     f->wait_ticks = 0;
 }
 
+// While waiting at its building, only the wait ticks of the cartpusher change
+static void cartpusher_initial_catch_up(figure *f, int skipped_ticks)
+{
+    f->wait_ticks += skipped_ticks;
+}
+
+// The same checks as the initial state of the action, which end the wait early
+static int cartpusher_initial_must_wake(const figure *f)
+{
+    const building *b = building_get(f->building_id);
+    return f->action_state != FIGURE_ACTION_20_CARTPUSHER_INITIAL ||
+        !map_routing_citizen_is_passable(f->grid_offset) ||
+        b->state != BUILDING_STATE_IN_USE || (int) b->figure_id != (int) f->id || !b->road_network_id;
+}
+
 void figure_cartpusher_action(figure *f)
 {
     figure_image_increase_offset(f, 12);
@@ -377,8 +394,12 @@ void figure_cartpusher_action(figure *f)
                 f->state = FIGURE_STATE_DEAD;
             }
             f->wait_ticks++;
-            if (f->wait_ticks > 30 && road_network_id) {
+            if (f->wait_ticks > CARTPUSHER_INITIAL_WAIT_TICKS && road_network_id) {
                 determine_cartpusher_destination(f, b, road_network_id);
+            } else if (f->wait_ticks < CARTPUSHER_INITIAL_WAIT_TICKS && f->state == FIGURE_STATE_ALIVE) {
+                // Sleep until the tick in which the wait ends
+                figure_schedule_sleep(f, CARTPUSHER_INITIAL_WAIT_TICKS - f->wait_ticks,
+                    cartpusher_initial_catch_up, cartpusher_initial_must_wake);
             }
             f->image_offset = 0;
             break;
@@ -14,6 +14,7 @@
 #include "figure/image.h"
 #include "figure/movement.h"
 #include "figure/route.h"
+#include "game/replay.h"
 #include "game/resource.h"
 #include "map/road_access.h"
 #include "map/road_network.h"
@@ -406,5 +407,6 @@ void figure_depot_cartpusher_action(figure *f)
 
 void figure_depot_recall(figure *f)
 {
+    game_replay_record_command(REPLAY_COMMAND_DEPOT_RECALL, f->id, 0, 0);
     f->action_state = FIGURE_ACTION_244_DEPOT_CART_PUSHER_CANCEL_ORDER;
 }
@@ -12,6 +12,7 @@
 #include "figure/image.h"
 #include "figure/movement.h"
 #include "figure/route.h"
+#include "figure/schedule.h"
 #include "game/undo.h"
 #include "map/road_access.h"
 
@@ -102,6 +103,18 @@ static int house_is_valid(const building *b, int figure_id)
         b->immigrant_figure_id == figure_id && b->house_size > 0 && !b->has_plague;
 }
 
+// While waiting to leave for its house, only the wait ticks of the immigrant change
+static void immigrant_created_catch_up(figure *f, int skipped_ticks)
+{
+    f->wait_ticks -= skipped_ticks;
+}
+
+static int immigrant_created_must_wake(const figure *f)
+{
+    return f->action_state != FIGURE_ACTION_1_IMMIGRANT_CREATED ||
+        !house_is_valid(building_get(f->immigrant_building_id), f->id);
+}
+
 void figure_immigrant_action(figure *f)
 {
     building *b = building_get(f->immigrant_building_id);
@@ -135,6 +148,9 @@ void figure_immigrant_action(figure *f)
                 } else {
                     f->state = FIGURE_STATE_DEAD;
                 }
+            } else if (f->wait_ticks > 1) {
+                // Sleep until the tick in which the wait ends
+                figure_schedule_sleep(f, f->wait_ticks - 1, immigrant_created_catch_up, immigrant_created_must_wake);
             }
             break;
         case FIGURE_ACTION_2_IMMIGRANT_ARRIVING:
@@ -5,6 +5,7 @@
 #include "core/image.h"
 #include "figure/formation.h"
 #include "figure/movement.h"
+#include "figure/projectile.h"
 #include "figure/properties.h"
 #include "figure/sound.h"
 #include "map/figure.h"
@@ -67,6 +68,7 @@ void figure_create_missile(int figure_id, int x, int y, int x_dst, int y_dst, fi
         figure_movement_set_cross_country_direction(
             f, f->cross_country_x, f->cross_country_y,
             15 * x_dst, 15 * y_dst, 1);
+        figure_projectile_add(f);
     }
 }
 
@@ -161,14 +163,14 @@ static void missile_hit_target(figure *f, int target_id, figure_type legionary_t
     formation_record_missile_attack(m, missile_formation);
 }
 
-void figure_arrow_action(figure *f)
+static void missile_image(figure *f, int image_offset)
+{
+    int dir = (16 + f->direction - 2 * city_view_orientation()) % 16;
+    f->image_id = image_offset + dir;
+}
+
+static void arrow_hit(figure *f, int should_die)
 {
-    f->use_cross_country = 1;
-    f->progress_on_tile++;
-    if (f->progress_on_tile > 120) {
-        f->state = FIGURE_STATE_DEAD;
-    }
-    int should_die = figure_movement_move_ticks_cross_country(f, 4);
     int target_id = get_citizen_on_tile(f->grid_offset);
     if (target_id) {
         missile_hit_target(f, target_id, FIGURE_FORT_LEGIONARY);
@@ -176,18 +178,11 @@ void figure_arrow_action(figure *f)
     } else if (should_die) {
         f->state = FIGURE_STATE_DEAD;
     }
-    int dir = (16 + f->direction - 2 * city_view_orientation()) % 16;
-    f->image_id = image_group(GROUP_FIGURE_MISSILE) + 16 + dir;
+    missile_image(f, image_group(GROUP_FIGURE_MISSILE) + 16);
 }
 
-void figure_spear_action(figure *f)
+static void spear_hit(figure *f, int should_die)
 {
-    f->use_cross_country = 1;
-    f->progress_on_tile++;
-    if (f->progress_on_tile > 120) {
-        f->state = FIGURE_STATE_DEAD;
-    }
-    int should_die = figure_movement_move_ticks_cross_country(f, 4);
     int target_id = get_citizen_on_tile(f->grid_offset);
     if (target_id) {
         missile_hit_target(f, target_id, FIGURE_FORT_LEGIONARY);
@@ -195,39 +190,23 @@ void figure_spear_action(figure *f)
     } else if (should_die) {
         f->state = FIGURE_STATE_DEAD;
     }
-    int dir = (16 + f->direction - 2 * city_view_orientation()) % 16;
-    f->image_id = image_group(GROUP_FIGURE_MISSILE) + dir;
+    missile_image(f, image_group(GROUP_FIGURE_MISSILE));
 }
 
-void figure_friendly_arrow_action(figure* f)
+static void friendly_arrow_hit(figure *f, int should_die)
 {
-	f->use_cross_country = 1;
-	f->progress_on_tile++;
-	if (f->progress_on_tile > 120) {
-		f->state = FIGURE_STATE_DEAD;
-	}
-	int should_die = figure_movement_move_ticks_cross_country(f, 4);
-	int target_id = get_non_citizen_on_tile(f->grid_offset);
-	if (target_id) {
-		missile_hit_target(f, target_id, FIGURE_ENEMY_CAESAR_LEGIONARY);
-		sound_effect_play(SOUND_EFFECT_ARROW_HIT);
-	}
-	else if (should_die) {
-		f->state = FIGURE_STATE_DEAD;
-	}
-	int dir = (16 + f->direction - 2 * city_view_orientation()) % 16;
-	f->image_id = image_group(GROUP_FIGURE_MISSILE) + 16 + dir;
+    int target_id = get_non_citizen_on_tile(f->grid_offset);
+    if (target_id) {
+        missile_hit_target(f, target_id, FIGURE_ENEMY_CAESAR_LEGIONARY);
+        sound_effect_play(SOUND_EFFECT_ARROW_HIT);
+    } else if (should_die) {
+        f->state = FIGURE_STATE_DEAD;
+    }
+    missile_image(f, image_group(GROUP_FIGURE_MISSILE) + 16);
 }
 
-
-void figure_javelin_action(figure *f)
+static void javelin_hit(figure *f, int should_die)
 {
-    f->use_cross_country = 1;
-    f->progress_on_tile++;
-    if (f->progress_on_tile > 120) {
-        f->state = FIGURE_STATE_DEAD;
-    }
-    int should_die = figure_movement_move_ticks_cross_country(f, 4);
     int target_id = get_non_citizen_on_tile(f->grid_offset);
     if (target_id) {
         missile_hit_target(f, target_id, FIGURE_ENEMY_CAESAR_LEGIONARY);
@@ -235,18 +214,11 @@ void figure_javelin_action(figure *f)
     } else if (should_die) {
         f->state = FIGURE_STATE_DEAD;
     }
-    int dir = (16 + f->direction - 2 * city_view_orientation()) % 16;
-    f->image_id = image_group(GROUP_FIGURE_MISSILE) + dir;
+    missile_image(f, image_group(GROUP_FIGURE_MISSILE));
 }
 
-void figure_bolt_action(figure *f)
+static void bolt_hit(figure *f, int should_die)
 {
-    f->use_cross_country = 1;
-    f->progress_on_tile++;
-    if (f->progress_on_tile > 120) {
-        f->state = FIGURE_STATE_DEAD;
-    }
-    int should_die = figure_movement_move_ticks_cross_country(f, 4);
     int target_id = get_non_citizen_on_tile(f->grid_offset);
     if (target_id) {
         figure *target = figure_get(target_id);
@@ -274,18 +246,11 @@ void figure_bolt_action(figure *f)
         f->state = FIGURE_STATE_DEAD;
         sound_effect_play(SOUND_EFFECT_BALLISTA_HIT_GROUND);
     }
-    int dir = (16 + f->direction - 2 * city_view_orientation()) % 16;
-    f->image_id = image_group(GROUP_FIGURE_MISSILE) + 32 + dir;
+    missile_image(f, image_group(GROUP_FIGURE_MISSILE) + 32);
 }
 
-void figure_catapult_missile_action(figure *f)
+static void catapult_missile_hit(figure *f, int should_die)
 {
-    f->use_cross_country = 1;
-    f->progress_on_tile++;
-    if (f->progress_on_tile > 120) {
-        f->state = FIGURE_STATE_DEAD;
-    }
-    int should_die = figure_movement_move_ticks_cross_country(f, 4);
     int target_id = get_citizen_on_tile(f->grid_offset);
     if (target_id) {
         missile_hit_target(f, target_id, FIGURE_NONE);
@@ -293,7 +258,44 @@ void figure_catapult_missile_action(figure *f)
     } else if (should_die) {
         f->state = FIGURE_STATE_DEAD;
     }
-    int dir = (16 + f->direction - 2 * city_view_orientation()) % 16;
-    f->image_id = assets_get_image_id("Warriors", "catapult_rock_ne_01") + dir;
+    missile_image(f, assets_get_image_id("Warriors", "catapult_rock_ne_01"));
 }
 
+void figure_missile_update_all(void)
+{
+    figure_projectile_move_all(4);
+    for (int i = 0; i < figure_projectile_count(); i++) {
+        figure *f = figure_projectile_get(i);
+        if (f->state != FIGURE_STATE_ALIVE) {
+            continue;
+        }
+        f->use_cross_country = 1;
+        f->progress_on_tile++;
+        if (f->progress_on_tile > 120) {
+            f->state = FIGURE_STATE_DEAD;
+        }
+        int should_die = figure_projectile_apply_move(f);
+        switch (f->type) {
+            case FIGURE_ARROW:
+                arrow_hit(f, should_die);
+                break;
+            case FIGURE_SPEAR:
+                spear_hit(f, should_die);
+                break;
+            case FIGURE_FRIENDLY_ARROW:
+                friendly_arrow_hit(f, should_die);
+                break;
+            case FIGURE_JAVELIN:
+                javelin_hit(f, should_die);
+                break;
+            case FIGURE_BOLT:
+                bolt_hit(f, should_die);
+                break;
+            case FIGURE_CATAPULT_MISSILE:
+                catapult_missile_hit(f, should_die);
+                break;
+            default:
+                break;
+        }
+    }
+}
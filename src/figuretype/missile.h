@@ -9,16 +9,6 @@ void figure_create_missile(int figure_id, int x, int y, int x_dst, int y_dst, fi
 
 void figure_explosion_cloud_action(figure *f);
 
-void figure_arrow_action(figure *f);
-
-void figure_friendly_arrow_action(figure* f);
-
-void figure_spear_action(figure *f);
-
-void figure_javelin_action(figure *f);
-
-void figure_bolt_action(figure *f);
-
-void figure_catapult_missile_action(figure *f);
+void figure_missile_update_all(void);
 
 #endif // FIGURETYPE_MISSILE_H
@@ -11,6 +11,7 @@
 #include "figure/image.h"
 #include "figure/movement.h"
 #include "figure/route.h"
+#include "figure/schedule.h"
 #include "map/figure.h"
 #include "map/grid.h"
 #include "map/water.h"
@@ -53,6 +54,41 @@ void figure_create_flotsam(void)
     }
 }
 
+static void update_flotsam_image(figure *f, int ticks)
+{
+    if (f->resource_id > 3) {
+        return;
+    }
+    int max_offset = f->resource_id == 0 ? 12 : 24;
+    figure_image_increase_offset(f, max_offset);
+    f->image_offset = (f->image_offset + ticks - 1) % max_offset;
+
+    if (f->resource_id == 0) {
+        if (f->min_max_seen) {
+            f->image_id = image_group(GROUP_FIGURE_FLOTSAM_SHEEP) + FLOTSAM_TYPE_0[f->image_offset];
+        } else {
+            f->image_id = image_group(GROUP_FIGURE_FLOTSAM_0) + FLOTSAM_TYPE_0[f->image_offset];
+        }
+    } else if (f->resource_id == 1) {
+        f->image_id = image_group(GROUP_FIGURE_FLOTSAM_1) + FLOTSAM_TYPE_12[f->image_offset];
+    } else if (f->resource_id == 2) {
+        f->image_id = image_group(GROUP_FIGURE_FLOTSAM_2) + FLOTSAM_TYPE_12[f->image_offset];
+    } else {
+        if (FLOTSAM_TYPE_3[f->image_offset] == -1) {
+            f->image_id = 0;
+        } else {
+            f->image_id = image_group(GROUP_FIGURE_FLOTSAM_3) + FLOTSAM_TYPE_3[f->image_offset];
+        }
+    }
+}
+
+// While waiting to float, the only things that change every tick are the wait ticks and the animation
+static void flotsam_catch_up(figure *f, int skipped_ticks)
+{
+    f->wait_ticks -= skipped_ticks;
+    update_flotsam_image(f, skipped_ticks);
+}
+
 void figure_flotsam_action(figure *f)
 {
     f->is_boat = 2;
@@ -75,6 +111,9 @@ void figure_flotsam_action(figure *f)
                 map_point river_exit = scenario_map_river_exit();
                 f->destination_x = river_exit.x;
                 f->destination_y = river_exit.y;
+            } else if (f->wait_ticks > 1) {
+                // Sleep until the tick in which the wait ends
+                figure_schedule_sleep(f, f->wait_ticks - 1, flotsam_catch_up, 0);
             }
             break;
         case FIGURE_ACTION_129_FLOTSAM_FLOATING:
@@ -116,27 +155,7 @@ void figure_flotsam_action(figure *f)
             f->cross_country_y = 15 * f->y;
             break;
     }
-    if (f->resource_id == 0) {
-        figure_image_increase_offset(f, 12);
-        if (f->min_max_seen) {
-            f->image_id = image_group(GROUP_FIGURE_FLOTSAM_SHEEP) + FLOTSAM_TYPE_0[f->image_offset];
-        } else {
-            f->image_id = image_group(GROUP_FIGURE_FLOTSAM_0) + FLOTSAM_TYPE_0[f->image_offset];
-        }
-    } else if (f->resource_id == 1) {
-        figure_image_increase_offset(f, 24);
-        f->image_id = image_group(GROUP_FIGURE_FLOTSAM_1) + FLOTSAM_TYPE_12[f->image_offset];
-    } else if (f->resource_id == 2) {
-        figure_image_increase_offset(f, 24);
-        f->image_id = image_group(GROUP_FIGURE_FLOTSAM_2) + FLOTSAM_TYPE_12[f->image_offset];
-    } else if (f->resource_id == 3) {
-        figure_image_increase_offset(f, 24);
-        if (FLOTSAM_TYPE_3[f->image_offset] == -1) {
-            f->image_id = 0;
-        } else {
-            f->image_id = image_group(GROUP_FIGURE_FLOTSAM_3) + FLOTSAM_TYPE_3[f->image_offset];
-        }
-    }
+    update_flotsam_image(f, 1);
 }
 
 void figure_shipwreck_action(figure *f)
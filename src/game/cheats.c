@@ -10,12 +10,17 @@
 #include "city/sentiment.h"
 #include "city/victory.h"
 #include "city/warning.h"
+#include "core/dir.h"
 #include "core/lang.h"
+#include "core/memory.h"
 #include "core/string.h"
 #include "empire/city.h"
 #include "figure/figure.h"
 #include "figuretype/crime.h"
+#include "game/replay.h"
+#include "game/speed.h"
 #include "game/tick.h"
+#include "game/time.h"
 #include "graphics/color.h"
 #include "graphics/font.h"
 #include "graphics/text.h"
@@ -30,6 +35,7 @@
 #include "window/editor/attributes.h"
 #include "window/editor/scenario_events.h"
 #include "window/plain_message_dialog.h"
+#include "window/skip_ahead.h"
 
 #include <string.h>
 
@@ -53,6 +59,9 @@ static void game_cheat_change_climate(uint8_t *);
 static void game_cheat_unlock_legions(uint8_t *);
 static void game_cheat_disable_legions_consumption(uint8_t *);
 static void game_cheat_disable_invasions(uint8_t *);
+static void game_cheat_skip_ahead(uint8_t *);
+static void game_cheat_replay(uint8_t *);
+static void game_cheat_memory(uint8_t *);
 
 static void (*const execute_command[])(uint8_t *args) = {
     game_cheat_add_money,
@@ -73,6 +82,9 @@ static void (*const execute_command[])(uint8_t *args) = {
     game_cheat_unlock_legions,
     game_cheat_disable_legions_consumption,
     game_cheat_disable_invasions,
+    game_cheat_skip_ahead,
+    game_cheat_replay,
+    game_cheat_memory,
 };
 
 static const char *commands[] = {
@@ -93,7 +105,10 @@ static const char *commands[] = {
     "globalwarming",
     "ihaveanarmy",
     "breadandfish",
-    "leavemealone"
+    "leavemealone",
+    "skipahead",
+    "replay",
+    "memory"
 };
 
 #define NUMBER_OF_COMMANDS sizeof (commands) / sizeof (commands[0])
@@ -300,6 +315,76 @@ static void game_cheat_disable_invasions(uint8_t *args)
     show_warning(TR_CHEAT_DISABLE_INVASIONS);
 }
 
+static void game_cheat_skip_ahead(uint8_t *args)
+{
+    int months = 0;
+    int days = 0;
+    int stop_on_events = 1;
+    int index = parse_integer(args, &months);
+    if (args[index - 1]) {
+        index += parse_integer(args + index, &days);
+        if (args[index - 1]) {
+            parse_integer(args + index, &stop_on_events);
+        }
+    }
+    int total_days = months * GAME_TIME_DAYS_PER_MONTH + days;
+    if (total_days <= 0) {
+        return;
+    }
+    window_skip_ahead_show(total_days, stop_on_events ? FAST_FORWARD_STOP_ON_ALL : FAST_FORWARD_STOP_NEVER);
+    show_warning(TR_CHEAT_SKIPPED_AHEAD);
+}
+
+static void game_cheat_replay(uint8_t *args)
+{
+    uint8_t action[MAX_COMMAND_SIZE];
+    uint8_t name[MAX_COMMAND_SIZE];
+    int with_state_hashes = 1;
+    name[0] = 0;
+    int index = parse_word(args, action);
+    if (args[index - 1]) {
+        index += parse_word(args + index, name);
+        if (args[index - 1]) {
+            parse_integer(args + index, &with_state_hashes);
+        }
+    }
+    if (strcmp((char *) action, "record") == 0 && *name) {
+        if (game_replay_start_recording((char *) name, with_state_hashes)) {
+            window_city_show();
+            show_warning(TR_CHEAT_REPLAY_RECORDING);
+        }
+    } else if (strcmp((char *) action, "play") == 0 && *name) {
+        if (game_replay_start_playback((char *) name)) {
+            window_city_show();
+            show_warning(TR_CHEAT_REPLAY_PLAYING);
+        }
+    } else if (strcmp((char *) action, "stop") == 0) {
+        game_replay_stop();
+        show_warning(TR_CHEAT_REPLAY_STOPPED);
+    }
+}
+
+static void game_cheat_memory(uint8_t *args)
+{
+    uint8_t action[MAX_COMMAND_SIZE];
+    parse_word(args, action);
+    if (strcmp((char *) action, "dump") == 0) {
+        const char *filename = dir_append_location("memory_report.txt", PATH_LOCATION_ROOT);
+        show_warning(filename && core_memory_write_report(filename) ?
+            TR_CHEAT_MEMORY_REPORT_WRITTEN : TR_CHEAT_MEMORY_REPORT_FAILED);
+        return;
+    }
+    size_t peak_bytes;
+    size_t current_bytes = core_memory_total_bytes(&peak_bytes);
+    uint8_t text[MAX_COMMAND_SIZE * 2];
+    uint8_t *cursor = string_copy(lang_get_string(CUSTOM_TRANSLATION, TR_CHEAT_MEMORY_USAGE), text, MAX_COMMAND_SIZE);
+    cursor += string_from_int(cursor, (int) (current_bytes / 1024), 0);
+    cursor = string_copy(string_from_ascii(" KB / "), cursor, 8);
+    cursor += string_from_int(cursor, (int) (peak_bytes / 1024), 0);
+    string_copy(string_from_ascii(" KB"), cursor, 4);
+    city_warning_show_custom(text, NEW_WARNING_SLOT);
+}
+
 static void game_cheat_incite_riot(uint8_t *args)
 {
     city_data.sentiment.value = 0;
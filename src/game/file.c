@@ -1,10 +1,12 @@
 #include "file.h"
 
+#include "assets/assets.h"
 #include "building/construction.h"
 #include "building/granary.h"
 #include "building/maintenance.h"
 #include "building/menu.h"
 #include "building/monument.h"
+#include "building/properties.h"
 #include "building/storage.h"
 #include "city/data.h"
 #include "city/emperor.h"
@@ -36,6 +38,7 @@
 #include "game/campaign.h"
 #include "game/difficulty.h"
 #include "game/file_io.h"
+#include "game/replay.h"
 #include "game/settings.h"
 #include "game/state.h"
 #include "game/time.h"
@@ -62,6 +65,7 @@
 #include "map/terrain.h"
 #include "map/tiles.h"
 #include "platform/file_manager.h"
+#include "scenario/allowed_building.h"
 #include "scenario/criteria.h"
 #include "scenario/custom_messages.h"
 #include "scenario/demand_change.h"
@@ -79,6 +83,7 @@
 #include "scenario/scenario.h"
 #include "sound/city.h"
 #include "sound/music.h"
+#include "widget/city_with_overlay.h"
 
 #include <string.h>
 
@@ -138,6 +143,19 @@ static void clear_scenario_data(void)
 
     map_image_context_init();
     map_random_init();
+
+    city_with_overlay_invalidate_column_cache();
+}
+
+static void prefetch_allowed_building_assets(void)
+{
+    assets_clear_prefetched_groups();
+    for (building_type type = BUILDING_ANY + 1; type < BUILDING_TYPE_MAX; type++) {
+        const building_properties *props = building_properties_for_type(type);
+        if (props->custom_asset.group && scenario_allowed_building(type)) {
+            assets_prefetch_group(props->custom_asset.group);
+        }
+    }
 }
 
 static void initialize_scenario_data(const uint8_t *scenario_name)
@@ -161,6 +179,7 @@ static void initialize_scenario_data(const uint8_t *scenario_name)
 
     // Load climate before to prevent climate related images blinking
     image_load_climate(scenario_property_climate(), 0, 0, 0);
+    prefetch_allowed_building_assets();
 
     map_natives_init();
 
@@ -293,12 +312,14 @@ static void initialize_saved_game(void)
     building_construction_clear_type();
     game_undo_disable();
     game_state_reset_overlay();
+    city_with_overlay_invalidate_column_cache();
 
     city_mission_tutorial_set_fire_message_shown(1);
     city_mission_tutorial_set_disease_message_shown(1);
 
     image_load_climate(scenario_property_climate(), 0, 0, 0);
     image_load_enemy(scenario_property_enemy());
+    prefetch_allowed_building_assets();
     city_military_determine_distant_battle_city();
 
     map_natives_check_land(0);
@@ -314,6 +335,7 @@ static void initialize_saved_game(void)
 
 static int start_scenario(const uint8_t *scenario_name, const char *scenario_file)
 {
+    game_replay_stop();
     int mission = scenario_campaign_mission();
     int rank = scenario_campaign_rank();
     map_bookmarks_clear();
@@ -363,6 +385,7 @@ static const char *get_scenario_filename(const uint8_t *scenario_name, const cha
 
 int game_file_start_scenario_from_buffer(uint8_t *data, int length, int is_save_game)
 {
+    game_replay_stop();
     buffer buf;
     buffer_init(&buf, data, length);
     int mission = scenario_campaign_mission();
@@ -439,6 +462,7 @@ int game_file_start_scenario_by_name(const uint8_t *scenario_name)
 
 int game_file_load_saved_game(const char *filename)
 {
+    game_replay_stop();
     game_campaign_suspend();
     int result = game_file_io_read_saved_game(filename, 0);
     if (result != FILE_LOAD_SUCCESS) {
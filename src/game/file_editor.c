@@ -23,6 +23,7 @@
 #include "figuretype/water.h"
 #include "game/animation.h"
 #include "game/file_io.h"
+#include "game/replay.h"
 #include "game/state.h"
 #include "game/time.h"
 #include "map/aqueduct.h"
@@ -146,6 +147,7 @@ static void prepare_map_for_editing(void)
 
 void game_file_editor_create_scenario(int size)
 {
+    game_replay_stop();
     create_blank_map(size);
     prepare_map_for_editing();
     scenario_editor_set_custom_message_introduction(0);
@@ -154,6 +156,7 @@ void game_file_editor_create_scenario(int size)
 
 int game_file_editor_load_scenario(const char *scenario_file)
 {
+    game_replay_stop();
     clear_map_data();
     building_clear_all();
     if (!game_file_io_read_scenario(scenario_file)) {
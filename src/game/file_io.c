@@ -31,6 +31,7 @@
 #include "figure/visited_buildings.h"
 #include "game/file.h"
 #include "game/save_version.h"
+#include "game/saved_game_index.h"
 #include "game/time.h"
 #include "game/tutorial.h"
 #include "map/aqueduct.h"
@@ -798,6 +799,7 @@ static void savegame_load_from_state(savegame_state *state, savegame_version_t v
     map_desirability_load_state(state->desirability_grid);
     map_elevation_load_state(state->elevation_grid);
     figure_load_state(state->figures, state->figure_sequence, version);
+    map_figure_restore_links();
     figure_route_load_state(state->route_figures, state->route_paths);
     formations_load_state(state->formations, state->formation_totals, version);
 
@@ -865,7 +867,8 @@ static void savegame_load_from_state(savegame_state *state, savegame_version_t v
     if (version <= SAVE_GAME_LAST_GLOBAL_BUILDING_INFO) {
         figure_visited_buildings_migrate();
     } else {
-        figure_visited_buildings_load_state(state->visited_buildings);
+        figure_visited_buildings_load_state(state->visited_buildings,
+            version > SAVE_GAME_LAST_LINKED_VISITED_BUILDINGS);
     }
     if (version <= SAVE_GAME_LAST_SPRITE_BRIDGES_MIGRATION_FIX) {
         map_terrain_migrate_old_bridges();
@@ -1617,6 +1620,21 @@ static void get_saved_game_origin(saved_game_info *info, const savegame_state *s
     file_remove_extension(info->origin.campaign_name);
 }
 
+static void set_savegame_minimap_functions(void)
+{
+    minimap_data.functions.building = savegame_building;
+    minimap_data.functions.climate = get_climate;
+    minimap_data.functions.map.width = map_width;
+    minimap_data.functions.map.height = map_height;
+    minimap_data.functions.viewport = set_viewport;
+    minimap_data.functions.offset.building_id = savegame_get_building_id;
+    minimap_data.functions.offset.figure = 0;
+    minimap_data.functions.offset.is_draw_tile = savegame_is_draw_tile_at;
+    minimap_data.functions.offset.random = savegame_random_at;
+    minimap_data.functions.offset.terrain = savegame_terrain_at;
+    minimap_data.functions.offset.tile_size = savegame_tile_size_at;
+}
+
 static savegame_load_status savegame_read_file_info(saved_game_info *info, savegame_version_t version)
 {
     const savegame_state *state = &savegame_data.state;
@@ -1651,17 +1669,7 @@ static savegame_load_status savegame_read_file_info(saved_game_info *info, saveg
         &grid_start, &grid_border_size, scenario_version);
     info->map_size = minimap_data.city_width;
     minimap_data.climate = scenario_climate_from_buffer(state->scenario, scenario_version);
-    minimap_data.functions.building = savegame_building;
-    minimap_data.functions.climate = get_climate;
-    minimap_data.functions.map.width = map_width;
-    minimap_data.functions.map.height = map_height;
-    minimap_data.functions.viewport = set_viewport;
-    minimap_data.functions.offset.building_id = savegame_get_building_id;
-    minimap_data.functions.offset.figure = 0;
-    minimap_data.functions.offset.is_draw_tile = savegame_is_draw_tile_at;
-    minimap_data.functions.offset.random = savegame_random_at;
-    minimap_data.functions.offset.terrain = savegame_terrain_at;
-    minimap_data.functions.offset.tile_size = savegame_tile_size_at;
+    set_savegame_minimap_functions();
 
     city_view_set_custom_lookup(grid_start, minimap_data.city_width, minimap_data.city_height, grid_border_size);
     widget_minimap_update(&minimap_data.functions);
@@ -1708,6 +1716,66 @@ int game_file_io_read_saved_game_info(const char *filename, int offset, saved_ga
     return savegame_read_file_info(info, save_version);
 }
 
+static int get_file_size(const char *filename)
+{
+    FILE *fp = file_open(filename, "rb");
+    if (!fp) {
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    file_close(fp);
+    return (int) size;
+}
+
+static int show_indexed_minimap(const saved_game_index_entry *entry)
+{
+    color_t *pixels = malloc(sizeof(color_t) * entry->minimap_width * entry->minimap_height);
+    if (!pixels || !game_saved_game_index_read_minimap(entry, pixels)) {
+        free(pixels);
+        return 0;
+    }
+    minimap_data.city_width = entry->info.map_size;
+    minimap_data.city_height = entry->city_height;
+    minimap_data.climate = entry->info.climate;
+    set_savegame_minimap_functions();
+    widget_minimap_update_from_pixels(&minimap_data.functions, pixels);
+    free(pixels);
+    return 1;
+}
+
+static void add_to_index(const char *filename, unsigned int modified_time, int file_size,
+    const saved_game_info *info)
+{
+    int width = minimap_data.city_width * 2;
+    int height = minimap_data.city_height * 2;
+    color_t *pixels = malloc(sizeof(color_t) * width * height);
+    if (pixels && widget_minimap_get_pixels(pixels, width, height)) {
+        game_saved_game_index_add(filename, modified_time, file_size, info, minimap_data.city_height,
+            pixels, width, height);
+    }
+    free(pixels);
+}
+
+int game_file_io_read_saved_game_info_indexed(const char *filename, unsigned int modified_time,
+    saved_game_info *info)
+{
+    int file_size = get_file_size(filename);
+    if (file_size < 0) {
+        return SAVEGAME_STATUS_INVALID;
+    }
+    const saved_game_index_entry *entry = game_saved_game_index_get(filename, modified_time, file_size);
+    if (entry && show_indexed_minimap(entry)) {
+        *info = entry->info;
+        return SAVEGAME_STATUS_OK;
+    }
+    int result = game_file_io_read_saved_game_info(filename, 0, info);
+    if (result == SAVEGAME_STATUS_OK) {
+        add_to_index(filename, modified_time, file_size, info);
+    }
+    return result;
+}
+
 int game_file_io_read_saved_game_info_from_buffer(buffer *buf, saved_game_info *info)
 {
     memset(info, 0, sizeof(saved_game_info));
@@ -1741,6 +1809,7 @@ int game_file_io_write_saved_game(const char *filename)
     init_savegame_data(SAVE_GAME_CURRENT_VERSION);
 
     log_info("Saving game", filename, 0);
+    game_saved_game_index_remove(filename);
     savegame_save_to_state(&savegame_data.state);
 
     FILE *fp = file_open(filename, "wb");
@@ -1760,6 +1829,7 @@ int game_file_io_write_saved_game(const char *filename)
 int game_file_io_delete_saved_game(const char *filename)
 {
     log_info("Deleting game", filename, 0);
+    game_saved_game_index_remove(filename);
     int result = file_remove(filename);
     if (!result) {
         log_error("Unable to delete game", 0, 0);
@@ -49,6 +49,17 @@ int game_file_io_read_save_game_from_buffer(buffer *buf);
 
 int game_file_io_read_saved_game_info(const char *filename, int offset, saved_game_info *info);
 
+/**
+ * Reads the info of a saved game from the saved games index, and only reads the saved game itself
+ * when it is not indexed or has changed since. Also updates the minimap to show the saved game.
+ * @param filename The saved game file
+ * @param modified_time The modification time of the saved game
+ * @param info The info to fill in
+ * @return The savegame_load_status of the saved game
+ */
+int game_file_io_read_saved_game_info_indexed(const char *filename, unsigned int modified_time,
+    saved_game_info *info);
+
 int game_file_io_read_saved_game_info_from_buffer(buffer *buf, saved_game_info *info);
 
 int game_file_io_write_saved_game(const char *filename);
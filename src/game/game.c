@@ -12,12 +12,15 @@
 #include "core/log.h"
 #include "core/random.h"
 #include "core/string.h"
+#include "core/time.h"
 #include "editor/editor.h"
 #include "figure/type.h"
 #include "game/animation.h"
 #include "game/campaign.h"
 #include "game/file.h"
 #include "game/file_editor.h"
+#include "game/replay.h"
+#include "game/saved_game_index.h"
 #include "game/settings.h"
 #include "game/speed.h"
 #include "game/state.h"
@@ -39,6 +42,8 @@
 #include "window/logo.h"
 #include "window/main_menu.h"
 
+#define FAST_FORWARD_MILLIS_PER_FRAME 30
+
 static void errlog(const char *msg)
 {
     log_error(msg, 0, 0);
@@ -201,9 +206,28 @@ int game_reload_language(void)
     return reload_language(editor_is_active(), 1);
 }
 
+static void run_fast_forward(void)
+{
+    time_millis start = time_get_millis();
+    while (game_speed_fast_forward_is_active()) {
+        game_tick_run();
+        game_file_write_mission_saved_game();
+        game_speed_fast_forward_tick_done();
+
+        if (window_is_invalid() || time_get_millis() - start >= FAST_FORWARD_MILLIS_PER_FRAME) {
+            break;
+        }
+    }
+}
+
 void game_run(void)
 {
     game_animation_update();
+    // only skip while the progress window is in front, so dialogs opened by the simulation pause the skip
+    if (game_speed_fast_forward_is_active() && window_is(WINDOW_SKIP_AHEAD)) {
+        run_fast_forward();
+        return;
+    }
     int num_ticks = game_speed_get_elapsed_ticks();
     for (int i = 0; i < num_ticks; i++) {
         game_tick_run();
@@ -219,6 +243,7 @@ void game_draw(void)
 {
     window_draw(0);
     sound_city_play();
+    assets_load_next_prefetched_group();
 }
 
 void game_display_fps(int fps)
@@ -234,6 +259,8 @@ void game_display_fps(int fps)
 
 void game_exit(void)
 {
+    game_replay_stop();
+    game_saved_game_index_write();
     video_shutdown();
     settings_save();
     config_save();
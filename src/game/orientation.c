@@ -3,6 +3,8 @@
 #include "city/view.h"
 #include "city/warning.h"
 #include "core/direction.h"
+#include "figure/schedule.h"
+#include "game/replay.h"
 #include "map/orientation.h"
 #include "widget/minimap.h"
 
@@ -10,22 +12,28 @@ static int warning_slot;
 
 void game_orientation_rotate_left(void)
 {
+    game_replay_record_map_rotation(0);
     city_view_rotate_left();
     map_orientation_change(0);
+    // Sleeping figures have to pick up images for the new orientation
+    figure_schedule_wake_all();
     widget_minimap_invalidate();
     warning_slot = city_warning_show(WARNING_ORIENTATION, warning_slot);
 }
 
 void game_orientation_rotate_right(void)
 {
+    game_replay_record_map_rotation(1);
     city_view_rotate_right();
     map_orientation_change(1);
+    figure_schedule_wake_all();
     widget_minimap_invalidate();
     warning_slot = city_warning_show(WARNING_ORIENTATION, warning_slot);
 }
 
 void game_orientation_rotate_north(void)
 {
+    game_replay_record_map_rotation(2);
     switch (city_view_orientation()) {
         case DIR_2_RIGHT:
             city_view_rotate_right();
@@ -42,6 +50,7 @@ void game_orientation_rotate_north(void)
         default: // already north
             return;
     }
+    figure_schedule_wake_all();
     widget_minimap_invalidate();
     warning_slot = city_warning_show(WARNING_ORIENTATION, warning_slot);
 }
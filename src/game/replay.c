@@ -0,0 +1,834 @@
+#include "replay.h"
+
+#include "building/barracks.h"
+#include "building/building.h"
+#include "building/construction.h"
+#include "building/data_transfer.h"
+#include "building/distribution.h"
+#include "building/dock.h"
+#include "building/industry.h"
+#include "building/monument.h"
+#include "building/roadblock.h"
+#include "building/rotation.h"
+#include "building/storage.h"
+#include "city/data_private.h"
+#include "city/emperor.h"
+#include "city/festival.h"
+#include "city/finance.h"
+#include "city/games.h"
+#include "city/labor.h"
+#include "city/resource.h"
+#include "city/trade_policy.h"
+#include "city/victory.h"
+#include "core/array.h"
+#include "core/buffer.h"
+#include "core/config.h"
+#include "core/dir.h"
+#include "core/file.h"
+#include "core/io.h"
+#include "core/log.h"
+#include "core/random.h"
+#include "empire/city.h"
+#include "figure/figure.h"
+#include "figure/formation.h"
+#include "figure/formation_legion.h"
+#include "figuretype/depot.h"
+#include "game/file.h"
+#include "game/orientation.h"
+#include "game/settings.h"
+#include "game/tick.h"
+#include "game/time.h"
+#include "game/undo.h"
+#include "map/building.h"
+#include "map/grid.h"
+#include "map/terrain.h"
+#include "scenario/request.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define REPLAY_MAGIC 0x4c505241 // "ARPL"
+#define REPLAY_VERSION 2
+#define REPLAY_VERSION_WITHOUT_SETTINGS 1
+#define REPLAY_HEADER_SIZE 28
+#define REPLAY_SETTINGS_SIZE(num_config) (sizeof(int32_t) * ((num_config) + 3))
+#define REPLAY_MAX_ARGS 8
+#define REPLAY_COMMAND_SIZE (sizeof(uint32_t) + sizeof(uint8_t) + REPLAY_MAX_ARGS * sizeof(int32_t))
+#define REPLAY_COMMANDS_SIZE_STEP 256
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+typedef struct {
+    uint32_t tick;
+    uint8_t type;
+    int32_t args[REPLAY_MAX_ARGS];
+} replay_command;
+
+typedef enum {
+    REPLAY_IDLE = 0,
+    REPLAY_RECORDING = 1,
+    REPLAY_PLAYING = 2
+} replay_mode;
+
+typedef struct {
+    int config[CONFIG_MAX_ENTRIES];
+    int difficulty;
+    int gods_enabled;
+} replay_settings;
+
+static struct {
+    replay_mode mode;
+    int in_tick;
+    int with_state_hashes;
+    uint32_t ticks;
+    uint32_t state_hash;
+    uint32_t stdlib_seed;
+    uint32_t random_iv1;
+    uint32_t random_iv2;
+    int hash_mismatches;
+    unsigned int next_command;
+    char filename[FILE_NAME_MAX];
+    array(replay_command) commands;
+    int has_settings;
+    replay_settings settings;
+    replay_settings settings_before_playback;
+} data;
+
+static void get_filenames(const char *name, char *replay_file, char *save_file)
+{
+    snprintf(replay_file, FILE_NAME_MAX, "%s.rpl", name);
+    snprintf(save_file, FILE_NAME_MAX, "%s_replay.svx", name);
+    strncpy(replay_file, dir_append_location(replay_file, PATH_LOCATION_SAVEGAME), FILE_NAME_MAX - 1);
+    strncpy(save_file, dir_append_location(save_file, PATH_LOCATION_SAVEGAME), FILE_NAME_MAX - 1);
+}
+
+static void get_random_state(uint32_t *iv1, uint32_t *iv2)
+{
+    uint8_t state[2 * sizeof(uint32_t)];
+    buffer buf;
+    buffer_init(&buf, state, sizeof(state));
+    random_save_state(&buf);
+    buffer_reset(&buf);
+    *iv1 = buffer_read_u32(&buf);
+    *iv2 = buffer_read_u32(&buf);
+}
+
+static void get_settings(replay_settings *settings)
+{
+    for (int i = 0; i < CONFIG_MAX_ENTRIES; i++) {
+        settings->config[i] = config_get(i);
+    }
+    settings->difficulty = setting_difficulty();
+    settings->gods_enabled = setting_gods_enabled();
+}
+
+static void apply_difficulty(int difficulty)
+{
+    while ((int) setting_difficulty() > difficulty && setting_difficulty() > DIFFICULTY_VERY_EASY) {
+        setting_decrease_difficulty();
+    }
+    while ((int) setting_difficulty() < difficulty && setting_difficulty() < DIFFICULTY_VERY_HARD) {
+        setting_increase_difficulty();
+    }
+}
+
+static void apply_gods_enabled(int enabled)
+{
+    if (setting_gods_enabled() != enabled) {
+        setting_toggle_gods_enabled();
+    }
+}
+
+static void apply_settings(const replay_settings *settings)
+{
+    for (int i = 0; i < CONFIG_MAX_ENTRIES; i++) {
+        config_set(i, settings->config[i]);
+    }
+    apply_difficulty(settings->difficulty);
+    apply_gods_enabled(settings->gods_enabled);
+}
+
+static void reset(void)
+{
+    if (data.mode == REPLAY_PLAYING && data.has_settings) {
+        apply_settings(&data.settings_before_playback);
+    }
+    if (data.mode != REPLAY_IDLE) {
+        random_set_deterministic_stdlib(0, 0);
+        array_clear(data.commands);
+    }
+    data.mode = REPLAY_IDLE;
+    data.in_tick = 0;
+}
+
+static replay_command *add_command(replay_command_type type)
+{
+    if (data.mode != REPLAY_RECORDING || data.in_tick) {
+        return 0;
+    }
+    replay_command *command = array_advance(data.commands);
+    if (!command) {
+        log_error("Unable to record replay command, stopping the recording.", 0, type);
+        reset();
+        return 0;
+    }
+    command->tick = data.ticks;
+    command->type = type;
+    return command;
+}
+
+int game_replay_start_recording(const char *name, int with_state_hashes)
+{
+    game_replay_stop();
+    char replay_file[FILE_NAME_MAX];
+    char save_file[FILE_NAME_MAX];
+    get_filenames(name, replay_file, save_file);
+    // Reloading makes the recording continue from exactly the state a playback starts from
+    if (!game_file_write_saved_game(save_file) || !game_file_load_saved_game(save_file)) {
+        log_error("Unable to write the starting save of the replay", save_file, 0);
+        return 0;
+    }
+    if (!array_init(data.commands, REPLAY_COMMANDS_SIZE_STEP, 0, 0)) {
+        log_error("Unable to allocate memory for the replay", 0, 0);
+        return 0;
+    }
+    strncpy(data.filename, replay_file, FILE_NAME_MAX - 1);
+    data.with_state_hashes = with_state_hashes;
+    data.ticks = 0;
+    data.state_hash = FNV_OFFSET_BASIS;
+    data.stdlib_seed = (uint32_t) time(0);
+    random_set_deterministic_stdlib(1, data.stdlib_seed);
+    get_random_state(&data.random_iv1, &data.random_iv2);
+    get_settings(&data.settings);
+    data.has_settings = 1;
+    data.mode = REPLAY_RECORDING;
+    log_info("Recording replay", replay_file, 0);
+    return 1;
+}
+
+static int write_recording(void)
+{
+    replay_command *end = add_command(REPLAY_COMMAND_END);
+    if (!end) {
+        return 0;
+    }
+    int size = REPLAY_HEADER_SIZE + REPLAY_SETTINGS_SIZE(CONFIG_MAX_ENTRIES) + data.commands.size * REPLAY_COMMAND_SIZE;
+    uint8_t *buf_data = malloc(size);
+    if (!buf_data) {
+        log_error("Unable to allocate memory to write the replay", 0, 0);
+        return 0;
+    }
+    buffer buf;
+    buffer_init(&buf, buf_data, size);
+    buffer_write_u32(&buf, REPLAY_MAGIC);
+    buffer_write_u32(&buf, REPLAY_VERSION);
+    buffer_write_u32(&buf, data.stdlib_seed);
+    buffer_write_u32(&buf, data.with_state_hashes);
+    buffer_write_u32(&buf, data.commands.size);
+    buffer_write_u32(&buf, data.random_iv1);
+    buffer_write_u32(&buf, data.random_iv2);
+    buffer_write_i32(&buf, CONFIG_MAX_ENTRIES);
+    for (int i = 0; i < CONFIG_MAX_ENTRIES; i++) {
+        buffer_write_i32(&buf, data.settings.config[i]);
+    }
+    buffer_write_i32(&buf, data.settings.difficulty);
+    buffer_write_i32(&buf, data.settings.gods_enabled);
+    const replay_command *command;
+    array_foreach(data.commands, command) {
+        buffer_write_u32(&buf, command->tick);
+        buffer_write_u8(&buf, command->type);
+        for (int i = 0; i < REPLAY_MAX_ARGS; i++) {
+            buffer_write_i32(&buf, command->args[i]);
+        }
+    }
+    int written = io_write_buffer_to_file(data.filename, buf_data, size);
+    free(buf_data);
+    if (written != size) {
+        log_error("Unable to write the replay", data.filename, 0);
+        return 0;
+    }
+    log_info("Replay written, number of ticks:", data.filename, data.ticks);
+    return 1;
+}
+
+static uint8_t *read_file(const char *filename, int *size)
+{
+    FILE *fp = file_open(filename, "rb");
+    if (!fp) {
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long file_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *contents = file_size > 0 ? malloc(file_size) : 0;
+    if (contents && fread(contents, 1, file_size, fp) != (size_t) file_size) {
+        free(contents);
+        contents = 0;
+    }
+    file_close(fp);
+    *size = (int) file_size;
+    return contents;
+}
+
+static int load_commands(const char *filename)
+{
+    int size = 0;
+    uint8_t *contents = read_file(filename, &size);
+    if (!contents) {
+        log_error("Unable to read the replay", filename, 0);
+        return 0;
+    }
+    buffer buf;
+    buffer_init(&buf, contents, size);
+    int num_commands = 0;
+    int version = 0;
+    int header_size = REPLAY_HEADER_SIZE;
+    data.has_settings = 0;
+    if (size >= REPLAY_HEADER_SIZE && buffer_read_u32(&buf) == REPLAY_MAGIC) {
+        version = buffer_read_u32(&buf);
+    }
+    if (version == REPLAY_VERSION || version == REPLAY_VERSION_WITHOUT_SETTINGS) {
+        data.stdlib_seed = buffer_read_u32(&buf);
+        data.with_state_hashes = buffer_read_u32(&buf);
+        num_commands = buffer_read_i32(&buf);
+        data.random_iv1 = buffer_read_u32(&buf);
+        data.random_iv2 = buffer_read_u32(&buf);
+    }
+    if (version == REPLAY_VERSION && num_commands > 0) {
+        int num_config = buffer_read_i32(&buf);
+        header_size += (int) REPLAY_SETTINGS_SIZE(num_config);
+        if (num_config < 0 || size < header_size) {
+            num_commands = 0;
+        } else {
+            // Options added after the recording keep their current value
+            get_settings(&data.settings);
+            for (int i = 0; i < num_config; i++) {
+                int value = buffer_read_i32(&buf);
+                if (i < CONFIG_MAX_ENTRIES) {
+                    data.settings.config[i] = value;
+                }
+            }
+            data.settings.difficulty = buffer_read_i32(&buf);
+            data.settings.gods_enabled = buffer_read_i32(&buf);
+            data.has_settings = 1;
+        }
+    }
+    if (num_commands <= 0 || size < header_size + num_commands * (int) REPLAY_COMMAND_SIZE) {
+        log_error("Invalid replay file", filename, 0);
+        free(contents);
+        return 0;
+    }
+    if (!array_init(data.commands, REPLAY_COMMANDS_SIZE_STEP, 0, 0) ||
+        !array_expand(data.commands, num_commands)) {
+        log_error("Unable to allocate memory for the replay", 0, 0);
+        free(contents);
+        return 0;
+    }
+    for (int i = 0; i < num_commands; i++) {
+        replay_command *command = array_advance(data.commands);
+        command->tick = buffer_read_u32(&buf);
+        command->type = buffer_read_u8(&buf);
+        for (int j = 0; j < REPLAY_MAX_ARGS; j++) {
+            command->args[j] = buffer_read_i32(&buf);
+        }
+    }
+    free(contents);
+    return 1;
+}
+
+int game_replay_start_playback(const char *name)
+{
+    game_replay_stop();
+    char replay_file[FILE_NAME_MAX];
+    char save_file[FILE_NAME_MAX];
+    get_filenames(name, replay_file, save_file);
+    if (!load_commands(replay_file)) {
+        return 0;
+    }
+    if (data.has_settings) {
+        get_settings(&data.settings_before_playback);
+        apply_settings(&data.settings);
+    }
+    if (!game_file_load_saved_game(save_file)) {
+        log_error("Unable to load the starting save of the replay", save_file, 0);
+        if (data.has_settings) {
+            apply_settings(&data.settings_before_playback);
+        }
+        array_clear(data.commands);
+        return 0;
+    }
+    uint32_t iv1, iv2;
+    get_random_state(&iv1, &iv2);
+    if (iv1 != data.random_iv1 || iv2 != data.random_iv2) {
+        log_error("The starting save of the replay has a different random seed, playback will differ", save_file, 0);
+    }
+    strncpy(data.filename, replay_file, FILE_NAME_MAX - 1);
+    data.ticks = 0;
+    data.next_command = 0;
+    data.hash_mismatches = 0;
+    data.state_hash = FNV_OFFSET_BASIS;
+    random_set_deterministic_stdlib(1, data.stdlib_seed);
+    data.mode = REPLAY_PLAYING;
+    log_info("Playing replay", replay_file, 0);
+    return 1;
+}
+
+void game_replay_stop(void)
+{
+    if (data.mode == REPLAY_RECORDING) {
+        write_recording();
+    } else if (data.mode == REPLAY_PLAYING) {
+        log_info("Replay stopped, days with a different state:", data.filename, data.hash_mismatches);
+    }
+    reset();
+}
+
+int game_replay_is_recording(void)
+{
+    return data.mode == REPLAY_RECORDING;
+}
+
+int game_replay_is_playing(void)
+{
+    return data.mode == REPLAY_PLAYING;
+}
+
+int game_replay_hash_mismatches(void)
+{
+    return data.hash_mismatches;
+}
+
+static uint32_t hash_int(uint32_t hash, int32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+uint32_t game_replay_state_hash(uint32_t hash)
+{
+    uint32_t iv1, iv2;
+    get_random_state(&iv1, &iv2);
+    hash = hash_int(hash, iv1);
+    hash = hash_int(hash, iv2);
+    hash = hash_int(hash, city_data.finance.treasury);
+    hash = hash_int(hash, city_data.population.population);
+    for (int i = 1; i < building_count(); i++) {
+        const building *b = building_get(i);
+        if (b->state == BUILDING_STATE_UNUSED) {
+            continue;
+        }
+        hash = hash_int(hash, i);
+        hash = hash_int(hash, b->type);
+        hash = hash_int(hash, b->state);
+        hash = hash_int(hash, b->grid_offset);
+        hash = hash_int(hash, b->house_population);
+        hash = hash_int(hash, b->num_workers);
+        hash = hash_int(hash, b->desirability);
+        hash = hash_int(hash, b->fire_risk);
+        hash = hash_int(hash, b->damage_risk);
+        for (int r = 0; r < RESOURCE_MAX; r++) {
+            hash = hash_int(hash, b->resources[r]);
+        }
+    }
+    for (int i = 1; i < figure_count(); i++) {
+        const figure *f = figure_get(i);
+        if (!f->state) {
+            continue;
+        }
+        hash = hash_int(hash, i);
+        hash = hash_int(hash, f->type);
+        hash = hash_int(hash, f->state);
+        hash = hash_int(hash, f->action_state);
+        hash = hash_int(hash, f->grid_offset);
+        hash = hash_int(hash, f->progress_on_tile);
+        hash = hash_int(hash, f->destination_building_id);
+    }
+    for (int grid_offset = 0; grid_offset < GRID_SIZE * GRID_SIZE; grid_offset++) {
+        hash = hash_int(hash, map_terrain_get(grid_offset));
+        hash = hash_int(hash, map_building_at(grid_offset));
+    }
+    return hash;
+}
+
+void game_replay_record_construction(building_type type, int x_start, int y_start, int x_end, int y_end)
+{
+    replay_command *command = add_command(REPLAY_COMMAND_CONSTRUCTION);
+    if (!command) {
+        return;
+    }
+    command->args[0] = type;
+    command->args[1] = x_start;
+    command->args[2] = y_start;
+    command->args[3] = x_end;
+    command->args[4] = y_end;
+    int rotation, extra_rotation, road_orientation;
+    building_rotation_get_state(&rotation, &extra_rotation, &road_orientation);
+    command->args[5] = rotation;
+    command->args[6] = extra_rotation;
+    command->args[7] = road_orientation;
+}
+
+void game_replay_record_tax_change(int change)
+{
+    replay_command *command = add_command(REPLAY_COMMAND_TAX_CHANGE);
+    if (command) {
+        command->args[0] = change;
+    }
+}
+
+void game_replay_record_wages_change(int change)
+{
+    replay_command *command = add_command(REPLAY_COMMAND_WAGES_CHANGE);
+    if (command) {
+        command->args[0] = change;
+    }
+}
+
+void game_replay_record_map_rotation(int direction)
+{
+    replay_command *command = add_command(REPLAY_COMMAND_MAP_ROTATION);
+    if (command) {
+        command->args[0] = direction;
+    }
+}
+
+void game_replay_record_undo(void)
+{
+    add_command(REPLAY_COMMAND_UNDO);
+}
+
+void game_replay_record_command(replay_command_type type, int arg1, int arg2, int arg3)
+{
+    replay_command *command = add_command(type);
+    if (command) {
+        command->args[0] = arg1;
+        command->args[1] = arg2;
+        command->args[2] = arg3;
+    }
+}
+
+void game_replay_record_depot_order(const building *b)
+{
+    replay_command *command = add_command(REPLAY_COMMAND_DEPOT_ORDER);
+    if (!command) {
+        return;
+    }
+    const order *current_order = &b->data.depot.current_order;
+    command->args[0] = b->id;
+    command->args[1] = current_order->resource_type;
+    command->args[2] = current_order->src_storage_id;
+    command->args[3] = current_order->dst_storage_id;
+    command->args[4] = current_order->condition.condition_type;
+    command->args[5] = current_order->condition.threshold;
+}
+
+static void play_construction(const replay_command *command)
+{
+    int x_start = command->args[1];
+    int y_start = command->args[2];
+    int x_end = command->args[3];
+    int y_end = command->args[4];
+    building_construction_set_type(command->args[0]);
+    building_rotation_set_state(command->args[5], command->args[6], command->args[7]);
+    building_construction_start(x_start, y_start, map_grid_offset(x_start, y_start));
+    building_construction_update(x_end, y_end, map_grid_offset(x_end, y_end));
+    building_construction_place();
+    building_construction_clear_type();
+}
+
+static void play_legion_move(const replay_command *command)
+{
+    map_tile tile;
+    tile.x = command->args[1];
+    tile.y = command->args[2];
+    tile.grid_offset = map_grid_offset(tile.x, tile.y);
+    formation_legion_move_to(formation_get(command->args[0]), &tile);
+}
+
+static void play_depot_order(const replay_command *command)
+{
+    order *current_order = &building_get(command->args[0])->data.depot.current_order;
+    current_order->resource_type = command->args[1];
+    current_order->src_storage_id = command->args[2];
+    current_order->dst_storage_id = command->args[3];
+    current_order->condition.condition_type = command->args[4];
+    current_order->condition.threshold = command->args[5];
+}
+
+static void play_festival_schedule(const replay_command *command)
+{
+    city_data.festival.selected.god = command->args[0];
+    city_data.festival.selected.size = command->args[1];
+    city_festival_schedule();
+}
+
+static void play_command(const replay_command *command)
+{
+    const int32_t *args = command->args;
+    switch (command->type) {
+        case REPLAY_COMMAND_CONSTRUCTION:
+            play_construction(command);
+            break;
+        case REPLAY_COMMAND_TAX_CHANGE:
+            city_finance_change_tax_percentage(command->args[0]);
+            break;
+        case REPLAY_COMMAND_WAGES_CHANGE:
+            city_labor_change_wages(command->args[0]);
+            break;
+        case REPLAY_COMMAND_MAP_ROTATION:
+            if (command->args[0] == 0) {
+                game_orientation_rotate_left();
+            } else if (command->args[0] == 1) {
+                game_orientation_rotate_right();
+            } else {
+                game_orientation_rotate_north();
+            }
+            break;
+        case REPLAY_COMMAND_UNDO:
+            game_undo_perform();
+            break;
+        case REPLAY_COMMAND_LEGION_MOVE:
+            play_legion_move(command);
+            break;
+        case REPLAY_COMMAND_LEGION_RETURN_HOME:
+            formation_legion_return_home(formation_get(args[0]));
+            break;
+        case REPLAY_COMMAND_LEGION_CHANGE_LAYOUT:
+            formation_legion_change_layout(formation_get(args[0]), args[1]);
+            break;
+        case REPLAY_COMMAND_LEGION_TOGGLE_EMPIRE_SERVICE:
+            formation_toggle_empire_service(args[0]);
+            break;
+        case REPLAY_COMMAND_LEGIONS_DISPATCH_TO_DISTANT_BATTLE:
+            formation_legions_dispatch_to_distant_battle();
+            break;
+        case REPLAY_COMMAND_BUILDING_MOTHBALL_TOGGLE:
+            building_mothball_toggle(building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_BUILDING_STOCKPILING_TOGGLE:
+            building_stockpiling_toggle(building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_STORAGE_TOGGLE_EMPTY_ALL:
+            building_storage_toggle_empty_all(args[0]);
+            break;
+        case REPLAY_COMMAND_STORAGE_TOGGLE_PERMISSION:
+            building_storage_toggle_permission(args[1], building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_STORAGE_SET_PERMISSION:
+            building_storage_set_permission(args[1], building_get(args[0]), args[2]);
+            break;
+        case REPLAY_COMMAND_STORAGE_ACCEPT_NONE:
+            building_storage_accept_none(args[0]);
+            break;
+        case REPLAY_COMMAND_STORAGE_ACCEPT_ALL:
+            building_storage_accept_all(args[0]);
+            break;
+        case REPLAY_COMMAND_STORAGE_CYCLE_RESOURCE_STATE:
+            building_storage_cycle_resource_state(args[0], args[1]);
+            break;
+        case REPLAY_COMMAND_STORAGE_CYCLE_PARTIAL_RESOURCE_STATE:
+            building_storage_cycle_partial_resource_state(args[0], args[1], args[2]);
+            break;
+        case REPLAY_COMMAND_ROADBLOCK_SET_PERMISSION:
+            building_roadblock_set_permission(args[1], building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_ROADBLOCK_ACCEPT_NONE:
+            building_roadblock_accept_none(building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_ROADBLOCK_ACCEPT_ALL:
+            building_roadblock_accept_all(building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_MONUMENT_TOGGLE_CONSTRUCTION_HALTED:
+            building_monument_toggle_construction_halted(building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_MONUMENT_ADD_MODULE:
+            building_monument_add_module(building_get(args[0]), args[1]);
+            break;
+        case REPLAY_COMMAND_DISTRIBUTION_TOGGLE_GOOD_ACCEPTED:
+            building_distribution_toggle_good_accepted(building_get(args[0]), args[1]);
+            break;
+        case REPLAY_COMMAND_DISTRIBUTION_ACCEPT_ALL_GOODS:
+            building_distribution_accept_all_goods(building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_DISTRIBUTION_UNACCEPT_ALL_GOODS:
+            building_distribution_unaccept_all_goods(building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_BARRACKS_SET_PRIORITY:
+            building_barracks_set_priority(building_get(args[0]), args[1]);
+            break;
+        case REPLAY_COMMAND_BARRACKS_TOGGLE_DELIVERY:
+            building_barracks_toggle_delivery(building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_DATA_TRANSFER_COPY:
+            building_data_transfer_copy(building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_DATA_TRANSFER_PASTE:
+            building_data_transfer_paste(building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_DOCK_SET_CAN_TRADE_WITH_ROUTE:
+            building_dock_set_can_trade_with_route(args[0], args[1], args[2]);
+            break;
+        case REPLAY_COMMAND_DEPOT_ORDER:
+            play_depot_order(command);
+            break;
+        case REPLAY_COMMAND_DEPOT_RECALL:
+            figure_depot_recall(figure_get(args[0]));
+            break;
+        case REPLAY_COMMAND_CITY_MINT_SWITCH_OUTPUT:
+            building_industry_switch_city_mint_output(building_get(args[0]));
+            break;
+        case REPLAY_COMMAND_RESOURCE_TOGGLE_STOCKPILED:
+            city_resource_toggle_stockpiled(args[0]);
+            break;
+        case REPLAY_COMMAND_RESOURCE_TOGGLE_MOTHBALLED:
+            city_resource_toggle_mothballed(args[0]);
+            break;
+        case REPLAY_COMMAND_RESOURCE_CHANGE_IMPORT_OVER:
+            city_resource_change_import_over(args[0], args[1]);
+            break;
+        case REPLAY_COMMAND_RESOURCE_CHANGE_EXPORT_OVER:
+            city_resource_change_export_over(args[0], args[1]);
+            break;
+        case REPLAY_COMMAND_RESOURCE_CYCLE_TRADE_STATUS:
+            city_resource_cycle_trade_status(args[0], args[1]);
+            break;
+        case REPLAY_COMMAND_TRADE_POLICY_SET:
+            city_trade_policy_set(args[0], args[1]);
+            break;
+        case REPLAY_COMMAND_LABOR_SET_PRIORITY:
+            city_labor_set_priority(args[0], args[1]);
+            break;
+        case REPLAY_COMMAND_FESTIVAL_SCHEDULE:
+            play_festival_schedule(command);
+            break;
+        case REPLAY_COMMAND_GAMES_SCHEDULE:
+            city_games_schedule(args[0]);
+            break;
+        case REPLAY_COMMAND_EMPEROR_SEND_GIFT:
+            city_emperor_set_gift_size(args[0]);
+            city_emperor_send_gift();
+            break;
+        case REPLAY_COMMAND_EMPEROR_SET_SALARY_RANK:
+            city_emperor_set_salary_rank(args[0]);
+            break;
+        case REPLAY_COMMAND_EMPEROR_DONATE_SAVINGS:
+            city_emperor_set_donation_amount(args[0]);
+            city_emperor_donate_savings_to_city();
+            break;
+        case REPLAY_COMMAND_REQUEST_DISPATCH:
+            scenario_request_dispatch(args[0]);
+            break;
+        case REPLAY_COMMAND_EMPIRE_OPEN_TRADE:
+            empire_city_open_trade(args[0], args[1]);
+            break;
+        case REPLAY_COMMAND_VICTORY_CONTINUE_GOVERNING:
+            city_victory_continue_governing(args[0]);
+            break;
+        case REPLAY_COMMAND_VICTORY_STOP_GOVERNING:
+            city_victory_stop_governing();
+            break;
+        case REPLAY_COMMAND_CONFIG_CHANGE:
+            if (args[0] >= 0 && args[0] < CONFIG_MAX_ENTRIES) {
+                config_set(args[0], args[1]);
+            }
+            break;
+        case REPLAY_COMMAND_DIFFICULTY_CHANGE:
+            apply_difficulty(args[0]);
+            break;
+        case REPLAY_COMMAND_GODS_ENABLED_CHANGE:
+            apply_gods_enabled(args[0]);
+            break;
+        default:
+            break;
+    }
+}
+
+void game_replay_before_tick(void)
+{
+    if (data.mode == REPLAY_IDLE) {
+        return;
+    }
+    if (data.mode == REPLAY_PLAYING) {
+        if (data.next_command >= data.commands.size) {
+            game_replay_stop();
+            return;
+        }
+        while (data.next_command < data.commands.size) {
+            const replay_command *command = array_item(data.commands, data.next_command);
+            if (command->tick > data.ticks || command->type == REPLAY_COMMAND_STATE_HASH) {
+                break;
+            }
+            if (command->type == REPLAY_COMMAND_END) {
+                game_replay_stop();
+                return;
+            }
+            play_command(command);
+            data.next_command++;
+        }
+    }
+    random_reseed_deterministic_stdlib(data.ticks);
+    data.in_tick = 1;
+}
+
+static void check_state_hash(void)
+{
+    while (data.next_command < data.commands.size) {
+        const replay_command *command = array_item(data.commands, data.next_command);
+        if (command->tick > data.ticks || command->type != REPLAY_COMMAND_STATE_HASH) {
+            return;
+        }
+        if ((uint32_t) command->args[0] != data.state_hash) {
+            if (!data.hash_mismatches) {
+                log_error("Replay state differs from the recording, starting at tick", 0, data.ticks);
+            }
+            data.hash_mismatches++;
+            // Continue from the recorded hash so every later day is compared on its own
+            data.state_hash = command->args[0];
+        }
+        data.next_command++;
+    }
+}
+
+void game_replay_after_tick(void)
+{
+    if (data.mode == REPLAY_IDLE) {
+        return;
+    }
+    data.in_tick = 0;
+    data.ticks++;
+    if (!data.with_state_hashes || game_time_tick() != 0) {
+        return;
+    }
+    data.state_hash = game_replay_state_hash(data.state_hash);
+    if (data.mode == REPLAY_RECORDING) {
+        replay_command *command = add_command(REPLAY_COMMAND_STATE_HASH);
+        if (command) {
+            command->args[0] = data.state_hash;
+        }
+    } else {
+        check_state_hash();
+    }
+}
+
+int game_replay_run_headless(const char *name)
+{
+    if (!game_replay_start_playback(name)) {
+        return 0;
+    }
+    uint32_t ticks = 0;
+    clock_t start = clock();
+    // Playback stops by itself after the last recorded tick
+    while (data.mode == REPLAY_PLAYING) {
+        game_tick_run();
+        ticks++;
+    }
+    int millis = (int) ((clock() - start) * 1000 / CLOCKS_PER_SEC);
+    log_info("Headless replay finished, number of ticks:", name, ticks);
+    log_info("Headless replay time in ms:", 0, millis);
+    return data.hash_mismatches == 0;
+}
@@ -0,0 +1,163 @@
+#ifndef GAME_REPLAY_H
+#define GAME_REPLAY_H
+
+#include "building/building.h"
+
+#include <stdint.h>
+
+/**
+ * @file
+ * Recording and playback of player commands, used to reproduce a game exactly.
+ *
+ * Recording saves the game and reloads it, so the recording and its playback both start
+ * from the same loaded state. Every command is stored with the number of game ticks run since then.
+ * Optionally, a rolling hash of the building, figure and map state is stored every day
+ * and checked during playback, to find where a playback starts to differ from the recording.
+ * The configuration and difficulty in use when recording starts are stored as well, and used during playback.
+ */
+
+typedef enum {
+    REPLAY_COMMAND_NONE = 0,
+    REPLAY_COMMAND_CONSTRUCTION = 1,
+    REPLAY_COMMAND_TAX_CHANGE = 2,
+    REPLAY_COMMAND_WAGES_CHANGE = 3,
+    REPLAY_COMMAND_MAP_ROTATION = 4,
+    REPLAY_COMMAND_UNDO = 5,
+    REPLAY_COMMAND_STATE_HASH = 6,
+    REPLAY_COMMAND_END = 7,
+    // Legion orders: formation id, then the arguments of the order
+    REPLAY_COMMAND_LEGION_MOVE = 8,
+    REPLAY_COMMAND_LEGION_RETURN_HOME = 9,
+    REPLAY_COMMAND_LEGION_CHANGE_LAYOUT = 10,
+    REPLAY_COMMAND_LEGION_TOGGLE_EMPIRE_SERVICE = 11,
+    REPLAY_COMMAND_LEGIONS_DISPATCH_TO_DISTANT_BATTLE = 12,
+    // Building settings: building id, or storage id for storage commands, then the arguments of the setting
+    REPLAY_COMMAND_BUILDING_MOTHBALL_TOGGLE = 13,
+    REPLAY_COMMAND_BUILDING_STOCKPILING_TOGGLE = 14,
+    REPLAY_COMMAND_STORAGE_TOGGLE_EMPTY_ALL = 15,
+    REPLAY_COMMAND_STORAGE_TOGGLE_PERMISSION = 16,
+    REPLAY_COMMAND_STORAGE_SET_PERMISSION = 17,
+    REPLAY_COMMAND_STORAGE_ACCEPT_NONE = 18,
+    REPLAY_COMMAND_STORAGE_ACCEPT_ALL = 19,
+    REPLAY_COMMAND_STORAGE_CYCLE_RESOURCE_STATE = 20,
+    REPLAY_COMMAND_STORAGE_CYCLE_PARTIAL_RESOURCE_STATE = 21,
+    REPLAY_COMMAND_ROADBLOCK_SET_PERMISSION = 22,
+    REPLAY_COMMAND_ROADBLOCK_ACCEPT_NONE = 23,
+    REPLAY_COMMAND_ROADBLOCK_ACCEPT_ALL = 24,
+    REPLAY_COMMAND_MONUMENT_TOGGLE_CONSTRUCTION_HALTED = 25,
+    REPLAY_COMMAND_MONUMENT_ADD_MODULE = 26,
+    REPLAY_COMMAND_DISTRIBUTION_TOGGLE_GOOD_ACCEPTED = 27,
+    REPLAY_COMMAND_DISTRIBUTION_ACCEPT_ALL_GOODS = 28,
+    REPLAY_COMMAND_DISTRIBUTION_UNACCEPT_ALL_GOODS = 29,
+    REPLAY_COMMAND_BARRACKS_SET_PRIORITY = 30,
+    REPLAY_COMMAND_BARRACKS_TOGGLE_DELIVERY = 31,
+    REPLAY_COMMAND_DATA_TRANSFER_COPY = 32,
+    REPLAY_COMMAND_DATA_TRANSFER_PASTE = 33,
+    REPLAY_COMMAND_DOCK_SET_CAN_TRADE_WITH_ROUTE = 34,
+    REPLAY_COMMAND_DEPOT_ORDER = 35,
+    REPLAY_COMMAND_DEPOT_RECALL = 36,
+    REPLAY_COMMAND_CITY_MINT_SWITCH_OUTPUT = 37,
+    // City settings
+    REPLAY_COMMAND_RESOURCE_TOGGLE_STOCKPILED = 38,
+    REPLAY_COMMAND_RESOURCE_TOGGLE_MOTHBALLED = 39,
+    REPLAY_COMMAND_RESOURCE_CHANGE_IMPORT_OVER = 40,
+    REPLAY_COMMAND_RESOURCE_CHANGE_EXPORT_OVER = 41,
+    REPLAY_COMMAND_RESOURCE_CYCLE_TRADE_STATUS = 42,
+    REPLAY_COMMAND_TRADE_POLICY_SET = 43,
+    REPLAY_COMMAND_LABOR_SET_PRIORITY = 44,
+    REPLAY_COMMAND_FESTIVAL_SCHEDULE = 45,
+    REPLAY_COMMAND_GAMES_SCHEDULE = 46,
+    REPLAY_COMMAND_EMPEROR_SEND_GIFT = 47,
+    REPLAY_COMMAND_EMPEROR_SET_SALARY_RANK = 48,
+    REPLAY_COMMAND_EMPEROR_DONATE_SAVINGS = 49,
+    REPLAY_COMMAND_REQUEST_DISPATCH = 50,
+    REPLAY_COMMAND_EMPIRE_OPEN_TRADE = 51,
+    REPLAY_COMMAND_VICTORY_CONTINUE_GOVERNING = 52,
+    REPLAY_COMMAND_VICTORY_STOP_GOVERNING = 53,
+    // Game settings
+    REPLAY_COMMAND_CONFIG_CHANGE = 54,
+    REPLAY_COMMAND_DIFFICULTY_CHANGE = 55,
+    REPLAY_COMMAND_GODS_ENABLED_CHANGE = 56
+} replay_command_type;
+
+/**
+ * Starts recording a replay. The starting save is written next to the replay file.
+ * @param name Name of the replay, without extension
+ * @param with_state_hashes Whether to store a hash of the game state every day
+ * @return 1 if recording started, 0 otherwise
+ */
+int game_replay_start_recording(const char *name, int with_state_hashes);
+
+/**
+ * Loads the starting save of a replay and starts playing back its commands
+ * @param name Name of the replay, without extension
+ * @return 1 if playback started, 0 otherwise
+ */
+int game_replay_start_playback(const char *name);
+
+/**
+ * Stops recording or playback. A recording is written to disk.
+ */
+void game_replay_stop(void);
+
+int game_replay_is_recording(void);
+
+int game_replay_is_playing(void);
+
+/**
+ * Gets the number of days whose state hash did not match the recording during the current playback
+ */
+int game_replay_hash_mismatches(void);
+
+/**
+ * Calculates a hash over the building, figure and map state
+ * @param hash The hash to continue from
+ * @return The new hash
+ */
+uint32_t game_replay_state_hash(uint32_t hash);
+
+void game_replay_record_construction(building_type type, int x_start, int y_start, int x_end, int y_end);
+
+void game_replay_record_tax_change(int change);
+
+void game_replay_record_wages_change(int change);
+
+void game_replay_record_map_rotation(int direction);
+
+void game_replay_record_undo(void);
+
+/**
+ * Records a player command that only needs a few numbers to be repeated.
+ * Commands issued while a tick runs come from the simulation itself and are ignored.
+ * @param type The command
+ * @param arg1 The first argument, see replay_command_type
+ * @param arg2 The second argument, or 0
+ * @param arg3 The third argument, or 0
+ */
+void game_replay_record_command(replay_command_type type, int arg1, int arg2, int arg3);
+
+/**
+ * Records a change to the current order of a depot
+ * @param b The depot, after its order was changed
+ */
+void game_replay_record_depot_order(const building *b);
+
+/**
+ * Plays back a replay as fast as possible without drawing the city, then logs the time it took.
+ * Meant to be used instead of the main loop, as a repeatable workload for benchmarks.
+ * @param name Name of the replay, without extension
+ * @return 1 if the whole replay was played back and its state matched the recording every day, 0 otherwise
+ */
+int game_replay_run_headless(const char *name);
+
+/**
+ * Must be called before every game tick: applies the commands due during playback
+ */
+void game_replay_before_tick(void);
+
+/**
+ * Must be called after every game tick: counts the tick and handles the daily state hash
+ */
+void game_replay_after_tick(void);
+
+#endif // GAME_REPLAY_H
@@ -0,0 +1,429 @@
+#include "saved_game_index.h"
+
+#include "core/array.h"
+#include "core/buffer.h"
+#include "core/dir.h"
+#include "core/file.h"
+#include "core/io.h"
+#include "core/log.h"
+#include "core/zlib_helper.h"
+#include "map/grid.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INDEX_FILENAME "saved_games.idx"
+#define INDEX_MAGIC 0x58444953
+#define INDEX_VERSION 2
+#define INDEX_HEADER_SIZE (3 * sizeof(int32_t))
+#define INDEX_INFO_SIZE (31 * sizeof(int32_t) + MAX_SCENARIO_NAME + FILE_NAME_MAX + MAX_BRIEF_DESCRIPTION)
+#define INDEX_ENTRY_SIZE (FILE_NAME_MAX + 6 * sizeof(int32_t) + INDEX_INFO_SIZE)
+#define INDEX_ARRAY_SIZE_STEP 64
+#define THUMBNAIL_SCALE 2
+
+static struct {
+    array(saved_game_index_entry) entries;
+    char filename[FILE_NAME_MAX];
+    int loaded;
+    int changed;
+} data;
+
+static int entry_in_use(const saved_game_index_entry *entry)
+{
+    return entry->name != 0;
+}
+
+static void free_entry(saved_game_index_entry *entry)
+{
+    free(entry->name);
+    free(entry->minimap);
+    memset(entry, 0, sizeof(saved_game_index_entry));
+}
+
+static void clear_entries(void)
+{
+    saved_game_index_entry *entry;
+    array_foreach(data.entries, entry) {
+        free_entry(entry);
+    }
+    if (!array_init(data.entries, INDEX_ARRAY_SIZE_STEP, 0, entry_in_use)) {
+        log_error("Unable to allocate memory for the saved games index", 0, 0);
+    }
+}
+
+static void write_criteria(buffer *buf, const struct win_criteria_t *criteria)
+{
+    buffer_write_i32(buf, criteria->enabled);
+    buffer_write_i32(buf, criteria->goal);
+}
+
+static void read_criteria(buffer *buf, struct win_criteria_t *criteria)
+{
+    criteria->enabled = buffer_read_i32(buf);
+    criteria->goal = buffer_read_i32(buf);
+}
+
+static void write_info(buffer *buf, const saved_game_info *info)
+{
+    buffer_write_i32(buf, info->origin.mission);
+    buffer_write_raw(buf, info->origin.scenario_name, MAX_SCENARIO_NAME);
+    buffer_write_raw(buf, info->origin.campaign_name, FILE_NAME_MAX);
+    buffer_write_i32(buf, info->origin.type);
+    buffer_write_i32(buf, info->treasury);
+    buffer_write_i32(buf, info->population);
+    buffer_write_i32(buf, info->month);
+    buffer_write_i32(buf, info->year);
+    buffer_write_raw(buf, info->description, MAX_BRIEF_DESCRIPTION);
+    buffer_write_i32(buf, info->image_id);
+    buffer_write_i32(buf, info->start_year);
+    buffer_write_i32(buf, info->climate);
+    buffer_write_i32(buf, info->map_size);
+    buffer_write_i32(buf, info->total_invasions);
+    buffer_write_i32(buf, info->player_rank);
+    buffer_write_i32(buf, info->is_open_play);
+    buffer_write_i32(buf, info->open_play_id);
+    write_criteria(buf, &info->win_criteria.population);
+    write_criteria(buf, &info->win_criteria.culture);
+    write_criteria(buf, &info->win_criteria.prosperity);
+    write_criteria(buf, &info->win_criteria.peace);
+    write_criteria(buf, &info->win_criteria.favor);
+    buffer_write_i32(buf, info->win_criteria.time_limit.enabled);
+    buffer_write_i32(buf, info->win_criteria.time_limit.years);
+    buffer_write_i32(buf, info->win_criteria.survival_time.enabled);
+    buffer_write_i32(buf, info->win_criteria.survival_time.years);
+    buffer_write_i32(buf, info->win_criteria.milestone25_year);
+    buffer_write_i32(buf, info->win_criteria.milestone50_year);
+    buffer_write_i32(buf, info->win_criteria.milestone75_year);
+}
+
+static void read_info(buffer *buf, saved_game_info *info)
+{
+    info->origin.mission = buffer_read_i32(buf);
+    buffer_read_raw(buf, info->origin.scenario_name, MAX_SCENARIO_NAME);
+    info->origin.scenario_name[MAX_SCENARIO_NAME - 1] = 0;
+    buffer_read_raw(buf, info->origin.campaign_name, FILE_NAME_MAX);
+    info->origin.campaign_name[FILE_NAME_MAX - 1] = 0;
+    info->origin.type = buffer_read_i32(buf);
+    info->treasury = buffer_read_i32(buf);
+    info->population = buffer_read_i32(buf);
+    info->month = buffer_read_i32(buf);
+    info->year = buffer_read_i32(buf);
+    buffer_read_raw(buf, info->description, MAX_BRIEF_DESCRIPTION);
+    info->image_id = buffer_read_i32(buf);
+    info->start_year = buffer_read_i32(buf);
+    info->climate = buffer_read_i32(buf);
+    info->map_size = buffer_read_i32(buf);
+    info->total_invasions = buffer_read_i32(buf);
+    info->player_rank = buffer_read_i32(buf);
+    info->is_open_play = buffer_read_i32(buf);
+    info->open_play_id = buffer_read_i32(buf);
+    read_criteria(buf, &info->win_criteria.population);
+    read_criteria(buf, &info->win_criteria.culture);
+    read_criteria(buf, &info->win_criteria.prosperity);
+    read_criteria(buf, &info->win_criteria.peace);
+    read_criteria(buf, &info->win_criteria.favor);
+    info->win_criteria.time_limit.enabled = buffer_read_i32(buf);
+    info->win_criteria.time_limit.years = buffer_read_i32(buf);
+    info->win_criteria.survival_time.enabled = buffer_read_i32(buf);
+    info->win_criteria.survival_time.years = buffer_read_i32(buf);
+    info->win_criteria.milestone25_year = buffer_read_i32(buf);
+    info->win_criteria.milestone50_year = buffer_read_i32(buf);
+    info->win_criteria.milestone75_year = buffer_read_i32(buf);
+}
+
+static char *copy_name(const char *name)
+{
+    size_t length = strlen(name) + 1;
+    char *copy = malloc(length);
+    if (copy) {
+        memcpy(copy, name, length);
+    }
+    return copy;
+}
+
+static int read_entry(buffer *buf, saved_game_index_entry *entry)
+{
+    char name[FILE_NAME_MAX];
+    buffer_read_raw(buf, name, FILE_NAME_MAX);
+    name[FILE_NAME_MAX - 1] = 0;
+    entry->modified_time = buffer_read_u32(buf);
+    entry->file_size = buffer_read_i32(buf);
+    read_info(buf, &entry->info);
+    entry->city_height = buffer_read_i32(buf);
+    entry->minimap_width = buffer_read_i32(buf);
+    entry->minimap_height = buffer_read_i32(buf);
+    entry->minimap_size = buffer_read_i32(buf);
+    if (buf->overflow || entry->minimap_width <= 0 || entry->minimap_height <= 0 ||
+        entry->minimap_width > GRID_SIZE * 2 || entry->minimap_height > GRID_SIZE * 2 ||
+        entry->minimap_size <= 0 || entry->minimap_size > (int) (buf->size - buf->index)) {
+        return 0;
+    }
+    entry->minimap = malloc(entry->minimap_size);
+    entry->name = copy_name(name);
+    if (!entry->minimap || !entry->name) {
+        free_entry(entry);
+        return 0;
+    }
+    buffer_read_raw(buf, entry->minimap, entry->minimap_size);
+    return 1;
+}
+
+static uint8_t *read_file(const char *filename, int *size)
+{
+    FILE *fp = file_open(filename, "rb");
+    if (!fp) {
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long file_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *contents = file_size > 0 ? malloc(file_size) : 0;
+    if (contents && fread(contents, 1, file_size, fp) != (size_t) file_size) {
+        free(contents);
+        contents = 0;
+    }
+    file_close(fp);
+    *size = (int) file_size;
+    return contents;
+}
+
+static void read_index(void)
+{
+    int size = 0;
+    uint8_t *contents = read_file(data.filename, &size);
+    if (!contents) {
+        return;
+    }
+    buffer buf;
+    buffer_init(&buf, contents, size);
+    int num_entries = 0;
+    if (size >= (int) INDEX_HEADER_SIZE && buffer_read_u32(&buf) == INDEX_MAGIC &&
+        buffer_read_i32(&buf) == INDEX_VERSION) {
+        num_entries = buffer_read_i32(&buf);
+    } else {
+        log_info("Saved games index has an old version and will be rebuilt", 0, 0);
+    }
+    for (int i = 0; i < num_entries; i++) {
+        saved_game_index_entry *entry;
+        array_new_item(data.entries, entry);
+        if (!entry || !read_entry(&buf, entry)) {
+            log_error("Saved games index is invalid and will be rebuilt", data.filename, 0);
+            clear_entries();
+            break;
+        }
+    }
+    free(contents);
+}
+
+static void load_index(void)
+{
+    const char *filename = dir_append_location(INDEX_FILENAME, PATH_LOCATION_SAVEGAME);
+    if (data.loaded && strcmp(filename, data.filename) == 0) {
+        return;
+    }
+    // The saved games directory has changed, so keep what was indexed for the old one
+    game_saved_game_index_write();
+    snprintf(data.filename, FILE_NAME_MAX, "%s", filename);
+    data.loaded = 1;
+    data.changed = 0;
+    clear_entries();
+    read_index();
+}
+
+static saved_game_index_entry *find_entry(const char *name)
+{
+    saved_game_index_entry *entry;
+    array_foreach(data.entries, entry) {
+        if (entry->name && strcmp(entry->name, name) == 0) {
+            return entry;
+        }
+    }
+    return 0;
+}
+
+const saved_game_index_entry *game_saved_game_index_get(const char *filename, unsigned int modified_time,
+    int file_size)
+{
+    load_index();
+    const saved_game_index_entry *entry = find_entry(file_remove_path(filename));
+    if (!entry || entry->modified_time != modified_time || entry->file_size != file_size) {
+        return 0;
+    }
+    return entry;
+}
+
+static int thumbnail_size(int size)
+{
+    return (size + THUMBNAIL_SCALE - 1) / THUMBNAIL_SCALE;
+}
+
+static color_t thumbnail_pixel(const color_t *minimap, int width, int height, int x, int y)
+{
+    uint32_t channels[4] = { 0 };
+    int count = 0;
+    for (int yy = y * THUMBNAIL_SCALE; yy < (y + 1) * THUMBNAIL_SCALE && yy < height; yy++) {
+        for (int xx = x * THUMBNAIL_SCALE; xx < (x + 1) * THUMBNAIL_SCALE && xx < width; xx++) {
+            color_t color = minimap[yy * width + xx];
+            for (int c = 0; c < 4; c++) {
+                channels[c] += (color >> (8 * c)) & 0xff;
+            }
+            count++;
+        }
+    }
+    color_t result = 0;
+    for (int c = 0; c < 4; c++) {
+        result |= (channels[c] / count) << (8 * c);
+    }
+    return result;
+}
+
+static color_t *create_thumbnail(const color_t *minimap, int width, int height)
+{
+    int thumbnail_width = thumbnail_size(width);
+    int thumbnail_height = thumbnail_size(height);
+    color_t *thumbnail = malloc(sizeof(color_t) * thumbnail_width * thumbnail_height);
+    if (!thumbnail) {
+        return 0;
+    }
+    for (int y = 0; y < thumbnail_height; y++) {
+        for (int x = 0; x < thumbnail_width; x++) {
+            thumbnail[y * thumbnail_width + x] = thumbnail_pixel(minimap, width, height, x, y);
+        }
+    }
+    return thumbnail;
+}
+
+int game_saved_game_index_read_minimap(const saved_game_index_entry *entry, color_t *pixels)
+{
+    int thumbnail_width = thumbnail_size(entry->minimap_width);
+    int thumbnail_height = thumbnail_size(entry->minimap_height);
+    int thumbnail_pixels_size = thumbnail_width * thumbnail_height * sizeof(color_t);
+    color_t *thumbnail = malloc(thumbnail_pixels_size);
+    int output_size;
+    if (!thumbnail ||
+        !zlib_helper_decompress(entry->minimap, entry->minimap_size, thumbnail, thumbnail_pixels_size, &output_size) ||
+        output_size != thumbnail_pixels_size) {
+        free(thumbnail);
+        return 0;
+    }
+    for (int y = 0; y < entry->minimap_height; y++) {
+        const color_t *thumbnail_row = &thumbnail[(y / THUMBNAIL_SCALE) * thumbnail_width];
+        for (int x = 0; x < entry->minimap_width; x++) {
+            pixels[y * entry->minimap_width + x] = thumbnail_row[x / THUMBNAIL_SCALE];
+        }
+    }
+    free(thumbnail);
+    return 1;
+}
+
+void game_saved_game_index_add(const char *filename, unsigned int modified_time, int file_size,
+    const saved_game_info *info, int city_height, const color_t *minimap, int minimap_width, int minimap_height)
+{
+    load_index();
+    const char *name = file_remove_path(filename);
+    if (strlen(name) >= FILE_NAME_MAX) {
+        return;
+    }
+    // Only a thumbnail is kept, as the full minimap of every saved game would make the index needlessly large
+    color_t *thumbnail = create_thumbnail(minimap, minimap_width, minimap_height);
+    int pixels_size = thumbnail_size(minimap_width) * thumbnail_size(minimap_height) * sizeof(color_t);
+    uint8_t *compressed = malloc(pixels_size);
+    int compressed_size;
+    // The minimap is mostly flat colours, so it is not stored if it doesn't compress
+    if (!thumbnail || !compressed ||
+        !zlib_helper_compress(thumbnail, pixels_size, compressed, pixels_size, &compressed_size)) {
+        free(thumbnail);
+        free(compressed);
+        return;
+    }
+    free(thumbnail);
+    uint8_t *minimap_data = realloc(compressed, compressed_size);
+    if (minimap_data) {
+        compressed = minimap_data;
+    }
+    saved_game_index_entry *entry = find_entry(name);
+    if (entry) {
+        free_entry(entry);
+    } else {
+        array_new_item(data.entries, entry);
+    }
+    if (entry) {
+        entry->name = copy_name(name);
+    }
+    if (!entry || !entry->name) {
+        free(compressed);
+        return;
+    }
+    entry->modified_time = modified_time;
+    entry->file_size = file_size;
+    entry->info = *info;
+    entry->city_height = city_height;
+    entry->minimap_width = minimap_width;
+    entry->minimap_height = minimap_height;
+    entry->minimap = compressed;
+    entry->minimap_size = compressed_size;
+    data.changed = 1;
+}
+
+void game_saved_game_index_remove(const char *filename)
+{
+    // Saved games written when the index is not loaded are caught by their new modification time and size
+    if (!data.loaded) {
+        return;
+    }
+    saved_game_index_entry *entry = find_entry(file_remove_path(filename));
+    if (entry) {
+        free_entry(entry);
+        array_trim(data.entries);
+        data.changed = 1;
+    }
+}
+
+void game_saved_game_index_write(void)
+{
+    if (!data.loaded || !data.changed) {
+        return;
+    }
+    int num_entries = 0;
+    int size = INDEX_HEADER_SIZE;
+    const saved_game_index_entry *entry;
+    array_foreach(data.entries, entry) {
+        if (entry->name) {
+            num_entries++;
+            size += INDEX_ENTRY_SIZE + entry->minimap_size;
+        }
+    }
+    uint8_t *buf_data = malloc(size);
+    if (!buf_data) {
+        log_error("Unable to allocate memory to write the saved games index", 0, 0);
+        return;
+    }
+    buffer buf;
+    buffer_init(&buf, buf_data, size);
+    buffer_write_u32(&buf, INDEX_MAGIC);
+    buffer_write_i32(&buf, INDEX_VERSION);
+    buffer_write_i32(&buf, num_entries);
+    array_foreach(data.entries, entry) {
+        if (!entry->name) {
+            continue;
+        }
+        char name[FILE_NAME_MAX] = { 0 };
+        snprintf(name, FILE_NAME_MAX, "%s", entry->name);
+        buffer_write_raw(&buf, name, FILE_NAME_MAX);
+        buffer_write_u32(&buf, entry->modified_time);
+        buffer_write_i32(&buf, entry->file_size);
+        write_info(&buf, &entry->info);
+        buffer_write_i32(&buf, entry->city_height);
+        buffer_write_i32(&buf, entry->minimap_width);
+        buffer_write_i32(&buf, entry->minimap_height);
+        buffer_write_i32(&buf, entry->minimap_size);
+        buffer_write_raw(&buf, entry->minimap, entry->minimap_size);
+    }
+    if (io_write_buffer_to_file(data.filename, buf_data, size) != size) {
+        log_error("Unable to write the saved games index", data.filename, 0);
+    } else {
+        data.changed = 0;
+    }
+    free(buf_data);
+}
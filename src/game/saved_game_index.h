@@ -0,0 +1,74 @@
+#ifndef GAME_SAVED_GAME_INDEX_H
+#define GAME_SAVED_GAME_INDEX_H
+
+#include "game/file_io.h"
+#include "graphics/color.h"
+
+#include <stdint.h>
+
+/**
+ * @file
+ * Index of the info and minimap of the saved games, so they can be shown without reading the saved games.
+ *
+ * Minimaps are stored as thumbnails of half their size, and scaled back up when read.
+ * An entry is only used while the modification time and size of its saved game are unchanged.
+ * Entries are removed when the saved game is written or deleted.
+ * The index is stored as a single file in the saved games directory.
+ */
+
+typedef struct {
+    char *name;
+    unsigned int modified_time;
+    int file_size;
+    saved_game_info info;
+    int city_height;
+    int minimap_width;
+    int minimap_height;
+    uint8_t *minimap; /**< Compressed minimap thumbnail */
+    int minimap_size; /**< Size of the compressed minimap thumbnail */
+} saved_game_index_entry;
+
+/**
+ * Gets the index entry of a saved game
+ * @param filename The saved game file
+ * @param modified_time The modification time of the saved game
+ * @param file_size The size of the saved game
+ * @return The entry, or 0 if the saved game is not indexed or has changed since
+ */
+const saved_game_index_entry *game_saved_game_index_get(const char *filename, unsigned int modified_time,
+    int file_size);
+
+/**
+ * Decompresses the minimap thumbnail of an index entry, scaled up to the size of the minimap
+ * @param entry The entry
+ * @param pixels Buffer of entry->minimap_width * entry->minimap_height pixels
+ * @return 1 on success, 0 otherwise
+ */
+int game_saved_game_index_read_minimap(const saved_game_index_entry *entry, color_t *pixels);
+
+/**
+ * Adds a saved game to the index, replacing its previous entry
+ * @param filename The saved game file
+ * @param modified_time The modification time of the saved game
+ * @param file_size The size of the saved game
+ * @param info The saved game info
+ * @param city_height The height of the city, which with info->map_size gives the size of the minimap
+ * @param minimap The minimap image
+ * @param minimap_width The width of the minimap image
+ * @param minimap_height The height of the minimap image
+ */
+void game_saved_game_index_add(const char *filename, unsigned int modified_time, int file_size,
+    const saved_game_info *info, int city_height, const color_t *minimap, int minimap_width, int minimap_height);
+
+/**
+ * Removes a saved game from the index
+ * @param filename The saved game file
+ */
+void game_saved_game_index_remove(const char *filename);
+
+/**
+ * Writes the index to disk, if it has changed since it was read
+ */
+void game_saved_game_index_write(void);
+
+#endif // GAME_SAVED_GAME_INDEX_H
@@ -4,6 +4,7 @@
 #include "core/time.h"
 #include "game/settings.h"
 #include "game/state.h"
+#include "game/time.h"
 #include "graphics/window.h"
 #include "input/scroll.h"
 
@@ -19,6 +20,11 @@ static const time_millis MILLIS_PER_HYPER_SPEED[] = {
 static struct {
     int last_check_was_valid;
     time_millis last_update;
+    struct {
+        int ticks_total;
+        int ticks_done;
+        int stop_events;
+    } fast_forward;
 } data;
 
 int game_speed_get_elapsed_ticks(void)
@@ -81,3 +87,49 @@ int game_speed_get_elapsed_ticks(void)
         return MAX_TICKS_PER_FRAME;
     }
 }
+
+void game_speed_fast_forward_start(int days, int stop_events)
+{
+    data.fast_forward.ticks_total = days > 0 ? days * GAME_TIME_TICKS_PER_DAY : 0;
+    data.fast_forward.ticks_done = 0;
+    data.fast_forward.stop_events = stop_events;
+}
+
+void game_speed_fast_forward_stop(void)
+{
+    data.fast_forward.ticks_total = 0;
+    data.fast_forward.ticks_done = 0;
+    // returning to normal speed: don't try to catch up on the time spent skipping
+    data.last_check_was_valid = 0;
+}
+
+void game_speed_fast_forward_notify(fast_forward_stop_event event)
+{
+    if (game_speed_fast_forward_is_active() && (data.fast_forward.stop_events & event)) {
+        game_speed_fast_forward_stop();
+    }
+}
+
+int game_speed_fast_forward_is_active(void)
+{
+    return data.fast_forward.ticks_done < data.fast_forward.ticks_total;
+}
+
+void game_speed_fast_forward_tick_done(void)
+{
+    if (!game_speed_fast_forward_is_active()) {
+        return;
+    }
+    data.fast_forward.ticks_done++;
+    if (data.fast_forward.ticks_done >= data.fast_forward.ticks_total) {
+        game_speed_fast_forward_stop();
+    }
+}
+
+int game_speed_fast_forward_progress(int *total_days)
+{
+    if (total_days) {
+        *total_days = data.fast_forward.ticks_total / GAME_TIME_TICKS_PER_DAY;
+    }
+    return data.fast_forward.ticks_done / GAME_TIME_TICKS_PER_DAY;
+}
@@ -1,6 +1,50 @@
 #ifndef GAME_SPEED_H
 #define GAME_SPEED_H
 
+typedef enum {
+    FAST_FORWARD_STOP_NEVER = 0,
+    FAST_FORWARD_STOP_ON_INVASION = 1,
+    FAST_FORWARD_STOP_ON_REQUEST = 2,
+    FAST_FORWARD_STOP_ON_VICTORY = 4, // mission won or lost
+    FAST_FORWARD_STOP_ON_ALL = 7
+} fast_forward_stop_event;
+
 int game_speed_get_elapsed_ticks(void);
 
+/**
+ * Starts running the simulation without frame pacing for the given number of days
+ * @param days The number of game days to skip
+ * @param stop_events Combination of fast_forward_stop_event flags that end the skip early
+ */
+void game_speed_fast_forward_start(int days, int stop_events);
+
+/**
+ * Stops a running fast forward
+ */
+void game_speed_fast_forward_stop(void);
+
+/**
+ * Reports an event that may end a running fast forward, depending on its stop events
+ * @param event The event that happened
+ */
+void game_speed_fast_forward_notify(fast_forward_stop_event event);
+
+/**
+ * Whether a fast forward is running
+ * @return True if ticks should be run back-to-back
+ */
+int game_speed_fast_forward_is_active(void);
+
+/**
+ * Marks one tick of the fast forward as run, stopping it once all requested days have passed
+ */
+void game_speed_fast_forward_tick_done(void);
+
+/**
+ * Progress of the running fast forward
+ * @param total_days Set to the number of days requested
+ * @return The number of days already skipped
+ */
+int game_speed_fast_forward_progress(int *total_days);
+
 #endif // GAME_SPEED_H
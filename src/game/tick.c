@@ -33,12 +33,14 @@
 #include "city/victory.h"
 #include "core/config.h"
 #include "core/dir.h"
+#include "core/memory.h"
 #include "core/random.h"
 #include "editor/editor.h"
 #include "empire/city.h"
 #include "figure/formation.h"
 #include "figuretype/crime.h"
 #include "game/file.h"
+#include "game/replay.h"
 #include "game/settings.h"
 #include "game/time.h"
 #include "game/tutorial.h"
@@ -202,6 +204,8 @@ void game_tick_run(void)
         figure_action_handle(); // just update the flag figures
         return;
     }
+    core_memory_start_tick();
+    game_replay_before_tick();
     random_generate_next();
     game_undo_reduce_time_available();
     advance_tick();
@@ -210,6 +214,7 @@ void game_tick_run(void)
     scenario_gladiator_revolt_process();
     scenario_emperor_change_process();
     city_victory_check();
+    game_replay_after_tick();
 }
 
 void game_tick_cheat_year(void)
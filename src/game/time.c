@@ -72,6 +72,11 @@ void game_time_advance_year(void)
     ++data.year;
 }
 
+int game_time_total_days(void)
+{
+    return data.total_days;
+}
+
 int game_time_total_months(void)
 {
     return data.total_days / GAME_TIME_DAYS_PER_MONTH;
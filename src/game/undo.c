@@ -15,6 +15,7 @@
 #include "core/calc.h"
 #include "core/image.h"
 #include "figure/roamer_preview.h"
+#include "game/replay.h"
 #include "game/resource.h"
 #include "graphics/window.h"
 #include "map/aqueduct.h"
@@ -208,6 +209,7 @@ static void add_building_to_terrain(building *b)
 
 void game_undo_perform(void)
 {
+    game_replay_record_undo();
     if (!game_can_undo()) {
         return;
     }
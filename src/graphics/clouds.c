@@ -6,9 +6,11 @@
 #include "core/speed.h"
 #include "game/settings.h"
 #include "graphics/renderer.h"
+#include "platform/thread_pool.h"
 
 #include <math.h>
-#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
 
 #define NUM_CLOUD_ELLIPSES 180
 #define CLOUD_ALPHA_INCREASE 16
@@ -25,6 +27,7 @@
 #define CLOUD_ROWS 4
 #define CLOUD_COLUMNS 4
 #define NUM_CLOUDS (CLOUD_ROWS * CLOUD_COLUMNS)
+#define NUM_CLOUD_PATTERNS NUM_CLOUDS
 
 #define CLOUD_TEXTURE_WIDTH (CLOUD_WIDTH * CLOUD_COLUMNS)
 #define CLOUD_TEXTURE_HEIGHT (CLOUD_HEIGHT * CLOUD_ROWS)
@@ -55,7 +58,7 @@ typedef struct {
 } ellipse;
 
 typedef struct {
-    image img;
+    const image *img;
     int x;
     int y;
     cloud_status status;
@@ -69,26 +72,53 @@ typedef struct {
     int angle;
 } cloud_type;
 
+// Each pattern is generated with its own random generator, so the patterns can be generated in parallel
+typedef struct {
+    uint32_t state;
+} pattern_random;
+
 static struct {
     cloud_type clouds[NUM_CLOUDS];
+    image patterns[NUM_CLOUD_PATTERNS];
     int movement_timeout;
     int pause_frames;
 } data;
 
+static uint32_t pattern_random_next(pattern_random *r)
+{
+    // xorshift32
+    r->state ^= r->state << 13;
+    r->state ^= r->state >> 17;
+    r->state ^= r->state << 5;
+    return r->state;
+}
+
+static double pattern_random_fractional(pattern_random *r)
+{
+    return (pattern_random_next(r) >> 8) / (double) (1 << 24);
+}
+
+static int pattern_random_from_min_to_range(pattern_random *r, int min, int range)
+{
+    return range > 0 ? min + (int) (pattern_random_next(r) % range) : min;
+}
+
 static int random_from_min_to_range(int min, int range)
 {
     return min + random_between_from_stdlib(0, range);
 }
 
-static void position_ellipse(ellipse *e, int cloud_width, int cloud_height)
+static void position_ellipse(ellipse *e, pattern_random *r, int cloud_width, int cloud_height)
 {
-    double angle = random_fractional_from_stdlib() * PI * 2;
+    double angle = pattern_random_fractional(r) * PI * 2;
 
-    e->x = (int) (CLOUD_WIDTH / 2 + random_fractional_from_stdlib() * cloud_width * cos(angle));
-    e->y = (int) (CLOUD_HEIGHT / 2 + random_fractional_from_stdlib() * cloud_height * sin(angle));
+    e->x = (int) (CLOUD_WIDTH / 2 + pattern_random_fractional(r) * cloud_width * cos(angle));
+    e->y = (int) (CLOUD_HEIGHT / 2 + pattern_random_fractional(r) * cloud_height * sin(angle));
 
-    e->width = random_from_min_to_range((int) (CLOUD_WIDTH * CLOUD_SIZE_RATIO), (int) (CLOUD_WIDTH * CLOUD_SIZE_RATIO));
-    e->height = random_from_min_to_range((int) (CLOUD_HEIGHT * CLOUD_SIZE_RATIO), (int) (CLOUD_HEIGHT * CLOUD_SIZE_RATIO));
+    e->width = pattern_random_from_min_to_range(r,
+        (int) (CLOUD_WIDTH * CLOUD_SIZE_RATIO), (int) (CLOUD_WIDTH * CLOUD_SIZE_RATIO));
+    e->height = pattern_random_from_min_to_range(r,
+        (int) (CLOUD_HEIGHT * CLOUD_SIZE_RATIO), (int) (CLOUD_HEIGHT * CLOUD_SIZE_RATIO));
 
     e->half_width = e->width / 2;
     e->half_height = e->height / 2;
@@ -109,7 +139,7 @@ static int ellipse_is_inside_bounds(const ellipse *e)
 
 static void darken_pixel(color_t *cloud, int x, int y)
 {
-    int pixel = y * CLOUD_WIDTH + x;
+    int pixel = y * CLOUD_TEXTURE_WIDTH + x;
 
     color_t alpha = cloud[pixel] >> COLOR_BITSHIFT_ALPHA;
     int darken = CLOUD_ALPHA_INCREASE >> (alpha >> 4);
@@ -123,11 +153,11 @@ static void darken_pixel(color_t *cloud, int x, int y)
     cloud[pixel] = ALPHA_TRANSPARENT | (alpha << COLOR_BITSHIFT_ALPHA);
 }
 
-static void generate_cloud_ellipse(color_t *cloud, int width, int height)
+static void generate_cloud_ellipse(color_t *cloud, pattern_random *r, int width, int height)
 {
     ellipse e;
     do {
-        position_ellipse(&e, width, height);
+        position_ellipse(&e, r, width, height);
     } while (!ellipse_is_inside_bounds(&e));
 
     // Do the entire diameter
@@ -163,48 +193,75 @@ static void generate_cloud_ellipse(color_t *cloud, int width, int height)
     }
 }
 
-static void init_cloud_images(void)
+typedef struct {
+    color_t *pixels;
+    uint32_t seeds[NUM_CLOUD_PATTERNS];
+} pattern_generation;
+
+static void generate_pattern(int index, int worker, void *userdata)
+{
+    pattern_generation *generation = userdata;
+    pattern_random r = { generation->seeds[index] };
+    const image *img = &data.patterns[index];
+    color_t *pixels = &generation->pixels[img->atlas.y_offset * CLOUD_TEXTURE_WIDTH + img->atlas.x_offset];
+
+    int width = pattern_random_from_min_to_range(&r, (int) (CLOUD_WIDTH * 0.15f), (int) (CLOUD_WIDTH * 0.2f));
+    int height = pattern_random_from_min_to_range(&r, (int) (CLOUD_HEIGHT * 0.15f), (int) (CLOUD_HEIGHT * 0.2f));
+
+    for (int i = 0; i < NUM_CLOUD_ELLIPSES; i++) {
+        generate_cloud_ellipse(pixels, &r, width, height);
+    }
+}
+
+static void reset_cloud(cloud_type *cloud)
 {
+    cloud->img = 0;
+    cloud->x = 0;
+    cloud->y = 0;
+    cloud->side = 0;
+    cloud->angle = 0;
+    cloud->status = STATUS_INACTIVE;
+    speed_clear(&cloud->speed.x);
+    speed_clear(&cloud->speed.y);
+}
+
+// All cloud patterns are generated once and uploaded together. Clouds then only pick a pattern and
+// give it a new scale and rotation, so no pixels need to be generated while the city is shown.
+static int init_cloud_images(void)
+{
+    color_t *pixels = calloc(CLOUD_TEXTURE_WIDTH * CLOUD_TEXTURE_HEIGHT, sizeof(color_t));
+    if (!pixels) {
+        return 0;
+    }
     graphics_renderer()->create_custom_image(CUSTOM_IMAGE_CLOUDS, CLOUD_TEXTURE_WIDTH, CLOUD_TEXTURE_HEIGHT, 0);
-    for (int i = 0; i < NUM_CLOUDS; i++) {
-        cloud_type *cloud = &data.clouds[i];
-        image *img = &cloud->img;
+
+    pattern_generation generation;
+    generation.pixels = pixels;
+    for (int i = 0; i < NUM_CLOUD_PATTERNS; i++) {
+        image *img = &data.patterns[i];
         img->width = img->original.width = CLOUD_WIDTH;
         img->height = img->original.height = CLOUD_HEIGHT;
         img->atlas.id = (ATLAS_CUSTOM << IMAGE_ATLAS_BIT_OFFSET) | CUSTOM_IMAGE_CLOUDS;
         img->atlas.x_offset = (i % CLOUD_COLUMNS) * CLOUD_WIDTH;
         img->atlas.y_offset = (i / CLOUD_COLUMNS) * CLOUD_HEIGHT;
-        cloud->x = 0;
-        cloud->y = 0;
-        cloud->side = 0;
-        cloud->angle = 0;
-        cloud->status = STATUS_INACTIVE;
-        speed_clear(&cloud->speed.x);
-        speed_clear(&cloud->speed.y);
+        // xorshift never leaves a zero state, so make sure the seed is never zero
+        generation.seeds[i] = ((uint32_t) random_from_stdlib() << 1) | 1;
     }
-}
+    platform_thread_pool_run(NUM_CLOUD_PATTERNS, generate_pattern, &generation);
 
-static void generate_cloud(cloud_type *cloud)
-{
-    if (!graphics_renderer()->has_custom_image(CUSTOM_IMAGE_CLOUDS)) {
-        init_cloud_images();
-    }
-
-    color_t pixels[CLOUD_WIDTH * CLOUD_HEIGHT];
-    memset(pixels, 0, sizeof(color_t) * CLOUD_WIDTH * CLOUD_HEIGHT);
-
-    int width = random_from_min_to_range((int) (CLOUD_WIDTH * 0.15f), (int) (CLOUD_WIDTH * 0.2f));
-    int height = random_from_min_to_range((int) (CLOUD_HEIGHT * 0.15f), (int) (CLOUD_HEIGHT * 0.2f));
+    graphics_renderer()->update_custom_image_from(CUSTOM_IMAGE_CLOUDS, pixels,
+        0, 0, CLOUD_TEXTURE_WIDTH, CLOUD_TEXTURE_HEIGHT);
+    free(pixels);
 
-    for (int i = 0; i < NUM_CLOUD_ELLIPSES; i++) {
-        generate_cloud_ellipse(pixels, width, height);
+    for (int i = 0; i < NUM_CLOUDS; i++) {
+        reset_cloud(&data.clouds[i]);
     }
+    return 1;
+}
 
-    const image *img = &cloud->img;
-
-    graphics_renderer()->update_custom_image_from(CUSTOM_IMAGE_CLOUDS, pixels,
-        img->atlas.x_offset, img->atlas.y_offset, img->width, img->height);
-
+static void generate_cloud(cloud_type *cloud)
+{
+    cloud->img = &data.patterns[random_between_from_stdlib(0, NUM_CLOUD_PATTERNS)];
     cloud->x = 0;
     cloud->y = 0;
     cloud->scale_x = (float) ((1.5 - random_fractional_from_stdlib()) / CLOUD_SCALE);
@@ -265,6 +322,13 @@ void clouds_draw(int x_offset, int y_offset, int x_limit, int y_limit, float bas
         cloud_speed = CLOUD_SPEED * setting_game_speed() / 100;
     }
 
+    if (!graphics_renderer()->has_custom_image(CUSTOM_IMAGE_CLOUDS) && !init_cloud_images()) {
+        return;
+    }
+
+    image_instance shadows[NUM_CLOUDS];
+    int num_shadows = 0;
+
     for (int i = 0; i < NUM_CLOUDS; i++) {
         cloud_type *cloud = &data.clouds[i];
         if (cloud->status == STATUS_INACTIVE) {
@@ -285,13 +349,17 @@ void clouds_draw(int x_offset, int y_offset, int x_limit, int y_limit, float bas
         speed_set_target(&cloud->speed.x, -cloud_speed, SPEED_CHANGE_IMMEDIATE, 1);
         speed_set_target(&cloud->speed.y, cloud_speed / 2, SPEED_CHANGE_IMMEDIATE, 1);
 
-        graphics_renderer()->draw_image_advanced(&cloud->img,
-            (cloud->x - x_offset) / base_scale,
-            (cloud->y - y_offset) / base_scale,
-            COLOR_MASK_NONE,
-            cloud->scale_x * base_scale, cloud->scale_y * base_scale, cloud->angle, 1);
+        image_instance *shadow = &shadows[num_shadows++];
+        shadow->img = cloud->img;
+        shadow->x = (cloud->x - x_offset) / base_scale;
+        shadow->y = (cloud->y - y_offset) / base_scale;
+        shadow->scale_x = cloud->scale_x * base_scale;
+        shadow->scale_y = cloud->scale_y * base_scale;
+        shadow->angle = cloud->angle;
 
         cloud->x += speed_get_delta(&cloud->speed.x);
         cloud->y += speed_get_delta(&cloud->speed.y);
     }
+
+    graphics_renderer()->draw_image_instances(shadows, num_shadows, COLOR_MASK_NONE);
 }
@@ -3,6 +3,11 @@
 
 #include "graphics/color.h"
 
+typedef struct {
+    int x;
+    int y;
+} graphics_point;
+
 void graphics_in_dialog(void);
 void graphics_in_dialog_with_size(int width, int height);
 void graphics_reset_dialog(void);
@@ -14,6 +19,14 @@ void graphics_clear_screen(void);
 
 void graphics_draw_line(int x_start, int x_end, int y_start, int y_end, color_t color);
 
+/**
+ * Draws a batch of single pixels with the same color in one renderer call
+ * @param points The pixels to draw
+ * @param num_points The number of pixels
+ * @param color The color of all the pixels
+ */
+void graphics_draw_points(const graphics_point *points, int num_points, color_t color);
+
 void graphics_draw_rect(int x, int y, int width, int height, color_t color);
 void graphics_draw_inset_rect(int x, int y, int width, int height, color_t color_dark, color_t color_light);
 
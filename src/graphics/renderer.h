@@ -2,6 +2,7 @@
 #define GRAPHICS_RENDERER_H
 
 #include "core/image.h"
+#include "graphics/graphics.h"
 
 typedef enum {
     ATLAS_FIRST,
@@ -10,6 +11,7 @@ typedef enum {
     ATLAS_FONT,
     ATLAS_EXTRA_ASSET,
     ATLAS_UNPACKED_EXTRA_ASSET,
+    ATLAS_LAZY_EXTRA_ASSET,
     ATLAS_CUSTOM,
     ATLAS_EXTERNAL,
     ATLAS_MAX
@@ -40,6 +42,15 @@ typedef struct {
     int *image_heights;
 } image_atlas_data;
 
+typedef struct {
+    const image *img;
+    float x;
+    float y;
+    float scale_x;
+    float scale_y;
+    double angle;
+} image_instance;
+
 typedef struct {
     void (*clear_screen)(void);
 
@@ -52,10 +63,14 @@ typedef struct {
     void (*draw_line)(int x_start, int x_end, int y_start, int y_end, color_t color);
     void (*draw_rect)(int x_start, int x_end, int y_start, int y_end, color_t color);
     void (*fill_rect)(int x_start, int x_end, int y_start, int y_end, color_t color);
+    void (*draw_points)(const graphics_point *points, int num_points, color_t color);
 
     void (*draw_image)(const image *img, int x, int y, color_t color, float scale);
     void (*draw_image_advanced)(const image *img, float x, float y, color_t color,
         float scale_x, float scale_y, double angle, int disable_coord_scaling);
+    // Draws several transformed images in one go. All images must be on the same texture.
+    // Coordinates are not scaled, like draw_image_advanced with disable_coord_scaling set.
+    void (*draw_image_instances)(const image_instance *instances, int num_instances, color_t color);
     void (*draw_silhouette)(const image *img, int x, int y, color_t color, float scale);
 
     void (*create_custom_image)(custom_image_type type, int width, int height, int is_yuv);
@@ -87,6 +102,8 @@ typedef struct {
     const image_atlas_data *(*get_image_atlas)(atlas_type type);
     int (*has_image_atlas)(atlas_type type);
     void (*free_image_atlas)(atlas_type type);
+    int (*append_image_atlas)(atlas_type type, color_t **buffers, const int *widths, const int *heights,
+        int num_images);
 
     void (*load_unpacked_image)(const image *img, const color_t *pixels);
     void (*free_unpacked_image)(const image *img);
@@ -20,6 +20,7 @@
 
 #define MAX_LINKS 50
 #define TEMP_LINE_SIZE 200
+#define RICH_TEXT_LAYOUT_CACHE_SIZE 4
 
 static void on_scroll(void);
 
@@ -38,6 +39,56 @@ static struct {
 
 static uint8_t tmp_line[TEMP_LINE_SIZE];
 
+typedef struct {
+    font_t font;
+    int letter_id;
+    int x;
+    int y_offset;
+} rich_text_glyph;
+
+typedef struct {
+    int message_id;
+    int x_start;
+    int x_end;
+} rich_text_link;
+
+typedef struct {
+    int first_glyph;
+    int num_glyphs;
+    int first_link;
+    int num_links;
+    int image_id;
+} rich_text_line;
+
+// Laid out text, with positions relative to the top left of the text box
+typedef struct {
+    const uint8_t *text;
+    uint32_t hash;
+    int box_width;
+    int measure_only;
+    const font_definition *normal_font;
+    const font_definition *heading_font;
+    const font_definition *link_font;
+    int line_height;
+    int paragraph_indent;
+    unsigned int last_used;
+    int total_lines;
+    rich_text_line *lines;
+    int num_lines;
+    int lines_capacity;
+    rich_text_glyph *glyphs;
+    int num_glyphs;
+    int glyphs_capacity;
+    rich_text_link *links;
+    int num_links;
+    int links_capacity;
+} rich_text_layout;
+
+static struct {
+    rich_text_layout entries[RICH_TEXT_LAYOUT_CACHE_SIZE];
+    unsigned int use_counter;
+} layout_cache;
+
 static struct {
     const font_definition *normal_font;
     const font_definition *link_font;
@@ -191,7 +242,74 @@ static int get_word_width(const uint8_t *str, const font_definition *def, int in
     return width;
 }
 
-static void draw_line(const uint8_t *str, const font_definition *font, int x, int y, color_t color, int measure_only)
+static void *grow_layout_array(void *items, int *capacity, int needed, size_t item_size)
+{
+    if (needed <= *capacity) {
+        return items;
+    }
+    int new_capacity = *capacity ? *capacity * 2 : 64;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    void *new_items = realloc(items, new_capacity * item_size);
+    if (!new_items) {
+        return 0;
+    }
+    *capacity = new_capacity;
+    return new_items;
+}
+
+static rich_text_line *add_layout_line(rich_text_layout *layout)
+{
+    rich_text_line *lines = grow_layout_array(layout->lines, &layout->lines_capacity,
+        layout->num_lines + 1, sizeof(rich_text_line));
+    if (!lines) {
+        return 0;
+    }
+    layout->lines = lines;
+    rich_text_line *line = &layout->lines[layout->num_lines++];
+    line->first_glyph = layout->num_glyphs;
+    line->num_glyphs = 0;
+    line->first_link = layout->num_links;
+    line->num_links = 0;
+    line->image_id = 0;
+    return line;
+}
+
+static void add_layout_glyph(rich_text_layout *layout, rich_text_line *line, font_t font, int letter_id,
+    int x, int y_offset)
+{
+    rich_text_glyph *glyphs = grow_layout_array(layout->glyphs, &layout->glyphs_capacity,
+        layout->num_glyphs + 1, sizeof(rich_text_glyph));
+    if (!glyphs) {
+        return;
+    }
+    layout->glyphs = glyphs;
+    rich_text_glyph *glyph = &layout->glyphs[layout->num_glyphs++];
+    glyph->font = font;
+    glyph->letter_id = letter_id;
+    glyph->x = x;
+    glyph->y_offset = y_offset;
+    line->num_glyphs++;
+}
+
+static void add_layout_link(rich_text_layout *layout, rich_text_line *line, int message_id, int x_start, int x_end)
+{
+    rich_text_link *layout_links = grow_layout_array(layout->links, &layout->links_capacity,
+        layout->num_links + 1, sizeof(rich_text_link));
+    if (!layout_links) {
+        return;
+    }
+    layout->links = layout_links;
+    rich_text_link *link = &layout->links[layout->num_links++];
+    link->message_id = message_id;
+    link->x_start = x_start;
+    link->x_end = x_end;
+    line->num_links++;
+}
+
+static void layout_line(const uint8_t *str, const font_definition *font, int x,
+    rich_text_layout *layout, rich_text_line *line)
 {
     int start_link = 0;
     int num_link_chars = 0;
@@ -203,7 +321,7 @@ static void draw_line(const uint8_t *str, const font_definition *font, int x, in
                 str++;
             }
             int width = get_word_width(str, data.link_font, 1, &num_link_chars, 0);
-            add_link(message_id, x, x + width, y);
+            add_layout_link(layout, line, message_id, x, x + width);
             start_link = 1;
         }
         if (*str >= ' ') {
@@ -219,9 +337,9 @@ static void draw_line(const uint8_t *str, const font_definition *font, int x, in
                     start_link = 0;
                 }
                 const image *img = image_letter(letter_id);
-                if (!measure_only) {
+                if (!layout->measure_only) {
                     int height = def->image_y_offset(*str, img->height + img->y_offset, def->line_height);
-                    image_draw_letter(def->font, letter_id, x, y - height, color, SCALE_NONE);
+                    add_layout_glyph(layout, line, def->font, letter_id, x, -height);
                 }
                 x += img->original.width + def->letter_spacing;
             }
@@ -340,22 +458,16 @@ int rich_text_parse_image_id(const uint8_t **position, int default_image_group,
     return image_id;
 }
 
-static int draw_text(const uint8_t *text, int x_offset, int y_offset,
-                     int box_width, unsigned int height_lines, color_t color, int measure_only)
+static void layout_text(rich_text_layout *layout)
 {
-    if (!measure_only) {
-        graphics_set_clip_rectangle(x_offset, y_offset, box_width, data.line_height * height_lines);
-        if (height_lines != scrollbar.elements_in_view) {
-            scrollbar.elements_in_view = height_lines;
-            scrollbar_update_total_elements(&scrollbar, data.num_lines);
-        }
-    }
+    const uint8_t *text = layout->text;
+    int box_width = layout->box_width;
+    int measure_only = layout->measure_only;
     int lines_to_skip = 0;
     int image_id = 0;
     int lines_before_image = 0;
     int paragraph = 0;
     int has_more_characters = 1;
-    int y = y_offset;
     int guard = 0;
     unsigned int line = 0;
     unsigned int num_lines = 0;
@@ -479,18 +591,14 @@ static int draw_text(const uint8_t *text, int x_offset, int y_offset,
             }
         }
 
-        int outside_viewport = 0;
-        if (!measure_only) {
-            if (line < scrollbar.scroll_position || line >= scrollbar.scroll_position + height_lines) {
-                outside_viewport = 1;
-            }
+        rich_text_line *layout_line_data = add_layout_line(layout);
+        if (!layout_line_data) {
+            break;
         }
-        if (!outside_viewport) {
-            if (centered) {
-                x_line_offset = (box_width - current_width) / 2;
-            }
-            draw_line(tmp_line, def, x_line_offset + x_offset, y, color, measure_only);
+        if (centered) {
+            x_line_offset = (box_width - current_width) / 2;
         }
+        layout_line(tmp_line, def, x_line_offset, layout, layout_line_data);
         if (!measure_only) {
             if (image_id) {
                 if (lines_before_image) {
@@ -505,30 +613,131 @@ static int draw_text(const uint8_t *text, int x_offset, int y_offset,
                     if ((height % data.line_height) > data.line_height / 2) {
                         lines_to_skip++;
                     }
-                    int image_offset_x = x_offset + (box_width - img->original.width) / 2 - 4;
-                    if (line < height_lines + scrollbar.scroll_position) {
-                        if (line >= scrollbar.scroll_position) {
-                            image_draw(image_id, image_offset_x, y + 8, COLOR_MASK_NONE, SCALE_NONE);
-                        } else {
-                            image_draw(image_id, image_offset_x,
-                                y + 8 - data.line_height * (scrollbar.scroll_position - line),
-                                COLOR_MASK_NONE, SCALE_NONE);
-                        }
-                    }
+                    layout_line_data->image_id = image_id;
                     image_id = 0;
                 }
             }
         }
         line++;
         num_lines++;
+    }
+    layout->total_lines = num_lines;
+}
+
+static void draw_layout(const rich_text_layout *layout, int x_offset, int y_offset,
+    unsigned int height_lines, color_t color)
+{
+    int measure_only = layout->measure_only;
+    int y = y_offset;
+    for (unsigned int line = 0; line < (unsigned int) layout->num_lines; line++) {
+        const rich_text_line *line_data = &layout->lines[line];
+        int outside_viewport = 0;
+        if (!measure_only) {
+            if (line < scrollbar.scroll_position || line >= scrollbar.scroll_position + height_lines) {
+                outside_viewport = 1;
+            }
+        }
+        if (!outside_viewport) {
+            for (int i = 0; i < line_data->num_links; i++) {
+                const rich_text_link *link = &layout->links[line_data->first_link + i];
+                add_link(link->message_id, x_offset + link->x_start, x_offset + link->x_end, y);
+            }
+            for (int i = 0; i < line_data->num_glyphs; i++) {
+                const rich_text_glyph *glyph = &layout->glyphs[line_data->first_glyph + i];
+                image_draw_letter(glyph->font, glyph->letter_id, x_offset + glyph->x, y + glyph->y_offset,
+                    color, SCALE_NONE);
+            }
+        }
+        if (line_data->image_id) {
+            const image *img = image_get(line_data->image_id);
+            int image_offset_x = x_offset + (layout->box_width - img->original.width) / 2 - 4;
+            if (line < height_lines + scrollbar.scroll_position) {
+                if (line >= scrollbar.scroll_position) {
+                    image_draw(line_data->image_id, image_offset_x, y + 8, COLOR_MASK_NONE, SCALE_NONE);
+                } else {
+                    image_draw(line_data->image_id, image_offset_x,
+                        y + 8 - data.line_height * (scrollbar.scroll_position - line),
+                        COLOR_MASK_NONE, SCALE_NONE);
+                }
+            }
+        }
         if (!outside_viewport) {
             y += data.line_height;
         }
     }
+}
+
+static uint32_t hash_text(const uint8_t *text)
+{
+    uint32_t hash = 2166136261u;
+    while (*text) {
+        hash = (hash ^ *text++) * 16777619u;
+    }
+    return hash;
+}
+
+static rich_text_layout *get_layout(const uint8_t *text, int box_width, int measure_only)
+{
+    uint32_t hash = hash_text(text);
+    rich_text_layout *oldest = &layout_cache.entries[0];
+    layout_cache.use_counter++;
+    for (int i = 0; i < RICH_TEXT_LAYOUT_CACHE_SIZE; i++) {
+        rich_text_layout *layout = &layout_cache.entries[i];
+        if (layout->text == text && layout->hash == hash && layout->box_width == box_width &&
+            layout->measure_only == measure_only && layout->normal_font == data.normal_font &&
+            layout->heading_font == data.heading_font && layout->link_font == data.link_font &&
+            layout->line_height == data.line_height && layout->paragraph_indent == data.paragraph_indent) {
+            layout->last_used = layout_cache.use_counter;
+            return layout;
+        }
+        if (layout->last_used < oldest->last_used) {
+            oldest = layout;
+        }
+    }
+    oldest->text = text;
+    oldest->hash = hash;
+    oldest->box_width = box_width;
+    oldest->measure_only = measure_only;
+    oldest->normal_font = data.normal_font;
+    oldest->heading_font = data.heading_font;
+    oldest->link_font = data.link_font;
+    oldest->line_height = data.line_height;
+    oldest->paragraph_indent = data.paragraph_indent;
+    oldest->last_used = layout_cache.use_counter;
+    oldest->num_lines = 0;
+    oldest->num_glyphs = 0;
+    oldest->num_links = 0;
+    layout_text(oldest);
+    return oldest;
+}
+
+void rich_text_clear_layout_cache(void)
+{
+    for (int i = 0; i < RICH_TEXT_LAYOUT_CACHE_SIZE; i++) {
+        rich_text_layout *layout = &layout_cache.entries[i];
+        free(layout->lines);
+        free(layout->glyphs);
+        free(layout->links);
+    }
+    memset(&layout_cache, 0, sizeof(layout_cache));
+}
+
+static int draw_text(const uint8_t *text, int x_offset, int y_offset,
+                     int box_width, unsigned int height_lines, color_t color, int measure_only)
+{
+    if (!measure_only) {
+        graphics_set_clip_rectangle(x_offset, y_offset, box_width, data.line_height * height_lines);
+        if (height_lines != scrollbar.elements_in_view) {
+            scrollbar.elements_in_view = height_lines;
+            scrollbar_update_total_elements(&scrollbar, data.num_lines);
+        }
+    }
+    const rich_text_layout *layout = get_layout(text, box_width, measure_only);
+    draw_layout(layout, x_offset, y_offset, height_lines, color);
     if (!measure_only) {
         graphics_reset_clip_rectangle();
     }
-    return num_lines;
+    return layout->total_lines;
 }
 
 int rich_text_get_line_height(void)
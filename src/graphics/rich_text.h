@@ -32,6 +32,11 @@ void rich_text_set_fonts(font_t normal_font, font_t heading_font, font_t link_fo
  */
 void rich_text_reset(int scroll_position);
 
+/**
+ * Clears the cached layout of previously drawn texts. Must be called whenever fonts change
+ */
+void rich_text_clear_layout_cache(void);
+
 /**
  * Clear the links table
  */
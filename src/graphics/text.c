@@ -13,8 +13,36 @@
 #define ELLIPSIS_LENGTH 4
 #define NUMBER_BUFFER_LENGTH 100
 
+#define TEXT_LAYOUT_CACHE_SIZE 16
+#define TEXT_LAYOUT_MAX_LINES 100
+
 static uint8_t tmp_line[200];
 
+typedef struct {
+    int start;
+    int end;
+    int width;
+} text_layout_line;
+
+typedef struct {
+    const uint8_t *str;
+    uint32_t hash;
+    font_t font;
+    int box_width;
+    unsigned int last_used;
+    int has_lines;
+    int num_lines;
+    text_layout_line lines[TEXT_LAYOUT_MAX_LINES];
+    int has_measure;
+    int measured_lines;
+    int measured_largest_width;
+} text_layout;
+
+static struct {
+    text_layout entries[TEXT_LAYOUT_CACHE_SIZE];
+    unsigned int use_counter;
+} layout_cache;
+
 static struct {
     int capture;
     int seen;
@@ -559,26 +587,61 @@ void text_draw_number_centered_colored(
     text_draw_centered(str, x_offset, y_offset, box_width, font, color);
 }
 
-int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_width,
-    int centered, font_t font, color_t color)
+static uint32_t hash_string(const uint8_t *str)
 {
-    int line_height = font_definition_for(font)->line_height;
-    if (line_height < 11) {
-        line_height = 11;
+    uint32_t hash = 2166136261u;
+    while (*str) {
+        hash = (hash ^ *str++) * 16777619u;
     }
+    return hash;
+}
+
+static text_layout *get_layout(const uint8_t *str, int box_width, font_t font)
+{
+    uint32_t hash = hash_string(str);
+    text_layout *oldest = &layout_cache.entries[0];
+    layout_cache.use_counter++;
+    for (int i = 0; i < TEXT_LAYOUT_CACHE_SIZE; i++) {
+        text_layout *layout = &layout_cache.entries[i];
+        if (layout->str == str && layout->hash == hash && layout->font == font && layout->box_width == box_width) {
+            layout->last_used = layout_cache.use_counter;
+            return layout;
+        }
+        if (layout->last_used < oldest->last_used) {
+            oldest = layout;
+        }
+    }
+    memset(oldest, 0, sizeof(text_layout));
+    oldest->str = str;
+    oldest->hash = hash;
+    oldest->font = font;
+    oldest->box_width = box_width;
+    oldest->last_used = layout_cache.use_counter;
+    return oldest;
+}
+
+void text_layout_cache_clear(void)
+{
+    memset(&layout_cache, 0, sizeof(layout_cache));
+}
+
+static void calculate_multiline_layout(text_layout *layout)
+{
+    const uint8_t *start = layout->str;
+    const uint8_t *str = start;
+    int box_width = layout->box_width;
+    font_t font = layout->font;
     int has_more_characters = 1;
     int guard = 0;
-    int y = y_offset;
+    layout->num_lines = 0;
     while (has_more_characters) {
-        if (++guard >= 100) {
+        if (++guard >= TEXT_LAYOUT_MAX_LINES) {
             break;
         }
-        // clear line
-        for (int i = 0; i < 200; i++) {
-            tmp_line[i] = 0;
-        }
         int current_width = 0;
         int line_index = 0;
+        const uint8_t *line_start = str;
+        const uint8_t *line_end = str;
         while (has_more_characters) {
             int word_num_chars;
             int word_width = get_word_width(str, font, &word_num_chars, 0);
@@ -595,11 +658,13 @@ int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_
             current_width += word_width;
             for (int i = 0; i < word_num_chars; i++) {
                 if (line_index == 0 && *str <= ' ') {
-                    str++; // skip whitespace at start of line
+                    line_start = ++str; // skip whitespace at start of line
                 } else {
-                    tmp_line[line_index++] = *str++;
+                    line_index++;
+                    str++;
                 }
             }
+            line_end = str;
             if (!*str) {
                 has_more_characters = 0;
             } else if (*str == '\n') {
@@ -607,14 +672,42 @@ int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_
                 break;
             }
         }
-        int line_offset = centered ? (box_width - current_width) / 2 : 0;
+        text_layout_line *line = &layout->lines[layout->num_lines++];
+        line->start = (int) (line_start - start);
+        line->end = (int) (line_end - start);
+        line->width = current_width;
+    }
+    layout->has_lines = 1;
+}
+
+int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_width,
+    int centered, font_t font, color_t color)
+{
+    int line_height = font_definition_for(font)->line_height;
+    if (line_height < 11) {
+        line_height = 11;
+    }
+    text_layout *layout = get_layout(str, box_width, font);
+    if (!layout->has_lines) {
+        calculate_multiline_layout(layout);
+    }
+    int y = y_offset;
+    for (int i = 0; i < layout->num_lines; i++) {
+        const text_layout_line *line = &layout->lines[i];
+        int length = line->end - line->start;
+        if (length > (int) sizeof(tmp_line) - 1) {
+            length = sizeof(tmp_line) - 1;
+        }
+        memcpy(tmp_line, str + line->start, length);
+        tmp_line[length] = 0;
+        int line_offset = centered ? (box_width - line->width) / 2 : 0;
         text_draw(tmp_line, x_offset + line_offset, y, font, color);
         y += line_height + 5;
     }
     return y - y_offset;
 }
 
-int text_measure_multiline(const uint8_t *str, int box_width, font_t font, int *largest_width)
+static int measure_multiline(const uint8_t *str, int box_width, font_t font, int *largest_width)
 {
     // \n is not counted as a word and is only caught it directly after a word: "word \n" won't work correctly
     *largest_width = 0;
@@ -658,3 +751,14 @@ int text_measure_multiline(const uint8_t *str, int box_width, font_t font, int *
     }
     return num_lines;
 }
+
+int text_measure_multiline(const uint8_t *str, int box_width, font_t font, int *largest_width)
+{
+    text_layout *layout = get_layout(str, box_width, font);
+    if (!layout->has_measure) {
+        layout->measured_lines = measure_multiline(str, box_width, font, &layout->measured_largest_width);
+        layout->has_measure = 1;
+    }
+    *largest_width = layout->measured_largest_width;
+    return layout->measured_lines;
+}
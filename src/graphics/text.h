@@ -53,4 +53,9 @@ int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_
  */
 int text_measure_multiline(const uint8_t *str, int box_width, font_t font, int *largest_width);
 
+/**
+ * Clears the cached line breaks of multiline text. Must be called whenever fonts change
+ */
+void text_layout_cache_clear(void);
+
 #endif // GRAPHICS_TEXT_H
@@ -9,6 +9,7 @@
 #include "game/system.h"
 #include "graphics/renderer.h"
 #include "platform/file_manager.h"
+#include "platform/frame_queue.h"
 #include "sound/device.h"
 #include "sound/music.h"
 #include "sound/speech.h"
@@ -18,7 +19,8 @@
 
 #include <string.h>
 
-#define MAX_FRAME_TIME_ADVANCE_MS (1.0 / 30.0)
+#define SMK_FRAMES_AHEAD 4
+#define MPG_FRAMES_AHEAD 4
 
 typedef enum {
     VIDEO_TYPE_NONE = 0,
@@ -27,6 +29,11 @@ typedef enum {
     VIDEO_TYPE_AV1 = 3
 } video_type;
 
+typedef struct {
+    int audio_len;
+    // Followed by the picture and the audio data
+} decoded_frame;
+
 static struct {
     int is_playing;
     int is_ended;
@@ -45,7 +52,6 @@ static struct {
         time_millis start_render_millis;
         int current_frame;
         int draw_frame;
-        plm_frame_t *mpg_frame;
     } video;
     struct {
         int has_audio;
@@ -57,11 +63,180 @@ static struct {
         color_t *pixels;
         int width;
     } buffer;
+    struct {
+        frame_queue *queue;
+        const decoded_frame *frame;
+        size_t picture_size;
+        int max_audio_len;
+        int is_yuv;
+        struct {
+            int luma_width;
+            int luma_height;
+            int chroma_width;
+            int chroma_height;
+        } planes;
+        double audio_time;
+    } decoder;
     int restart_music;
 } data;
 
+static uint8_t *decoded_frame_picture(const decoded_frame *frame)
+{
+    return (uint8_t *) (frame + 1);
+}
+
+static color_t *decoded_frame_pixels(const decoded_frame *frame)
+{
+    return (color_t *) decoded_frame_picture(frame);
+}
+
+static uint8_t *decoded_frame_audio(const decoded_frame *frame)
+{
+    return decoded_frame_picture(frame) + data.decoder.picture_size;
+}
+
+static void convert_smk_frame(color_t *dst, int dst_width)
+{
+    const uint8_t *frame = smacker_get_frame_video(data.s);
+    const color_t *pal = smacker_get_frame_palette(data.s);
+    if (!frame || !pal) {
+        return;
+    }
+    color_t colors[256];
+    for (int i = 0; i < 256; i++) {
+        colors[i] = ALPHA_OPAQUE | pal[i];
+    }
+    int width = data.video.width;
+    int y_step = data.video.y_scale == SMACKER_Y_SCALE_NONE ? 1 : 2;
+    for (int y = 0; y < data.video.height; y += y_step) {
+        const uint8_t *line = frame + (y / y_step) * width;
+        color_t *pixel = &dst[y * dst_width];
+        for (int x = 0; x < width; x++) {
+            pixel[x] = colors[line[x]];
+        }
+        if (y_step == 2 && y + 1 < data.video.height) {
+            memcpy(pixel + dst_width, pixel, sizeof(color_t) * width);
+        }
+    }
+}
+
+static int decode_smk_frame(void *frame_data, void *userdata)
+{
+    if (smacker_next_frame(data.s) != SMACKER_FRAME_OK) {
+        return 0;
+    }
+    decoded_frame *frame = frame_data;
+    convert_smk_frame(decoded_frame_pixels(frame), data.video.width);
+    frame->audio_len = 0;
+    if (data.audio.has_audio) {
+        int audio_len = smacker_get_frame_audio_size(data.s, 0);
+        if (audio_len > data.decoder.max_audio_len) {
+            audio_len = data.decoder.max_audio_len;
+        }
+        if (audio_len > 0) {
+            memcpy(decoded_frame_audio(frame), smacker_get_frame_audio(data.s, 0), audio_len);
+            frame->audio_len = audio_len;
+        }
+    }
+    return 1;
+}
+
+static void start_smk_decoder(void)
+{
+    if (data.buffer.pixels) {
+        convert_smk_frame(data.buffer.pixels, data.buffer.width);
+        data.video.draw_frame = 1;
+    }
+    data.decoder.is_yuv = 0;
+    data.decoder.picture_size = sizeof(color_t) * data.video.width * data.video.height;
+    data.decoder.max_audio_len = data.audio.has_audio ? smacker_get_max_frame_audio_size(data.s, 0) : 0;
+    size_t frame_size = sizeof(decoded_frame) + data.decoder.picture_size + data.decoder.max_audio_len;
+    data.decoder.queue = platform_frame_queue_create(SMK_FRAMES_AHEAD, frame_size, decode_smk_frame, 0);
+}
+
+static size_t mpg_luma_size(void)
+{
+    return (size_t) data.decoder.planes.luma_width * data.decoder.planes.luma_height;
+}
+
+static size_t mpg_chroma_size(void)
+{
+    return (size_t) data.decoder.planes.chroma_width * data.decoder.planes.chroma_height;
+}
+
+static int decode_mpg_frame(void *frame_data, void *userdata)
+{
+    plm_frame_t *mpg_frame = plm_decode_video(data.plm);
+    if (!mpg_frame) {
+        return 0;
+    }
+    decoded_frame *frame = frame_data;
+    uint8_t *picture = decoded_frame_picture(frame);
+    if (data.decoder.is_yuv) {
+        memcpy(picture, mpg_frame->y.data, mpg_luma_size());
+        memcpy(picture + mpg_luma_size(), mpg_frame->cb.data, mpg_chroma_size());
+        memcpy(picture + mpg_luma_size() + mpg_chroma_size(), mpg_frame->cr.data, mpg_chroma_size());
+    } else {
+        plm_frame_to_bgra(mpg_frame, picture, data.video.width * sizeof(color_t));
+    }
+    frame->audio_len = 0;
+    if (data.audio.has_audio) {
+        // Audio is decoded up to the end of the frame, so it is played when the frame is shown
+        double frame_end_time = mpg_frame->time + data.video.micros_per_frame / 1000000.0;
+        int samples_len = sizeof(float) * PLM_AUDIO_SAMPLES_PER_FRAME * 2;
+        while (data.decoder.audio_time < frame_end_time &&
+            frame->audio_len + samples_len <= data.decoder.max_audio_len) {
+            plm_samples_t *samples = plm_decode_audio(data.plm);
+            if (!samples) {
+                break;
+            }
+            memcpy(decoded_frame_audio(frame) + frame->audio_len, samples->interleaved, samples_len);
+            frame->audio_len += samples_len;
+            data.decoder.audio_time = samples->time + PLM_AUDIO_SAMPLES_PER_FRAME / (double) data.audio.rate;
+        }
+    }
+    return 1;
+}
+
+static void start_mpg_decoder(void)
+{
+    data.decoder.is_yuv = graphics_renderer()->supports_yuv_image_format();
+    // Planes cover whole macroblocks of 16 pixels, so they can be larger than the video
+    data.decoder.planes.luma_width = (data.video.width + 15) / 16 * 16;
+    data.decoder.planes.luma_height = (data.video.height + 15) / 16 * 16;
+    data.decoder.planes.chroma_width = data.decoder.planes.luma_width / 2;
+    data.decoder.planes.chroma_height = data.decoder.planes.luma_height / 2;
+    if (data.decoder.is_yuv) {
+        data.decoder.picture_size = mpg_luma_size() + 2 * mpg_chroma_size();
+    } else {
+        data.decoder.picture_size = sizeof(color_t) * data.video.width * data.video.height;
+    }
+    data.decoder.max_audio_len = 0;
+    if (data.audio.has_audio) {
+        // A frame needs the audio packets that overlap it, which can be one more than fit in its duration
+        int packets_per_frame = (int) ((double) data.audio.rate * data.video.micros_per_frame / 1000000 /
+            PLM_AUDIO_SAMPLES_PER_FRAME) + 2;
+        data.decoder.max_audio_len = packets_per_frame * sizeof(float) * PLM_AUDIO_SAMPLES_PER_FRAME * 2;
+    }
+    data.decoder.audio_time = 0;
+    size_t frame_size = sizeof(decoded_frame) + data.decoder.picture_size + data.decoder.max_audio_len;
+    data.decoder.queue = platform_frame_queue_create(MPG_FRAMES_AHEAD, frame_size, decode_mpg_frame, 0);
+}
+
+static void release_decoded_frame(void)
+{
+    if (data.decoder.frame) {
+        platform_frame_queue_pop(data.decoder.queue);
+        data.decoder.frame = 0;
+    }
+}
+
 static void close_decoder(void)
 {
+    // The decoder thread uses the smacker object, so it has to stop first
+    platform_frame_queue_destroy(data.decoder.queue);
+    data.decoder.queue = 0;
+    data.decoder.frame = 0;
     if (data.s) {
         smacker_close(data.s);
         data.s = 0;
@@ -79,18 +254,6 @@ static void close_decoder(void)
     data.type = VIDEO_TYPE_NONE;
 }
 
-static void update_mpg_video(plm_t *plm, plm_frame_t *frame, void *user)
-{
-    data.video.draw_frame = 1;
-    data.video.current_frame++;
-    data.video.mpg_frame = frame;
-}
-
-static void update_mpg_audio(plm_t *mpeg, plm_samples_t *samples, void *user)
-{
-    sound_device_write_custom_music_data(samples->interleaved, sizeof(float) * samples->count * 2);
-}
-
 static const char *get_filename_from_path(const char *filename)
 {
     if (data.type == VIDEO_TYPE_SMK) {
@@ -229,8 +392,6 @@ static int load_mpg(const char *filename)
 
     data.audio.has_audio = 0;
 
-	plm_set_video_decode_callback(data.plm, update_mpg_video, 0);
-	
     if (config_get(CONFIG_GENERAL_ENABLE_VIDEO_SOUND) && plm_get_num_audio_streams(data.plm) > 0) {
         plm_set_audio_enabled(data.plm, 1);
         plm_set_audio_stream(data.plm, 0);
@@ -238,10 +399,8 @@ static int load_mpg(const char *filename)
         data.audio.bitdepth = 32;
         data.audio.channels = 2;
         data.audio.rate = plm_get_samplerate(data.plm);
-        plm_set_audio_decode_callback(data.plm, update_mpg_audio, 0);
     } else {
         plm_set_audio_enabled(data.plm, 0);
-        plm_set_audio_decode_callback(data.plm, 0, 0);
     }
 
     data.type = VIDEO_TYPE_MPG;
@@ -353,6 +512,11 @@ void video_init(int restart_music)
                 audio_data, audio_len);
         }
     }
+    if (data.type == VIDEO_TYPE_SMK) {
+        start_smk_decoder();
+    } else if (data.type == VIDEO_TYPE_MPG) {
+        start_mpg_decoder();
+    }
 }
 
 int video_is_finished(void)
@@ -388,41 +552,33 @@ static void get_next_frame(void)
     }
     time_millis now_millis = system_get_ticks();
 
-    if (data.type == VIDEO_TYPE_SMK) {
+    if (data.type == VIDEO_TYPE_SMK || data.type == VIDEO_TYPE_MPG) {
+        if (!data.decoder.queue) {
+            return;
+        }
         int frame_no = (now_millis - data.video.start_render_millis) * 1000 / data.video.micros_per_frame;
-        data.video.draw_frame = data.video.current_frame == 0;
         while (frame_no > data.video.current_frame) {
-            if (smacker_next_frame(data.s) != SMACKER_FRAME_OK) {
-                close_decoder();
-                data.is_ended = 1;
-                data.is_playing = 0;
-                end_video();
+            // Frames that are due but were never shown are dropped
+            release_decoded_frame();
+            const decoded_frame *frame = platform_frame_queue_peek(data.decoder.queue);
+            if (!frame) {
+                if (platform_frame_queue_is_finished(data.decoder.queue)) {
+                    close_decoder();
+                    data.is_ended = 1;
+                    data.is_playing = 0;
+                    end_video();
+                }
+                // Otherwise the decoder is behind: keep showing the current frame
                 return;
             }
+            data.decoder.frame = frame;
             data.video.current_frame++;
             data.video.draw_frame = 1;
 
-            if (data.audio.has_audio) {
-                int audio_len = smacker_get_frame_audio_size(data.s, 0);
-                const void *audio_data = smacker_get_frame_audio(data.s, 0);
-                if (audio_len > 0) {
-                    sound_device_write_custom_music_data(audio_data, audio_len);
-                }
+            if (frame->audio_len > 0) {
+                sound_device_write_custom_music_data(decoded_frame_audio(frame), frame->audio_len);
             }
         }
-    } else if (data.type == VIDEO_TYPE_MPG) {
-        double elapsed_time = (now_millis - data.video.start_render_millis) / 1000.0;
-        if (elapsed_time > MAX_FRAME_TIME_ADVANCE_MS) {
-            elapsed_time = MAX_FRAME_TIME_ADVANCE_MS;
-        }
-        plm_decode(data.plm, elapsed_time);
-        data.video.start_render_millis = now_millis;
-        if (plm_has_ended(data.plm)) {
-            close_decoder();
-            data.is_ended = 1;
-            data.is_playing = 0;
-            end_video();
-        }
     } else if (data.type == VIDEO_TYPE_AV1) {
         if (data.audio.has_audio) {
             const easyav1_audio_frame *audio_frame = easyav1_get_audio_frame(data.easyav1);
@@ -452,28 +608,27 @@ static void update_video_frame(void)
     if (data.type == VIDEO_TYPE_NONE) {
         return;
     }
-    if (data.type == VIDEO_TYPE_SMK) {
-        const unsigned char *frame = smacker_get_frame_video(data.s);
-        const uint32_t *pal = smacker_get_frame_palette(data.s);
-        if (frame && pal) {
-            for (int y = 0; y < data.video.height; y++) {
-                color_t *pixel = &data.buffer.pixels[y * data.buffer.width];
-                int video_y = data.video.y_scale == SMACKER_Y_SCALE_NONE ? y : y / 2;
-                const unsigned char *line = frame + (video_y * data.video.width);
-                for (int x = 0; x < data.video.width; x++) {
-                    *pixel = ALPHA_OPAQUE | pal[line[x]];
-                    ++pixel;
+    if (data.type == VIDEO_TYPE_SMK || data.type == VIDEO_TYPE_MPG) {
+        // The first Smacker frame is converted straight into the buffer when the decoder starts
+        if (data.decoder.frame && data.decoder.is_yuv) {
+            const uint8_t *y = decoded_frame_picture(data.decoder.frame);
+            const uint8_t *cb = y + mpg_luma_size();
+            const uint8_t *cr = cb + mpg_chroma_size();
+            graphics_renderer()->update_custom_image_yuv(CUSTOM_IMAGE_VIDEO, y, data.decoder.planes.luma_width,
+                cb, data.decoder.planes.chroma_width, cr, data.decoder.planes.chroma_width);
+            release_decoded_frame();
+            return;
+        }
+        if (data.decoder.frame) {
+            if (data.buffer.pixels) {
+                const color_t *pixels = decoded_frame_pixels(data.decoder.frame);
+                for (int y = 0; y < data.video.height; y++) {
+                    memcpy(&data.buffer.pixels[y * data.buffer.width], &pixels[y * data.video.width],
+                        sizeof(color_t) * data.video.width);
                 }
             }
+            release_decoded_frame();
         }
-    } else if (data.type == VIDEO_TYPE_MPG) {
-        if (graphics_renderer()->supports_yuv_image_format()) {
-            plm_frame_t *frame = data.video.mpg_frame;
-            graphics_renderer()->update_custom_image_yuv(CUSTOM_IMAGE_VIDEO, frame->y.data, frame->y.width,
-                frame->cb.data, frame->cb.width, frame->cr.data, frame->cr.width);
-            return;
-        }
-        plm_frame_to_bgra(data.video.mpg_frame, (uint8_t *) data.buffer.pixels, data.buffer.width * 4);
     } else if (data.type == VIDEO_TYPE_AV1) {
         if (!data.easyav1) {
             return;
@@ -15,27 +15,30 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
 #define DRIFT_DIRECTION_RIGHT 1
 #define DRIFT_DIRECTION_LEFT -1
 
+// Particles are stored as a structure of arrays, so the per-frame movement passes are
+// simple loops over contiguous ints that the compiler can vectorize
 typedef struct {
-    int x;
-    int y;
+    int *x;
+    int *y;
+    int *speed;
 
     // For rain
-    int length;
-    int speed;
-    int wind_variation;
+    int *length;
+    int *wind_variation;
 
     // For snow
-    int drift_offset;
-    int drift_direction;
+    int *drift_offset;
+    int *drift_direction;
 
     // For sand
-    int offset;
-} weather_element;
+    int *offset;
+} weather_particles;
 
 static struct {
     int weather_initialized;
@@ -54,7 +57,13 @@ static struct {
     weather_type displayed_type;
     weather_type last_type;
 
-    weather_element *elements;
+    weather_particles particles;
+    int *particle_memory;
+
+    struct {
+        graphics_point *items;
+        int capacity;
+    } points;
 
     struct {
         int active;
@@ -81,39 +90,91 @@ static struct {
     }
 };
 
-void init_weather_element(weather_element *e, int type)
+static void init_particle(int i, int type)
 {
-    e->x = random_from_stdlib() % screen_width();
-    e->y = random_from_stdlib() % screen_height();
+    weather_particles *p = &data.particles;
+    p->x[i] = random_from_stdlib() % screen_width();
+    p->y[i] = random_from_stdlib() % screen_height();
 
     switch (type) {
         case WEATHER_RAIN:
-            e->length = config_get(CONFIG_WT_RAIN_LENGTH) + random_from_stdlib() % 10;
-            e->speed = config_get(CONFIG_WT_RAIN_SPEED) + random_from_stdlib() % 5;
+            p->length[i] = config_get(CONFIG_WT_RAIN_LENGTH) + random_from_stdlib() % 10;
+            p->speed[i] = config_get(CONFIG_WT_RAIN_SPEED) + random_from_stdlib() % 5;
             if (data.weather_config.intensity < 600) {
-                e->wind_variation = 0;
+                p->wind_variation[i] = 0;
             } else {
-                e->wind_variation = (random_from_stdlib() % 3) - 1; // -1, 0 or 1
+                p->wind_variation[i] = (random_from_stdlib() % 3) - 1; // -1, 0 or 1
             }
             break;
         case WEATHER_SNOW:
-            e->drift_offset = random_from_stdlib() % 100;
-            e->speed = config_get(CONFIG_WT_SNOW_SPEED) + random_from_stdlib() % 2;
-            e->drift_direction = (random_from_stdlib() % 2 == 0) ? DRIFT_DIRECTION_RIGHT : DRIFT_DIRECTION_LEFT;
+            p->drift_offset[i] = random_from_stdlib() % 100;
+            p->speed[i] = config_get(CONFIG_WT_SNOW_SPEED) + random_from_stdlib() % 2;
+            p->drift_direction[i] = (random_from_stdlib() % 2 == 0) ? DRIFT_DIRECTION_RIGHT : DRIFT_DIRECTION_LEFT;
             break;
         case WEATHER_SAND:
-            e->speed = config_get(CONFIG_WT_SANDSTORM_SPEED) + (random_from_stdlib() % 2);
-            e->offset = random_between_from_stdlib(0, 1000);
+            p->speed[i] = config_get(CONFIG_WT_SANDSTORM_SPEED) + (random_from_stdlib() % 2);
+            p->offset[i] = random_between_from_stdlib(0, 1000);
             break;
     }
 }
 
-static void weather_stop(void)
+static void free_particles(void)
+{
+    free(data.particle_memory);
+    data.particle_memory = 0;
+    memset(&data.particles, 0, sizeof(weather_particles));
+}
+
+static int allocate_particles(int count)
+{
+    free_particles();
+    int **fields[] = {
+        &data.particles.x, &data.particles.y, &data.particles.speed, &data.particles.length,
+        &data.particles.wind_variation, &data.particles.drift_offset, &data.particles.drift_direction,
+        &data.particles.offset
+    };
+    int num_fields = sizeof(fields) / sizeof(fields[0]);
+    data.particle_memory = calloc((size_t) count * num_fields, sizeof(int));
+    if (!data.particle_memory) {
+        return 0;
+    }
+    for (int i = 0; i < num_fields; i++) {
+        *fields[i] = data.particle_memory + (size_t) i * count;
+    }
+    for (int i = 0; i < count; i++) {
+        init_particle(i, data.weather_config.type);
+    }
+    return 1;
+}
+
+static graphics_point *reserve_points(int count)
+{
+    if (count > data.points.capacity) {
+        graphics_point *items = realloc(data.points.items, sizeof(graphics_point) * count);
+        if (!items) {
+            return 0;
+        }
+        data.points.items = items;
+        data.points.capacity = count;
+    }
+    return data.points.items;
+}
+
+static int visible_particle_count(void)
 {
-    if (data.elements) {
-        free(data.elements);
-        data.elements = 0;
+    if (!data.particle_memory) {
+        return 0;
     }
+    return data.displayed_intensity < data.last_elements_count ?
+        data.displayed_intensity : data.last_elements_count;
+}
+
+static void weather_stop(void)
+{
+    free_particles();
+    free(data.points.items);
+    data.points.items = 0;
+    data.points.capacity = 0;
 
     data.weather_config.active = 0;
     data.weather_initialized = 0;
@@ -240,74 +301,125 @@ static void render_weather_overlay(void)
 
 static void draw_snow(void)
 {
-    if (!data.elements || data.displayed_intensity == 0) {
+    int count = visible_particle_count();
+    if (!count) {
         return;
     }
+    int *x = data.particles.x;
+    int *y = data.particles.y;
+    const int *speed = data.particles.speed;
+    const int *drift_offset = data.particles.drift_offset;
+    const int *drift_direction = data.particles.drift_direction;
 
-    int max_particles = data.last_elements_count;
-    int count = data.displayed_intensity;
-    if (count > max_particles) {
-        count = max_particles;
+    for (int i = 0; i < count; ++i) {
+        int drift = ((y[i] + drift_offset[i]) % 10) - 5;
+        x[i] += (drift / 10) * drift_direction[i];
+        y[i] += speed[i];
+    }
+
+    // Each snowflake is a small corner of three pixels
+    graphics_point *points = reserve_points(count * 3);
+    if (points) {
+        for (int i = 0; i < count; ++i) {
+            points[3 * i].x = x[i];
+            points[3 * i].y = y[i];
+            points[3 * i + 1].x = x[i] + 1;
+            points[3 * i + 1].y = y[i];
+            points[3 * i + 2].x = x[i];
+            points[3 * i + 2].y = y[i] + 1;
+        }
+        graphics_draw_points(points, count * 3, COLOR_WEATHER_SNOWFLAKE);
     }
+
+    int width = screen_width();
+    int height = screen_height();
     for (int i = 0; i < count; ++i) {
-        int drift = ((data.elements[i].y + data.elements[i].drift_offset) % 10) - 5;
-        data.elements[i].x += (drift / 10) * data.elements[i].drift_direction;
-        data.elements[i].y += data.elements[i].speed;
-
-        graphics_draw_line(
-            data.elements[i].x,
-            data.elements[i].x + 1,
-            data.elements[i].y,
-            data.elements[i].y,
-            COLOR_WEATHER_SNOWFLAKE);
-
-        graphics_draw_line(
-            data.elements[i].x,
-            data.elements[i].x,
-            data.elements[i].y,
-            data.elements[i].y + 1,
-            COLOR_WEATHER_SNOWFLAKE);
-
-        if (data.elements[i].y >= screen_height() || data.elements[i].x <= 0 || data.elements[i].x >= screen_width()) {
-            init_weather_element(&data.elements[i], data.weather_config.type);
-            data.elements[i].y = 0;
+        if (y[i] >= height || x[i] <= 0 || x[i] >= width) {
+            init_particle(i, data.weather_config.type);
+            y[i] = 0;
         }
     }
 }
 
 static void draw_sandstorm(void)
 {
-    if (!data.elements || data.displayed_intensity == 0) {
+    int count = visible_particle_count();
+    if (!count) {
         return;
     }
+    int *x = data.particles.x;
+    const int *y = data.particles.y;
+    const int *speed = data.particles.speed;
+    const int *offset = data.particles.offset;
 
-    int max_particles = data.last_elements_count;
-    int count = data.displayed_intensity;
-    if (count > max_particles) {
-        count = max_particles;
+    for (int i = 0; i < count; ++i) {
+        int wave = ((y[i] + offset[i]) % 10) - 5;
+        x[i] += speed[i] + (wave / 10);
+    }
+
+    // Each grain of sand is a two pixel diagonal
+    graphics_point *points = reserve_points(count * 2);
+    if (points) {
+        for (int i = 0; i < count; ++i) {
+            points[2 * i].x = x[i];
+            points[2 * i].y = y[i];
+            points[2 * i + 1].x = x[i] + 1;
+            points[2 * i + 1].y = y[i] + 1;
+        }
+        graphics_draw_points(points, count * 2, COLOR_WEATHER_SAND_PARTICLE);
     }
 
+    int width = screen_width();
     for (int i = 0; i < count; ++i) {
-        int wave = ((data.elements[i].y + data.elements[i].offset) % 10) - 5;
-        data.elements[i].x += data.elements[i].speed + (wave / 10);
-
-        graphics_draw_line(
-            data.elements[i].x,
-            data.elements[i].x + 1,
-            data.elements[i].y,
-            data.elements[i].y + 1,
-            COLOR_WEATHER_SAND_PARTICLE);
-
-        if (data.elements[i].x > screen_width()) {
-            init_weather_element(&data.elements[i], data.weather_config.type);
-            data.elements[i].x = 0;
+        if (x[i] > width) {
+            init_particle(i, data.weather_config.type);
+            x[i] = 0;
         }
     }
 }
 
+static int rain_drop_dx(int i)
+{
+    if (data.displayed_intensity < 600) {
+        return data.weather_config.dx;
+    } else {
+        return data.weather_config.dx + data.particles.wind_variation[i];
+    }
+}
+
+static void draw_rain_drops(int count)
+{
+    const int *x = data.particles.x;
+    const int *y = data.particles.y;
+    const int *length = data.particles.length;
+
+    int total_points = 0;
+    for (int i = 0; i < count; ++i) {
+        total_points += length[i] + 1;
+    }
+    graphics_point *points = reserve_points(total_points);
+    if (!points) {
+        return;
+    }
+    // Drops are mostly vertical, so one pixel per row gives the same result as drawing each one as a line
+    int current = 0;
+    for (int i = 0; i < count; ++i) {
+        int slant = rain_drop_dx(i) * 2;
+        int rows = length[i] > 0 ? length[i] : 1;
+        int rounding = slant < 0 ? -rows / 2 : rows / 2;
+        for (int row = 0; row <= length[i]; row++) {
+            points[current].x = x[i] + (slant * row + rounding) / rows;
+            points[current].y = y[i] + row;
+            current++;
+        }
+    }
+    graphics_draw_points(points, total_points, COLOR_WEATHER_DROPS);
+}
+
 static void draw_rain(void)
 {
-    if (!data.elements || data.displayed_intensity == 0) {
+    int count = visible_particle_count();
+    if (!count) {
         return;
     }
 
@@ -318,35 +430,33 @@ static void draw_rain(void)
     int wind_strength = abs(data.weather_config.dx);
     int base_speed = 3 + wind_strength + (data.weather_config.intensity / 300);
 
-    int max_particles = data.last_elements_count;
-    int count = data.displayed_intensity;
-    if (count > max_particles) {
-        count = max_particles;
-    }
+    draw_rain_drops(count);
 
-    for (int i = 0; i < count; ++i) {
-        int dx;
-        if (data.displayed_intensity < 600) {
-            dx = data.weather_config.dx;
-        } else {
-            dx = data.weather_config.dx + data.elements[i].wind_variation;
+    int *x = data.particles.x;
+    int *y = data.particles.y;
+    const int *speed = data.particles.speed;
+    if (data.displayed_intensity < 600) {
+        int dx = data.weather_config.dx;
+        for (int i = 0; i < count; ++i) {
+            x[i] += dx;
         }
+    } else {
+        const int *wind_variation = data.particles.wind_variation;
+        int dx = data.weather_config.dx;
+        for (int i = 0; i < count; ++i) {
+            x[i] += dx + wind_variation[i];
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        y[i] += base_speed + speed[i] + (((x[i] + y[i]) % 10) / 10);
+    }
 
-        graphics_draw_line(
-            data.elements[i].x,
-            data.elements[i].x + dx * 2,
-            data.elements[i].y,
-            data.elements[i].y + data.elements[i].length,
-            COLOR_WEATHER_DROPS);
-
-        data.elements[i].x += dx;
-
-        int dy = base_speed + data.elements[i].speed + (((data.elements[i].x + data.elements[i].y) % 10) / 10);
-        data.elements[i].y += dy;
-
-        if (data.elements[i].y >= screen_height() || data.elements[i].x <= 0 || data.elements[i].x >= screen_width()) {
-            init_weather_element(&data.elements[i], data.weather_config.type);
-            data.elements[i].y = 0;
+    int width = screen_width();
+    int height = screen_height();
+    for (int i = 0; i < count; ++i) {
+        if (y[i] >= height || x[i] <= 0 || x[i] >= width) {
+            init_particle(i, data.weather_config.type);
+            y[i] = 0;
         }
     }
 
@@ -372,20 +482,9 @@ void update_weather()
 
     int target_count = data.weather_config.intensity;
     if (target_count != data.last_elements_count && target_count > 0) {
-        if (data.elements) {
-            free(data.elements);
-            data.elements = 0;
-        }
-        data.elements = malloc(sizeof(weather_element) * target_count);
-        for (int i = 0; i < target_count; ++i) {
-            init_weather_element(&data.elements[i], data.weather_config.type);
-        }
-        data.last_elements_count = target_count;
+        data.last_elements_count = allocate_particles(target_count) ? target_count : 0;
     } else if (target_count == 0 && data.displayed_intensity == 0) {
-        if (data.elements) {
-            free(data.elements);
-            data.elements = 0;
-        }
+        free_particles();
         data.last_elements_count = 0;
     }
 
@@ -400,9 +499,9 @@ void update_weather()
 
     // init
     if (!data.weather_initialized && data.weather_config.active == 1) {
-        data.elements = malloc(sizeof(weather_element) * data.weather_config.intensity);
-        for (int i = 0; i < data.weather_config.intensity; ++i) {
-            init_weather_element(&data.elements[i], data.weather_config.type);
+        int count = data.weather_config.intensity;
+        if (!data.particle_memory || data.last_elements_count != count) {
+            data.last_elements_count = allocate_particles(count) ? count : 0;
         }
         data.weather_initialized = 1;
     }
@@ -94,7 +94,8 @@ typedef enum {
     WINDOW_ASSET_PREVIEWER,
     WINDOW_CUSTOM_MESSAGE,
     WINDOW_TEXT_INPUT,
-    WINDOW_USER_PATH_SETUP
+    WINDOW_USER_PATH_SETUP,
+    WINDOW_SKIP_AHEAD
 } window_id;
 
 typedef struct {
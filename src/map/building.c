@@ -4,10 +4,37 @@
 #include "core/config.h"
 #include "map/grid.h"
 
+#include <string.h>
+
+#define SERVICE_AREA_RADIUS 2
+#define SERVICE_AREA_MAX_BUILDINGS 25
+#define SERVICE_AREA_CACHED_BUILDINGS 16
+#define SERVICE_AREA_NOT_CACHED 0xff
+
 static grid_u16 buildings_grid;
 static grid_u8 damage_grid;
 static grid_u8 rubble_type_grid;
 
+static struct {
+    grid_u8 num_buildings; // 0 = needs to be rebuilt, otherwise the number of buildings + 1
+    uint16_t building_ids[GRID_SIZE * GRID_SIZE][SERVICE_AREA_CACHED_BUILDINGS];
+    uint8_t tiles[GRID_SIZE * GRID_SIZE][SERVICE_AREA_CACHED_BUILDINGS];
+    uint16_t uncached_building_ids[SERVICE_AREA_MAX_BUILDINGS];
+    uint8_t uncached_tiles[SERVICE_AREA_MAX_BUILDINGS];
+} service_area;
+
+static void invalidate_service_areas_around(int grid_offset)
+{
+    for (int dy = -SERVICE_AREA_RADIUS; dy <= SERVICE_AREA_RADIUS; dy++) {
+        for (int dx = -SERVICE_AREA_RADIUS; dx <= SERVICE_AREA_RADIUS; dx++) {
+            int offset = grid_offset + map_grid_delta(dx, dy);
+            if (offset >= 0 && offset < GRID_SIZE * GRID_SIZE) {
+                service_area.num_buildings.items[offset] = 0;
+            }
+        }
+    }
+}
+
 int map_building_at(int grid_offset)
 {
     return map_grid_is_valid_offset(grid_offset) ? buildings_grid.items[grid_offset] : 0;
@@ -21,6 +48,9 @@ int map_building_from_buffer(buffer *buildings, int grid_offset)
 
 void map_building_set(int grid_offset, int building_id)
 {
+    if (buildings_grid.items[grid_offset] != building_id) {
+        invalidate_service_areas_around(grid_offset);
+    }
     buildings_grid.items[grid_offset] = building_id;
 }
 
@@ -49,6 +79,7 @@ void map_building_clear(void)
     map_grid_clear_u16(buildings_grid.items);
     map_grid_clear_u8(damage_grid.items);
     map_grid_clear_u8(rubble_type_grid.items);
+    map_grid_clear_u8(service_area.num_buildings.items);
 }
 
 void map_building_save_state(buffer *buildings, buffer *damage)
@@ -61,6 +92,7 @@ void map_building_load_state(buffer *buildings, buffer *damage)
 {
     map_grid_load_state_u16(buildings_grid.items, buildings);
     map_grid_load_state_u8(damage_grid.items, damage);
+    map_grid_clear_u8(service_area.num_buildings.items);
 }
 
 int map_building_is_reservoir(int x, int y)
@@ -82,3 +114,54 @@ int map_building_is_reservoir(int x, int y)
     }
     return 1;
 }
+
+static int find_service_area_buildings(int x, int y, uint16_t *building_ids, uint8_t *tiles)
+{
+    int num_buildings = 0;
+    int x_min, y_min, x_max, y_max;
+    map_grid_get_area(x, y, 1, SERVICE_AREA_RADIUS, &x_min, &y_min, &x_max, &y_max);
+    for (int yy = y_min; yy <= y_max; yy++) {
+        for (int xx = x_min; xx <= x_max; xx++) {
+            int building_id = buildings_grid.items[map_grid_offset(xx, yy)];
+            if (!building_id) {
+                continue;
+            }
+            int index = 0;
+            while (index < num_buildings && building_ids[index] != building_id) {
+                index++;
+            }
+            if (index == num_buildings) {
+                building_ids[index] = building_id;
+                tiles[index] = 0;
+                num_buildings++;
+            }
+            tiles[index]++;
+        }
+    }
+    return num_buildings;
+}
+
+int map_building_service_area(int x, int y, const uint16_t **building_ids, const uint8_t **tiles)
+{
+    int grid_offset = map_grid_offset(x, y);
+    int cached = service_area.num_buildings.items[grid_offset];
+    if (cached && cached != SERVICE_AREA_NOT_CACHED) {
+        *building_ids = service_area.building_ids[grid_offset];
+        *tiles = service_area.tiles[grid_offset];
+        return cached - 1;
+    }
+    int num_buildings = find_service_area_buildings(x, y,
+        service_area.uncached_building_ids, service_area.uncached_tiles);
+    *building_ids = service_area.uncached_building_ids;
+    *tiles = service_area.uncached_tiles;
+    // Areas with many small buildings are not worth caching: walking the list costs as much as scanning the area
+    if (num_buildings > SERVICE_AREA_CACHED_BUILDINGS) {
+        service_area.num_buildings.items[grid_offset] = SERVICE_AREA_NOT_CACHED;
+        return num_buildings;
+    }
+    memcpy(service_area.building_ids[grid_offset], service_area.uncached_building_ids,
+        num_buildings * sizeof(uint16_t));
+    memcpy(service_area.tiles[grid_offset], service_area.uncached_tiles, num_buildings * sizeof(uint8_t));
+    service_area.num_buildings.items[grid_offset] = num_buildings + 1;
+    return num_buildings;
+}
@@ -4,6 +4,8 @@
 #include "building/type.h"
 #include "core/buffer.h"
 
+#include <stdint.h>
+
 /**
  * Returns the building at the given offset
  * @param grid_offset Map offset
@@ -39,4 +41,16 @@ void map_building_load_state(buffer *buildings, buffer *damage);
 
 int map_building_is_reservoir(int x, int y);
 
+/**
+ * Gets the distinct buildings within two tiles of the given tile, which is the area covered by service walkers.
+ * The buildings are listed in the order in which they are first found when going over the area row by row.
+ * The lists are cached per tile and updated whenever the buildings on the map change.
+ * @param x X position of the tile
+ * @param y Y position of the tile
+ * @param building_ids Set to the list of building IDs, valid until the next call
+ * @param tiles Set to the number of tiles of each building within the area, valid until the next call
+ * @return The number of buildings in the lists
+ */
+int map_building_service_area(int x, int y, const uint16_t **building_ids, const uint8_t **tiles);
+
 #endif // MAP_BUILDING_H
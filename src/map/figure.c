@@ -2,7 +2,10 @@
 
 #include "map/grid.h"
 
+// Figures on the same tile form a doubly linked list, ordered from the first figure to arrive to the last one.
+// The previous figure of the first figure is the last figure, so figures can be appended without a walk.
 static grid_u16 figures;
+static grid_u16 counts;
 
 int map_has_figure_at(int grid_offset)
 {
@@ -26,20 +29,22 @@ void map_figure_add(figure *f)
     if (!map_grid_is_valid_offset(f->grid_offset)) {
         return;
     }
-    f->figures_on_same_tile_index = 0;
+    int first_id = figures.items[f->grid_offset];
+    f->figures_on_same_tile_index = first_id ? counts.items[f->grid_offset] : 0;
     f->next_figure_id_on_same_tile = 0;
 
-    if (figures.items[f->grid_offset]) {
-        figure *next = figure_get(figures.items[f->grid_offset]);
-        f->figures_on_same_tile_index++;
-        while (next->next_figure_id_on_same_tile) {
-            next = figure_get(next->next_figure_id_on_same_tile);
-            f->figures_on_same_tile_index++;
-        }
+    if (first_id) {
+        figure *first = figure_get(first_id);
+        figure *last = figure_get(first->prev_figure_id_on_same_tile);
         cap_figures_on_same_tile_index(f);
-        next->next_figure_id_on_same_tile = f->id;
+        last->next_figure_id_on_same_tile = f->id;
+        f->prev_figure_id_on_same_tile = last->id;
+        first->prev_figure_id_on_same_tile = f->id;
+        counts.items[f->grid_offset]++;
     } else {
         figures.items[f->grid_offset] = f->id;
+        f->prev_figure_id_on_same_tile = f->id;
+        counts.items[f->grid_offset] = 1;
     }
 }
 
@@ -48,36 +53,50 @@ void map_figure_update(figure *f)
     if (!map_grid_is_valid_offset(f->grid_offset)) {
         return;
     }
-    f->figures_on_same_tile_index = 0;
-
-    figure *next = figure_get(figures.items[f->grid_offset]);
-    while (next->id) {
-        if (next->id == f->id) {
-            cap_figures_on_same_tile_index(f);
-            return;
-        }
-        f->figures_on_same_tile_index++;
-        next = figure_get(next->next_figure_id_on_same_tile);
+    // Indexes are renumbered when a figure leaves the tile, so this only keeps
+    // a figure that is not on the list of its tile within the figures on it
+    int count = counts.items[f->grid_offset];
+    if (f->figures_on_same_tile_index >= count) {
+        f->figures_on_same_tile_index = count ? count - 1 : 0;
     }
     cap_figures_on_same_tile_index(f);
 }
 
 void map_figure_delete(figure *f)
 {
-    if (!map_grid_is_valid_offset(f->grid_offset) || !figures.items[f->grid_offset]) {
+    // A figure that is not on any list has no previous figure, not even itself
+    if (!map_grid_is_valid_offset(f->grid_offset) || !figures.items[f->grid_offset] ||
+        !f->prev_figure_id_on_same_tile) {
         f->next_figure_id_on_same_tile = 0;
+        f->prev_figure_id_on_same_tile = 0;
         return;
     }
-    if (figures.items[f->grid_offset] == f->id) {
+    int first_id = figures.items[f->grid_offset];
+    int next_id = f->next_figure_id_on_same_tile;
+    if (first_id == f->id) {
         figures.items[f->grid_offset] = f->next_figure_id_on_same_tile;
+        if (f->next_figure_id_on_same_tile) {
+            figure_get(f->next_figure_id_on_same_tile)->prev_figure_id_on_same_tile = f->prev_figure_id_on_same_tile;
+        }
     } else {
-        figure *prev = figure_get(figures.items[f->grid_offset]);
-        while (prev->id && prev->next_figure_id_on_same_tile != f->id) {
-            prev = figure_get(prev->next_figure_id_on_same_tile);
+        figure_get(f->prev_figure_id_on_same_tile)->next_figure_id_on_same_tile = f->next_figure_id_on_same_tile;
+        if (f->next_figure_id_on_same_tile) {
+            figure_get(f->next_figure_id_on_same_tile)->prev_figure_id_on_same_tile = f->prev_figure_id_on_same_tile;
+        } else {
+            figure_get(first_id)->prev_figure_id_on_same_tile = f->prev_figure_id_on_same_tile;
         }
-        prev->next_figure_id_on_same_tile = f->next_figure_id_on_same_tile;
+    }
+    if (counts.items[f->grid_offset]) {
+        counts.items[f->grid_offset]--;
+    }
+    // The figures that arrived later move forward one place, except those beyond the capped index
+    for (int index = f->figures_on_same_tile_index; next_id && index < 20; index++) {
+        figure *next = figure_get(next_id);
+        next->figures_on_same_tile_index = index;
+        next_id = next->next_figure_id_on_same_tile;
     }
     f->next_figure_id_on_same_tile = 0;
+    f->prev_figure_id_on_same_tile = 0;
 }
 
 int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f))
@@ -99,6 +118,7 @@ int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f))
 void map_figure_clear(void)
 {
     map_grid_clear_u16(figures.items);
+    map_grid_clear_u16(counts.items);
 }
 
 void map_figure_save_state(buffer *buf)
@@ -109,4 +129,56 @@ void map_figure_save_state(buffer *buf)
 void map_figure_load_state(buffer *buf)
 {
     map_grid_load_state_u16(figures.items, buf);
+    map_grid_clear_u16(counts.items);
+}
+
+void map_figure_restore_links(void)
+{
+    int max_steps = figure_count();
+    // Only the next figure is saved. Figures that are listed on a tile other than their own are
+    // moved to their own tile, since removing a figure from a list relies on its grid offset.
+    for (int grid_offset = 0; grid_offset < GRID_SIZE * GRID_SIZE; grid_offset++) {
+        counts.items[grid_offset] = 0;
+        if (!figures.items[grid_offset]) {
+            continue;
+        }
+        figure *last = 0;
+        int figure_id = figures.items[grid_offset];
+        for (int steps = 0; figure_id > 0 && figure_id < max_steps && steps < max_steps; steps++) {
+            figure *f = figure_get(figure_id);
+            figure_id = f->next_figure_id_on_same_tile;
+            if (f->prev_figure_id_on_same_tile) {
+                continue; // Already listed on an earlier tile
+            }
+            if (f->grid_offset != grid_offset || !f->state) {
+                // Marks the figure to be added to its own tile once all lists are rebuilt
+                f->prev_figure_id_on_same_tile = -1;
+                f->next_figure_id_on_same_tile = 0;
+                continue;
+            }
+            if (last) {
+                last->next_figure_id_on_same_tile = f->id;
+                f->prev_figure_id_on_same_tile = last->id;
+            } else {
+                figures.items[grid_offset] = f->id;
+            }
+            f->next_figure_id_on_same_tile = 0;
+            f->figures_on_same_tile_index = counts.items[grid_offset];
+            cap_figures_on_same_tile_index(f);
+            last = f;
+            counts.items[grid_offset]++;
+        }
+        if (last) {
+            figure_get(figures.items[grid_offset])->prev_figure_id_on_same_tile = last->id;
+        } else {
+            figures.items[grid_offset] = 0;
+        }
+    }
+    for (int i = 1; i < max_steps; i++) {
+        figure *f = figure_get(i);
+        if (f->prev_figure_id_on_same_tile == -1) {
+            f->prev_figure_id_on_same_tile = 0;
+            map_figure_add(f);
+        }
+    }
 }
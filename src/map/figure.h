@@ -35,4 +35,10 @@ void map_figure_save_state(buffer *buf);
 
 void map_figure_load_state(buffer *buf);
 
+/**
+ * Restores the links to the previous figure on the same tile, which are not saved.
+ * Must be called after both the figure grid and the figures have been loaded.
+ */
+void map_figure_restore_links(void);
+
 #endif // MAP_FIGURE_H
@@ -285,23 +285,23 @@ void map_grid_save_state_i8(const int8_t *grid, buffer *buf)
 
 void map_grid_save_state_u16(const uint16_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        buffer_write_u16(buf, grid[i]);
-    }
+    buffer_write_u16_array(buf, grid, GRID_SIZE * GRID_SIZE);
 }
 
 void map_grid_save_state_u32_to_u16(const uint32_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        buffer_write_u16(buf, (uint16_t) grid[i]);
+    uint16_t row[GRID_SIZE];
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            row[x] = (uint16_t) grid[y * GRID_SIZE + x];
+        }
+        buffer_write_u16_array(buf, row, GRID_SIZE);
     }
 }
 
 void map_grid_save_state_u32(const uint32_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        buffer_write_u32(buf, grid[i]);
-    }
+    buffer_write_u32_array(buf, grid, GRID_SIZE * GRID_SIZE);
 }
 
 void map_grid_load_state_u8(uint8_t *grid, buffer *buf)
@@ -316,21 +316,21 @@ void map_grid_load_state_i8(int8_t *grid, buffer *buf)
 
 void map_grid_load_state_u16(uint16_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] = buffer_read_u16(buf);
-    }
+    buffer_read_u16_array(buf, grid, GRID_SIZE * GRID_SIZE);
 }
 
 void map_grid_load_state_u16_to_u32(uint32_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] = buffer_read_u16(buf);
+    uint16_t row[GRID_SIZE];
+    for (int y = 0; y < GRID_SIZE; y++) {
+        buffer_read_u16_array(buf, row, GRID_SIZE);
+        for (int x = 0; x < GRID_SIZE; x++) {
+            grid[y * GRID_SIZE + x] = row[x];
+        }
     }
 }
 
 void map_grid_load_state_u32(uint32_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] = buffer_read_u32(buf);
-    }
+    buffer_read_u32_array(buf, grid, GRID_SIZE * GRID_SIZE);
 }
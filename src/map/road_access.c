@@ -14,6 +14,8 @@
 #include "map/terrain.h"
 #include "map/tiles.h"
 
+static unsigned int road_access_version;
+
 static void find_minimum_road_tile(int x, int y, int size, int *min_value, int *min_grid_offset)
 {
     int base_offset = map_grid_offset(x, y);
@@ -40,6 +42,16 @@ int map_has_road_access(int x, int y, int size, map_point *road)
     return map_has_road_access_rotation(0, x, y, size, road);
 }
 
+void map_road_access_invalidate(void)
+{
+    road_access_version++;
+}
+
+unsigned int map_road_access_version(void)
+{
+    return road_access_version;
+}
+
 void map_update_granary_internal_roads(const building *b)
 {
     int cx = b->x + 1; // Center of the granary
@@ -6,6 +6,17 @@
 
 int map_has_road_access(int x, int y, int size, map_point *road);
 
+/**
+ * Notes that the road access of buildings may have changed, because roads, buildings or road networks changed
+ */
+void map_road_access_invalidate(void);
+
+/**
+ * Gets a number that changes whenever the road access of buildings may have changed
+ * @return Road access version
+ */
+unsigned int map_road_access_version(void);
+
 int map_has_road_access_rotation(int rotation, int x, int y, int size, map_point *road);
 
 int map_has_road_access_hippodrome(int x, int y, map_point *road);
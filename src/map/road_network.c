@@ -3,6 +3,7 @@
 #include "city/map.h"
 #include "map/data.h"
 #include "map/grid.h"
+#include "map/road_access.h"
 #include "map/routing_terrain.h"
 #include "map/terrain.h"
 
@@ -13,6 +14,7 @@
 static const int ADJACENT_OFFSETS[] = {-GRID_SIZE, 1, GRID_SIZE, -1};
 
 static grid_u8 network;
+static unsigned int network_checked_version;
 
 static struct {
     int items[MAX_QUEUE];
@@ -92,4 +94,10 @@ void map_road_network_update(void)
             }
         }
     }
+    // The networks only differ from the last update when the terrain changed in between. Road access may change
+    // again now that the roads built since then belong to a network.
+    if (network_checked_version != map_road_access_version()) {
+        map_road_access_invalidate();
+        network_checked_version = map_road_access_version();
+    }
 }
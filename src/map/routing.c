@@ -1,6 +1,7 @@
 #include "routing.h"
 
 #include "building/building.h"
+#include "core/log.h"
 #include "core/time.h"
 #include "map/building.h"
 #include "map/figure.h"
@@ -37,68 +38,100 @@ static const int HIGHWAY_DIRECTIONS[] = {
     0
 };
 
-static map_routing_distance_grid distance;
+struct routing_context {
+    map_routing_distance_grid distance;
+    struct {
+        int head;
+        int tail;
+        int items[MAX_QUEUE];
+    } queue;
+    grid_u8 water_drag;
+    struct {
+        grid_u8 status;
+        time_millis last_check;
+    } fighting_data;
+    struct {
+        int through_building_id;
+        int dest_building_id;
+    } state;
+    struct {
+        int total_routes_calculated;
+        int enemy_routes_calculated;
+    } stats;
+};
 
-static struct {
-    int total_routes_calculated;
-    int enemy_routes_calculated;
-} stats;
+static routing_context default_context;
 
-static struct {
-    int head;
-    int tail;
-    int items[MAX_QUEUE];
-} queue;
+static void reset_fighting_status(routing_context *ctx)
+{
+    time_millis current_time = time_get_millis();
+    if (current_time != ctx->fighting_data.last_check) {
+        map_grid_clear_u8(ctx->fighting_data.status.items);
+        ctx->fighting_data.last_check = current_time;
+    }
+}
 
-static grid_u8 water_drag;
+routing_context *map_routing_context_create(void)
+{
+    routing_context *ctx = calloc(1, sizeof(routing_context));
+    if (!ctx) {
+        log_error("Unable to allocate memory for a routing context", 0, 0);
+    }
+    return ctx;
+}
 
-static struct {
-    grid_u8 status;
-    time_millis last_check;
-} fighting_data;
+routing_context *map_routing_get_default_context(void)
+{
+    return &default_context;
+}
 
-static struct {
-    int through_building_id;
-    int dest_building_id;
-} state;
+void map_routing_context_free(routing_context *ctx)
+{
+    free(ctx);
+}
 
-static void reset_fighting_status(void)
+void map_routing_context_clear_cache(routing_context *ctx)
 {
-    time_millis current_time = time_get_millis();
-    if (current_time != fighting_data.last_check) {
-        map_grid_clear_u8(fighting_data.status.items);
-        fighting_data.last_check = current_time;
-    }
+    map_grid_clear_u8(ctx->fighting_data.status.items);
+    ctx->fighting_data.last_check = time_get_millis();
+}
+
+void map_routing_context_merge_stats(routing_context *ctx)
+{
+    default_context.stats.total_routes_calculated += ctx->stats.total_routes_calculated;
+    default_context.stats.enemy_routes_calculated += ctx->stats.enemy_routes_calculated;
+    ctx->stats.total_routes_calculated = 0;
+    ctx->stats.enemy_routes_calculated = 0;
 }
 
 const map_routing_distance_grid *map_routing_get_distance_grid(void)
 {
-    return &distance;
+    return &default_context.distance;
 }
 
-static void clear_data(void)
+static void clear_data(routing_context *ctx)
 {
-    reset_fighting_status();
-    map_grid_clear_i16(distance.possible.items);
-    map_grid_clear_i16(distance.determined.items);
-    queue.head = 0;
-    queue.tail = 0;
+    reset_fighting_status(ctx);
+    map_grid_clear_i16(ctx->distance.possible.items);
+    map_grid_clear_i16(ctx->distance.determined.items);
+    ctx->queue.head = 0;
+    ctx->queue.tail = 0;
 }
 
-static inline void enqueue(int next_offset, int dist)
+static inline void enqueue(routing_context *ctx, int next_offset, int dist)
 {
-    distance.determined.items[next_offset] = dist;
-    queue.items[queue.tail++] = next_offset;
-    if (queue.tail >= MAX_QUEUE) {
-        queue.tail = 0;
+    ctx->distance.determined.items[next_offset] = dist;
+    ctx->queue.items[ctx->queue.tail++] = next_offset;
+    if (ctx->queue.tail >= MAX_QUEUE) {
+        ctx->queue.tail = 0;
     }
 }
 
-static inline int queue_pop(void)
+static inline int queue_pop(routing_context *ctx)
 {
-    int result = queue.items[queue.head];
-    if (++queue.head >= MAX_QUEUE) {
-        queue.head = 0;
+    int result = ctx->queue.items[ctx->queue.head];
+    if (++ctx->queue.head >= MAX_QUEUE) {
+        ctx->queue.head = 0;
     }
     return result;
 }
@@ -108,86 +141,86 @@ static inline int ordered_queue_parent(int index)
     return (index - 1) / 2;
 }
 
-static inline void ordered_queue_swap(int first, int second)
+static inline void ordered_queue_swap(routing_context *ctx, int first, int second)
 {
-    int temp = queue.items[first];
-    queue.items[first] = queue.items[second];
-    queue.items[second] = temp;
+    int temp = ctx->queue.items[first];
+    ctx->queue.items[first] = ctx->queue.items[second];
+    ctx->queue.items[second] = temp;
 }
 
-static void ordered_queue_reorder(int start_index)
+static void ordered_queue_reorder(routing_context *ctx, int start_index)
 {
     int left_child = 2 * start_index + 1;
-    if (left_child >= queue.tail) {
+    if (left_child >= ctx->queue.tail) {
         return;
     }
     int right_child = left_child + 1;
     int smallest = start_index;
-    int16_t *offset_smallest = &distance.possible.items[queue.items[smallest]];
-    if (distance.possible.items[queue.items[left_child]] < *offset_smallest) {
+    int16_t *offset_smallest = &ctx->distance.possible.items[ctx->queue.items[smallest]];
+    if (ctx->distance.possible.items[ctx->queue.items[left_child]] < *offset_smallest) {
         smallest = left_child;
-        offset_smallest = &distance.possible.items[queue.items[smallest]];
+        offset_smallest = &ctx->distance.possible.items[ctx->queue.items[smallest]];
     }
-    if (right_child < queue.tail &&
-        distance.possible.items[queue.items[right_child]] < *offset_smallest) {
+    if (right_child < ctx->queue.tail &&
+        ctx->distance.possible.items[ctx->queue.items[right_child]] < *offset_smallest) {
         smallest = right_child;
     }
     if (smallest != start_index) {
-        ordered_queue_swap(start_index, smallest);
-        ordered_queue_reorder(smallest);
+        ordered_queue_swap(ctx, start_index, smallest);
+        ordered_queue_reorder(ctx, smallest);
     }
 }
 
-static inline int ordered_queue_pop(void)
+static inline int ordered_queue_pop(routing_context *ctx)
 {
-    int min = queue.items[0];
-    queue.items[0] = queue.items[--queue.tail];
-    ordered_queue_reorder(0);
+    int min = ctx->queue.items[0];
+    ctx->queue.items[0] = ctx->queue.items[--ctx->queue.tail];
+    ordered_queue_reorder(ctx, 0);
     return min;
 }
 
-static inline void ordered_queue_reduce_index(int index, int offset, int dist)
+static inline void ordered_queue_reduce_index(routing_context *ctx, int index, int offset, int dist)
 {
-    queue.items[index] = offset;
-    while (index && distance.possible.items[queue.items[ordered_queue_parent(index)]] > dist) {
-        ordered_queue_swap(index, ordered_queue_parent(index));
+    ctx->queue.items[index] = offset;
+    while (index && ctx->distance.possible.items[ctx->queue.items[ordered_queue_parent(index)]] > dist) {
+        ordered_queue_swap(ctx, index, ordered_queue_parent(index));
         index = ordered_queue_parent(index);
     }
 }
 
-static void ordered_enqueue(int next_offset, int current_dist, int remaining_dist)
+static void ordered_enqueue(routing_context *ctx, int next_offset, int current_dist, int remaining_dist)
 {
     int possible_dist = remaining_dist + current_dist;
-    int index = queue.tail;
-    if (distance.possible.items[next_offset]) {
-        if (distance.possible.items[next_offset] <= possible_dist) {
+    int index = ctx->queue.tail;
+    if (ctx->distance.possible.items[next_offset]) {
+        if (ctx->distance.possible.items[next_offset] <= possible_dist) {
             return;
         } else {
-            for (int i = 0; i < queue.tail; i++) {
-                if (queue.items[i] == next_offset) {
+            for (int i = 0; i < ctx->queue.tail; i++) {
+                if (ctx->queue.items[i] == next_offset) {
                     index = i;
                     break;
                 }
             }
         }
     } else {
-        queue.tail++;
+        ctx->queue.tail++;
     }
-    distance.determined.items[next_offset] = current_dist;
-    distance.possible.items[next_offset] = possible_dist;
+    ctx->distance.determined.items[next_offset] = current_dist;
+    ctx->distance.possible.items[next_offset] = possible_dist;
 
-    ordered_queue_reduce_index(index, next_offset, possible_dist);
+    ordered_queue_reduce_index(ctx, index, next_offset, possible_dist);
 }
 
-static inline int valid_offset(int grid_offset, int possible_dist)
+static inline int valid_offset(routing_context *ctx, int grid_offset, int possible_dist)
 {
-    int determined = distance.determined.items[grid_offset];
+    int determined = ctx->distance.determined.items[grid_offset];
     return map_grid_is_valid_offset(grid_offset) && (determined == 0 || possible_dist < determined);
 }
 
-static inline int distance_left(int x, int y)
+static inline int distance_left(routing_context *ctx, int x, int y)
 {
-    return abs(distance.dst_x - x) + abs(distance.dst_y - y);
+    return abs(ctx->distance.dst_x - x) + abs(ctx->distance.dst_y - y);
 }
 
 static int receive_highway_bonus(int offset, int direction)
@@ -199,63 +232,63 @@ static int receive_highway_bonus(int offset, int direction)
     return 0;
 }
 
-static void route_queue_from_to(int src_x, int src_y, int dst_x, int dst_y, int num_directions, int max_tiles,
-    int (*callback)(int offset, int next_offset, int direction))
+static void route_queue_from_to(routing_context *ctx, int src_x, int src_y, int dst_x, int dst_y,
+    int num_directions, int max_tiles, int (*callback)(routing_context *ctx, int offset, int next_offset, int direction))
 {
-    clear_data();
-    distance.dst_x = dst_x;
-    distance.dst_y = dst_y;
+    clear_data(ctx);
+    ctx->distance.dst_x = dst_x;
+    ctx->distance.dst_y = dst_y;
     int dest = map_grid_offset(dst_x, dst_y);
-    ordered_enqueue(map_grid_offset(src_x, src_y), 1, 0);
+    ordered_enqueue(ctx, map_grid_offset(src_x, src_y), 1, 0);
     int tiles = 0;
-    while (queue.tail) {
-        int offset = ordered_queue_pop();
+    while (ctx->queue.tail) {
+        int offset = ordered_queue_pop(ctx);
         if (offset == dest || (max_tiles && ++tiles > max_tiles)) {
             break;
         }
         int x = map_grid_offset_to_x(offset);
         int y = map_grid_offset_to_y(offset);
-        distance.possible.items[offset] = 1;
+        ctx->distance.possible.items[offset] = 1;
         for (int i = 0; i < num_directions; i++) {
             int next_offset = offset + ROUTE_OFFSETS[i];
-            int remaining_dist = distance_left(x + ROUTE_OFFSETS_X[i], y + ROUTE_OFFSETS_Y[i]);
-            int dist = 2 + distance.determined.items[offset];
+            int remaining_dist = distance_left(ctx, x + ROUTE_OFFSETS_X[i], y + ROUTE_OFFSETS_Y[i]);
+            int dist = 2 + ctx->distance.determined.items[offset];
             if (receive_highway_bonus(next_offset, i)) {
                 dist--;
             }
-            if (valid_offset(next_offset, dist) && callback(offset, next_offset, i)) {
-                ordered_enqueue(next_offset, dist, remaining_dist);
+            if (valid_offset(ctx, next_offset, dist) && callback(ctx, offset, next_offset, i)) {
+                ordered_enqueue(ctx, next_offset, dist, remaining_dist);
             }
         }
     }
 }
 
-static void route_queue_all_from(int source, max_directions directions,
-    int (*callback)(int next_offset, int dist, int direction), int is_boat)
+static void route_queue_all_from(routing_context *ctx, int source, max_directions directions,
+    int (*callback)(routing_context *ctx, int next_offset, int dist, int direction), int is_boat)
 {
-    clear_data();
-    map_grid_clear_u8(water_drag.items);
-    enqueue(source, 1);
+    clear_data(ctx);
+    map_grid_clear_u8(ctx->water_drag.items);
+    enqueue(ctx, source, 1);
     int tiles = 0;
-    while (queue.head != queue.tail) {
+    while (ctx->queue.head != ctx->queue.tail) {
         if (++tiles > GUARD) {
             break;
         }
-        int offset = queue_pop();
+        int offset = queue_pop(ctx);
         int drag = is_boat && terrain_water.items[offset] == WATER_N2_MAP_EDGE ? 4 : 0;
-        if (water_drag.items[offset] < drag) {
-            water_drag.items[offset]++;
-            queue.items[queue.tail++] = offset;
-            if (queue.tail >= MAX_QUEUE) {
-                queue.tail = 0;
+        if (ctx->water_drag.items[offset] < drag) {
+            ctx->water_drag.items[offset]++;
+            ctx->queue.items[ctx->queue.tail++] = offset;
+            if (ctx->queue.tail >= MAX_QUEUE) {
+                ctx->queue.tail = 0;
             }
         } else {
-            int dist = 1 + distance.determined.items[offset];
+            int dist = 1 + ctx->distance.determined.items[offset];
             for (max_directions i = 0; i < directions; i++) {
                 int route_offset = ROUTE_OFFSETS[i];
                 int next_offset = offset + route_offset;
-                if (valid_offset(next_offset, dist)) {
-                    if (callback(next_offset, dist, i) == UNTIL_STOP) {
+                if (valid_offset(ctx, next_offset, dist)) {
+                    if (callback(ctx, next_offset, dist, i) == UNTIL_STOP) {
                         break;
                     }
                 }
@@ -264,64 +297,75 @@ static void route_queue_all_from(int source, max_directions directions,
     }
 }
 
-static int callback_calc_distance(int next_offset, int dist, int direction)
+static int callback_calc_distance(routing_context *ctx, int next_offset, int dist, int direction)
 {
     if (terrain_land_citizen.items[next_offset] >= CITIZEN_0_ROAD) {
-        enqueue(next_offset, dist);
+        enqueue(ctx, next_offset, dist);
     }
     return 1;
 }
 
 void map_routing_calculate_distances(int x, int y)
 {
-    ++stats.total_routes_calculated;
-    route_queue_all_from(map_grid_offset(x, y), DIRECTIONS_NO_DIAGONALS, callback_calc_distance, 0);
+    routing_context *ctx = &default_context;
+    ++ctx->stats.total_routes_calculated;
+    route_queue_all_from(ctx, map_grid_offset(x, y), DIRECTIONS_NO_DIAGONALS, callback_calc_distance, 0);
 }
 
-static int callback_calc_distance_water_boat(int next_offset, int dist, int direction)
+static int callback_calc_distance_water_boat(routing_context *ctx, int next_offset, int dist, int direction)
 {
     if (terrain_water.items[next_offset] != WATER_N1_BLOCKED &&
         terrain_water.items[next_offset] != WATER_N3_LOW_BRIDGE) {
-        enqueue(next_offset, dist);
+        enqueue(ctx, next_offset, dist);
         if (terrain_water.items[next_offset] == WATER_N2_MAP_EDGE) {
-            distance.determined.items[next_offset] += 4;
+            ctx->distance.determined.items[next_offset] += 4;
         }
     }
     return 1;
 }
 
-void map_routing_calculate_distances_water_boat(int x, int y)
+void map_routing_context_calculate_distances_water_boat(routing_context *ctx, int x, int y)
 {
     int grid_offset = map_grid_offset(x, y);
     if (terrain_water.items[grid_offset] == WATER_N1_BLOCKED) {
-        clear_data();
+        clear_data(ctx);
     } else {
-        route_queue_all_from(grid_offset, DIRECTIONS_NO_DIAGONALS, callback_calc_distance_water_boat, 1);
+        route_queue_all_from(ctx, grid_offset, DIRECTIONS_NO_DIAGONALS, callback_calc_distance_water_boat, 1);
     }
 }
 
-static int callback_calc_distance_water_flotsam(int next_offset, int dist, int direction)
+void map_routing_calculate_distances_water_boat(int x, int y)
+{
+    map_routing_context_calculate_distances_water_boat(&default_context, x, y);
+}
+
+static int callback_calc_distance_water_flotsam(routing_context *ctx, int next_offset, int dist, int direction)
 {
     if (terrain_water.items[next_offset] != WATER_N1_BLOCKED) {
-        enqueue(next_offset, dist);
+        enqueue(ctx, next_offset, dist);
     }
     return 1;
 }
 
-void map_routing_calculate_distances_water_flotsam(int x, int y)
+void map_routing_context_calculate_distances_water_flotsam(routing_context *ctx, int x, int y)
 {
     int grid_offset = map_grid_offset(x, y);
     if (terrain_water.items[grid_offset] == WATER_N1_BLOCKED) {
-        clear_data();
+        clear_data(ctx);
     } else {
-        route_queue_all_from(grid_offset, DIRECTIONS_DIAGONALS, callback_calc_distance_water_flotsam, 0);
+        route_queue_all_from(ctx, grid_offset, DIRECTIONS_DIAGONALS, callback_calc_distance_water_flotsam, 0);
     }
 }
 
-static int callback_calc_distance_build_wall(int next_offset, int dist, int direction)
+void map_routing_calculate_distances_water_flotsam(int x, int y)
+{
+    map_routing_context_calculate_distances_water_flotsam(&default_context, x, y);
+}
+
+static int callback_calc_distance_build_wall(routing_context *ctx, int next_offset, int dist, int direction)
 {
     if (terrain_land_citizen.items[next_offset] == CITIZEN_4_CLEAR_TERRAIN) {
-        enqueue(next_offset, dist);
+        enqueue(ctx, next_offset, dist);
     }
     return 1;
 }
@@ -344,21 +388,21 @@ static int can_build_highway(int next_offset, int check_highway_routing)
     return 1;
 }
 
-static int callback_calc_distance_build_highway(int next_offset, int dist, int direction)
+static int callback_calc_distance_build_highway(routing_context *ctx, int next_offset, int dist, int direction)
 {
     if (can_build_highway(next_offset, 1)) {
-        enqueue(next_offset, dist);
+        enqueue(ctx, next_offset, dist);
     }
     return 1;
 }
 
-static int callback_calc_distance_build_road(int next_offset, int dist, int direction)
+static int callback_calc_distance_build_road(routing_context *ctx, int next_offset, int dist, int direction)
 {
     int blocked = 0;
     switch (terrain_land_citizen.items[next_offset]) {
         case CITIZEN_N3_AQUEDUCT:
             if (!map_can_place_road_under_aqueduct(next_offset)) {
-                distance.determined.items[next_offset] = -1;
+                ctx->distance.determined.items[next_offset] = -1;
                 blocked = 1;
             }
             break;
@@ -373,12 +417,12 @@ static int callback_calc_distance_build_road(int next_offset, int dist, int dire
             break;
     }
     if (!blocked) {
-        enqueue(next_offset, dist);
+        enqueue(ctx, next_offset, dist);
     }
     return 1;
 }
 
-static int callback_calc_distance_build_aqueduct(int next_offset, int dist, int direction)
+static int callback_calc_distance_build_aqueduct(routing_context *ctx, int next_offset, int dist, int direction)
 {
     // check for existing highway/aqueduct tiles that won't work with this one
     if (!map_can_place_aqueduct_on_highway(next_offset, 1)) {
@@ -401,11 +445,11 @@ static int callback_calc_distance_build_aqueduct(int next_offset, int dist, int
             break;
     }
     if (map_terrain_is(next_offset, TERRAIN_ROAD) && !map_can_place_aqueduct_on_road(next_offset)) {
-        distance.determined.items[next_offset] = -1;
+        ctx->distance.determined.items[next_offset] = -1;
         blocked = 1;
     }
     if (!blocked) {
-        enqueue(next_offset, dist);
+        enqueue(ctx, next_offset, dist);
     }
     return 1;
 }
@@ -463,19 +507,20 @@ static int map_can_place_initial_road_or_aqueduct(int grid_offset, int is_aquedu
 
 int map_routing_calculate_distances_for_building(routed_building_type type, int x, int y)
 {
+    routing_context *ctx = &default_context;
     int source_offset = map_grid_offset(x, y);
     if (type == ROUTED_BUILDING_WALL) {
-        route_queue_all_from(source_offset, DIRECTIONS_NO_DIAGONALS, callback_calc_distance_build_wall, 0);
+        route_queue_all_from(ctx, source_offset, DIRECTIONS_NO_DIAGONALS, callback_calc_distance_build_wall, 0);
         return 1;
     }
 
-    clear_data();
+    clear_data(ctx);
 
     if (type == ROUTED_BUILDING_HIGHWAY) {
         if (!can_build_highway(source_offset, 0)) {
             return 0;
         }
-        route_queue_all_from(source_offset, DIRECTIONS_NO_DIAGONALS, callback_calc_distance_build_highway, 0);
+        route_queue_all_from(ctx, source_offset, DIRECTIONS_NO_DIAGONALS, callback_calc_distance_build_highway, 0);
         return 1;
     }
     if (type == BUILDING_DRAGGABLE_RESERVOIR) {
@@ -493,16 +538,16 @@ int map_routing_calculate_distances_for_building(routed_building_type type, int
         type != ROUTED_BUILDING_ROAD && !map_can_place_aqueduct_on_road(source_offset)) {
         return 0;
     }
-    ++stats.total_routes_calculated;
+    ++ctx->stats.total_routes_calculated;
     if (type == ROUTED_BUILDING_ROAD) {
-        route_queue_all_from(source_offset, DIRECTIONS_NO_DIAGONALS, callback_calc_distance_build_road, 0);
+        route_queue_all_from(ctx, source_offset, DIRECTIONS_NO_DIAGONALS, callback_calc_distance_build_road, 0);
     } else {
-        route_queue_all_from(source_offset, DIRECTIONS_NO_DIAGONALS, callback_calc_distance_build_aqueduct, 0);
+        route_queue_all_from(ctx, source_offset, DIRECTIONS_NO_DIAGONALS, callback_calc_distance_build_aqueduct, 0);
     }
     return 1;
 }
 
-static int callback_delete_wall_aqueduct(int next_offset, int dist, int direction)
+static int callback_delete_wall_aqueduct(routing_context *ctx, int next_offset, int dist, int direction)
 {
     if (terrain_land_citizen.items[next_offset] < CITIZEN_0_ROAD) {
         if (map_terrain_is(next_offset, TERRAIN_AQUEDUCT | TERRAIN_WALL)) {
@@ -510,15 +555,16 @@ static int callback_delete_wall_aqueduct(int next_offset, int dist, int directio
             return UNTIL_STOP;
         }
     } else {
-        enqueue(next_offset, dist);
+        enqueue(ctx, next_offset, dist);
     }
     return UNTIL_CONTINUE;
 }
 
 void map_routing_delete_first_wall_or_aqueduct(int x, int y)
 {
-    ++stats.total_routes_calculated;
-    route_queue_all_from(map_grid_offset(x, y), DIRECTIONS_NO_DIAGONALS, callback_delete_wall_aqueduct, 0);
+    routing_context *ctx = &default_context;
+    ++ctx->stats.total_routes_calculated;
+    route_queue_all_from(ctx, map_grid_offset(x, y), DIRECTIONS_NO_DIAGONALS, callback_delete_wall_aqueduct, 0);
 }
 
 static int is_fighting_friendly(figure *f)
@@ -526,12 +572,12 @@ static int is_fighting_friendly(figure *f)
     return f->is_friendly && f->action_state == FIGURE_ACTION_150_ATTACK;
 }
 
-static inline int has_fighting_friendly(int grid_offset)
+static inline int has_fighting_friendly(routing_context *ctx, int grid_offset)
 {
-    if (!(fighting_data.status.items[grid_offset] & 0x80)) {
-        fighting_data.status.items[grid_offset] |= 0x80 | map_figure_foreach_until(grid_offset, is_fighting_friendly);
+    if (!(ctx->fighting_data.status.items[grid_offset] & 0x80)) {
+        ctx->fighting_data.status.items[grid_offset] |= 0x80 | map_figure_foreach_until(grid_offset, is_fighting_friendly);
     }
-    return fighting_data.status.items[grid_offset] & 1;
+    return ctx->fighting_data.status.items[grid_offset] & 1;
 }
 
 static int is_fighting_enemy(figure *f)
@@ -539,30 +585,36 @@ static int is_fighting_enemy(figure *f)
     return !f->is_friendly && f->action_state == FIGURE_ACTION_150_ATTACK;
 }
 
-static inline int has_fighting_enemy(int grid_offset)
+static inline int has_fighting_enemy(routing_context *ctx, int grid_offset)
 {
-    if (!(fighting_data.status.items[grid_offset] & 0x40)) {
-        fighting_data.status.items[grid_offset] |= 0x40 | (map_figure_foreach_until(grid_offset, is_fighting_enemy) << 1);
+    if (!(ctx->fighting_data.status.items[grid_offset] & 0x40)) {
+        ctx->fighting_data.status.items[grid_offset] |= 0x40 | (map_figure_foreach_until(grid_offset, is_fighting_enemy) << 1);
     }
-    return fighting_data.status.items[grid_offset] & 2;
+    return ctx->fighting_data.status.items[grid_offset] & 2;
 }
 
-static int callback_travel_citizen_land(int offset, int next_offset, int direction)
+static int callback_travel_citizen_land(routing_context *ctx, int offset, int next_offset, int direction)
 {
-    if (terrain_land_citizen.items[next_offset] >= 0 && !has_fighting_friendly(next_offset)) {
+    if (terrain_land_citizen.items[next_offset] >= 0 && !has_fighting_friendly(ctx, next_offset)) {
         return 1;
     }
     return 0;
 }
 
+int map_routing_context_citizen_can_travel_over_land(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions)
+{
+    ++ctx->stats.total_routes_calculated;
+    route_queue_from_to(ctx, src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_citizen_land);
+    return ctx->distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+}
+
 int map_routing_citizen_can_travel_over_land(int src_x, int src_y, int dst_x, int dst_y, int num_directions)
 {
-    ++stats.total_routes_calculated;
-    route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_citizen_land);
-    return distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+    return map_routing_context_citizen_can_travel_over_land(&default_context, src_x, src_y, dst_x, dst_y, num_directions);
 }
 
-static int callback_travel_citizen_road_garden(int offset, int next_offset, int direction)
+static int callback_travel_citizen_road_garden(routing_context *ctx, int offset, int next_offset, int direction)
 {
     if (terrain_land_citizen.items[next_offset] == CITIZEN_0_ROAD ||
         terrain_land_citizen.items[next_offset] == CITIZEN_2_PASSABLE_TERRAIN) {
@@ -571,19 +623,25 @@ static int callback_travel_citizen_road_garden(int offset, int next_offset, int
     return 0;
 }
 
-int map_routing_citizen_can_travel_over_road_garden(int src_x, int src_y, int dst_x, int dst_y, int num_directions)
+int map_routing_context_citizen_can_travel_over_road_garden(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions)
 {
     int dst_offset = map_grid_offset(dst_x, dst_y);
     if (terrain_land_citizen.items[dst_offset] != CITIZEN_0_ROAD &&
         terrain_land_citizen.items[dst_offset] != CITIZEN_2_PASSABLE_TERRAIN) {
         return 0;
     }
-    ++stats.total_routes_calculated;
-    route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_citizen_road_garden);
-    return distance.determined.items[dst_offset] != 0;
+    ++ctx->stats.total_routes_calculated;
+    route_queue_from_to(ctx, src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_citizen_road_garden);
+    return ctx->distance.determined.items[dst_offset] != 0;
 }
 
-static int callback_travel_citizen_road_garden_highway(int offset, int next_offset, int direction)
+int map_routing_citizen_can_travel_over_road_garden(int src_x, int src_y, int dst_x, int dst_y, int num_directions)
+{
+    return map_routing_context_citizen_can_travel_over_road_garden(&default_context, src_x, src_y, dst_x, dst_y, num_directions);
+}
+
+static int callback_travel_citizen_road_garden_highway(routing_context *ctx, int offset, int next_offset, int direction)
 {
     if (terrain_land_citizen.items[next_offset] >= CITIZEN_0_ROAD &&
         terrain_land_citizen.items[next_offset] <= CITIZEN_2_PASSABLE_TERRAIN) {
@@ -592,19 +650,25 @@ static int callback_travel_citizen_road_garden_highway(int offset, int next_offs
     return 0;
 }
 
-int map_routing_citizen_can_travel_over_road_garden_highway(int src_x, int src_y, int dst_x, int dst_y, int num_directions)
+int map_routing_context_citizen_can_travel_over_road_garden_highway(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions)
 {
     int dst_offset = map_grid_offset(dst_x, dst_y);
     if (terrain_land_citizen.items[dst_offset] < CITIZEN_0_ROAD ||
         terrain_land_citizen.items[dst_offset] > CITIZEN_2_PASSABLE_TERRAIN) {
         return 0;
     }
-    ++stats.total_routes_calculated;
-    route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_citizen_road_garden_highway);
-    return distance.determined.items[dst_offset] != 0;
+    ++ctx->stats.total_routes_calculated;
+    route_queue_from_to(ctx, src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_citizen_road_garden_highway);
+    return ctx->distance.determined.items[dst_offset] != 0;
+}
+
+int map_routing_citizen_can_travel_over_road_garden_highway(int src_x, int src_y, int dst_x, int dst_y, int num_directions)
+{
+    return map_routing_context_citizen_can_travel_over_road_garden_highway(&default_context, src_x, src_y, dst_x, dst_y, num_directions);
 }
 
-static int callback_travel_walls(int offset, int next_offset, int direction)
+static int callback_travel_walls(routing_context *ctx, int offset, int next_offset, int direction)
 {
     if (terrain_walls.items[next_offset] >= WALL_0_PASSABLE &&
         terrain_walls.items[next_offset] <= 2) {
@@ -613,16 +677,22 @@ static int callback_travel_walls(int offset, int next_offset, int direction)
     return 0;
 }
 
+int map_routing_context_can_travel_over_walls(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions)
+{
+    ++ctx->stats.total_routes_calculated;
+    route_queue_from_to(ctx, src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_walls);
+    return ctx->distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+}
+
 int map_routing_can_travel_over_walls(int src_x, int src_y, int dst_x, int dst_y, int num_directions)
 {
-    ++stats.total_routes_calculated;
-    route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_walls);
-    return distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+    return map_routing_context_can_travel_over_walls(&default_context, src_x, src_y, dst_x, dst_y, num_directions);
 }
 
-static int callback_travel_noncitizen_land_through_building(int offset, int next_offset, int direction)
+static int callback_travel_noncitizen_land_through_building(routing_context *ctx, int offset, int next_offset, int direction)
 {
-    if (has_fighting_enemy(next_offset)) {
+    if (has_fighting_enemy(ctx, next_offset)) {
         return 0;
     }
     int8_t terrain = terrain_land_noncitizen.items[next_offset];
@@ -630,15 +700,15 @@ static int callback_travel_noncitizen_land_through_building(int offset, int next
         return 1;
     }
     int map_building_id = map_building_at(next_offset);
-    if (terrain == NONCITIZEN_1_BUILDING && (map_building_id == state.through_building_id || map_building_id == state.dest_building_id)) {
+    if (terrain == NONCITIZEN_1_BUILDING && (map_building_id == ctx->state.through_building_id || map_building_id == ctx->state.dest_building_id)) {
         return 1;
     }
     return 0;
 }
 
-static int callback_travel_noncitizen_land(int offset, int next_offset, int direction)
+static int callback_travel_noncitizen_land(routing_context *ctx, int offset, int next_offset, int direction)
 {
-    if (has_fighting_enemy(next_offset)) {
+    if (has_fighting_enemy(ctx, next_offset)) {
         return 0;
     }
     uint8_t terrain = terrain_land_noncitizen.items[next_offset];
@@ -648,24 +718,28 @@ static int callback_travel_noncitizen_land(int offset, int next_offset, int dire
     return 0;
 }
 
-int map_routing_noncitizen_can_travel_over_land(
-    int src_x, int src_y, int dst_x, int dst_y, int num_directions, int only_through_building_id, int max_tiles
-)
+int map_routing_context_noncitizen_can_travel_over_land(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions, int only_through_building_id, int max_tiles)
 {
-    ++stats.total_routes_calculated;
-    ++stats.enemy_routes_calculated;
+    ++ctx->stats.total_routes_calculated;
+    ++ctx->stats.enemy_routes_calculated;
     if (only_through_building_id) {
-        state.through_building_id = only_through_building_id;
+        ctx->state.through_building_id = only_through_building_id;
         // due to formation offsets, the destination building may not be the same as the "through building" (a.k.a. target building)
-        state.dest_building_id = map_building_at(map_grid_offset(dst_x, dst_y));
-        route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_noncitizen_land_through_building);
+        ctx->state.dest_building_id = map_building_at(map_grid_offset(dst_x, dst_y));
+        route_queue_from_to(ctx, src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_noncitizen_land_through_building);
     } else {
-        route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, max_tiles, callback_travel_noncitizen_land);
+        route_queue_from_to(ctx, src_x, src_y, dst_x, dst_y, num_directions, max_tiles, callback_travel_noncitizen_land);
     }
-    return distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+    return ctx->distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+}
+
+int map_routing_noncitizen_can_travel_over_land(int src_x, int src_y, int dst_x, int dst_y, int num_directions, int only_through_building_id, int max_tiles)
+{
+    return map_routing_context_noncitizen_can_travel_over_land(&default_context, src_x, src_y, dst_x, dst_y, num_directions, only_through_building_id, max_tiles);
 }
 
-static int callback_travel_noncitizen_through_everything(int offset, int next_offset, int direction)
+static int callback_travel_noncitizen_through_everything(routing_context *ctx, int offset, int next_offset, int direction)
 {
     if (terrain_land_noncitizen.items[next_offset] >= NONCITIZEN_0_PASSABLE) {
         return 1;
@@ -673,42 +747,56 @@ static int callback_travel_noncitizen_through_everything(int offset, int next_of
     return 0;
 }
 
+int map_routing_context_noncitizen_can_travel_through_everything(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions)
+{
+    ++ctx->stats.total_routes_calculated;
+    route_queue_from_to(ctx, src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_noncitizen_through_everything);
+    return ctx->distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+}
+
 int map_routing_noncitizen_can_travel_through_everything(int src_x, int src_y, int dst_x, int dst_y, int num_directions)
 {
-    ++stats.total_routes_calculated;
-    route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_noncitizen_through_everything);
-    return distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+    return map_routing_context_noncitizen_can_travel_through_everything(&default_context, src_x, src_y, dst_x, dst_y, num_directions);
 }
 
 void map_routing_block(int x, int y, int size)
 {
+    routing_context *ctx = &default_context;
     if (!map_grid_is_inside(x, y, size)) {
         return;
     }
     for (int dy = 0; dy < size; dy++) {
         for (int dx = 0; dx < size; dx++) {
-            distance.determined.items[map_grid_offset(x + dx, y + dy)] = 0;
+            ctx->distance.determined.items[map_grid_offset(x + dx, y + dy)] = 0;
         }
     }
 }
 
+int map_routing_context_distance(const routing_context *ctx, int grid_offset)
+{
+    return ctx->distance.determined.items[grid_offset];
+}
+
 int map_routing_distance(int grid_offset)
 {
-    return distance.determined.items[grid_offset];
+    return map_routing_context_distance(&default_context, grid_offset);
 }
 
 void map_routing_save_state(buffer *buf)
 {
+    routing_context *ctx = &default_context;
     buffer_write_i32(buf, 0); // unused counter
-    buffer_write_i32(buf, stats.enemy_routes_calculated);
-    buffer_write_i32(buf, stats.total_routes_calculated);
+    buffer_write_i32(buf, ctx->stats.enemy_routes_calculated);
+    buffer_write_i32(buf, ctx->stats.total_routes_calculated);
     buffer_write_i32(buf, 0); // unused counter
 }
 
 void map_routing_load_state(buffer *buf)
 {
+    routing_context *ctx = &default_context;
     buffer_skip(buf, 4); // unused counter
-    stats.enemy_routes_calculated = buffer_read_i32(buf);
-    stats.total_routes_calculated = buffer_read_i32(buf);
+    ctx->stats.enemy_routes_calculated = buffer_read_i32(buf);
+    ctx->stats.total_routes_calculated = buffer_read_i32(buf);
     buffer_skip(buf, 4); // unused counter
 }
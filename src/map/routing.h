@@ -19,6 +19,43 @@ typedef struct map_routing_distance_grid {
     int dst_y;
 } map_routing_distance_grid;
 
+/**
+ * Holds the scratch buffers of a route calculation.
+ * The map_routing_* functions use a default context; separate contexts allow
+ * routes to be calculated on several threads at once, as long as the map is not modified meanwhile.
+ */
+typedef struct routing_context routing_context;
+
+/**
+ * Creates a new routing context
+ * @return The context, or 0 if there was not enough memory
+ */
+routing_context *map_routing_context_create(void);
+
+/**
+ * Gets the context used by the map_routing_* functions that do not take one
+ * @return The default context
+ */
+routing_context *map_routing_get_default_context(void);
+
+/**
+ * Frees a routing context
+ * @param ctx The context to free
+ */
+void map_routing_context_free(routing_context *ctx);
+
+/**
+ * Forgets the cached positions of fighting figures, which must be done whenever figures may have moved
+ * @param ctx The context
+ */
+void map_routing_context_clear_cache(routing_context *ctx);
+
+/**
+ * Adds the route counters of a context to the saved counters of the default context and resets them
+ * @param ctx The context
+ */
+void map_routing_context_merge_stats(routing_context *ctx);
+
 const map_routing_distance_grid *map_routing_get_distance_grid(void);
 
 void map_routing_calculate_distances(int x, int y);
@@ -40,6 +77,25 @@ int map_routing_noncitizen_can_travel_over_land(
     int src_x, int src_y, int dst_x, int dst_y, int num_directions, int only_through_building_id, int max_tiles);
 int map_routing_noncitizen_can_travel_through_everything(int src_x, int src_y, int dst_x, int dst_y, int num_directions);
 
+void map_routing_context_calculate_distances_water_boat(routing_context *ctx, int x, int y);
+void map_routing_context_calculate_distances_water_flotsam(routing_context *ctx, int x, int y);
+
+int map_routing_context_distance(const routing_context *ctx, int grid_offset);
+
+int map_routing_context_citizen_can_travel_over_land(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions);
+int map_routing_context_citizen_can_travel_over_road_garden(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions);
+int map_routing_context_citizen_can_travel_over_road_garden_highway(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions);
+int map_routing_context_can_travel_over_walls(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions);
+
+int map_routing_context_noncitizen_can_travel_over_land(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions, int only_through_building_id, int max_tiles);
+int map_routing_context_noncitizen_can_travel_through_everything(routing_context *ctx,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions);
+
 void map_routing_block(int x, int y, int size);
 
 void map_routing_save_state(buffer *buf);
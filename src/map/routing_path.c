@@ -9,8 +9,6 @@
 
 #define MAX_PATH 500
 
-static int direction_path[MAX_PATH];
-
 static void adjust_tile_in_direction(int direction, int *x, int *y, int *grid_offset)
 {
     switch (direction) {
@@ -86,10 +84,11 @@ static int next_is_better(
     return 0;
 }
 
-int map_routing_get_path(uint8_t *path, int dst_x, int dst_y, int num_directions)
+int map_routing_context_get_path(const routing_context *ctx, uint8_t *path, int dst_x, int dst_y, int num_directions)
 {
+    int direction_path[MAX_PATH];
     int dst_grid_offset = map_grid_offset(dst_x, dst_y);
-    int distance = map_routing_distance(dst_grid_offset);
+    int distance = map_routing_context_distance(ctx, dst_grid_offset);
     if (distance <= 0 || distance >= 998) {
         return 0;
     }
@@ -102,14 +101,14 @@ int map_routing_get_path(uint8_t *path, int dst_x, int dst_y, int num_directions
     int step = num_directions == 8 ? 1 : 2;
 
     while (distance > 1) {
-        int base_distance = map_routing_distance(grid_offset);
+        int base_distance = map_routing_context_distance(ctx, grid_offset);
         distance = base_distance;
         int direction = -1;
         int is_highway = 0;
         for (int next_direction = 0; next_direction < 8; next_direction += step) {
             if (next_direction != last_direction) {
                 int next_offset = grid_offset + map_grid_direction_delta(next_direction);
-                int next_distance = map_routing_distance(next_offset);
+                int next_distance = map_routing_context_distance(ctx, next_offset);
                 int next_is_highway = map_terrain_is(next_offset, TERRAIN_HIGHWAY);
                 if (next_distance && next_is_better(base_distance, distance, next_distance,
                         direction, next_direction, is_highway, next_is_highway)) {
@@ -136,11 +135,18 @@ int map_routing_get_path(uint8_t *path, int dst_x, int dst_y, int num_directions
     return num_tiles;
 }
 
-int map_routing_get_path_on_water(uint8_t *path, int dst_x, int dst_y, int is_flotsam)
+int map_routing_get_path(uint8_t *path, int dst_x, int dst_y, int num_directions)
 {
+    return map_routing_context_get_path(map_routing_get_default_context(), path, dst_x, dst_y, num_directions);
+}
+
+int map_routing_context_get_path_on_water(const routing_context *ctx, uint8_t *path,
+    int dst_x, int dst_y, int is_flotsam)
+{
+    int direction_path[MAX_PATH];
     int rand = random_byte() & 3;
     int dst_grid_offset = map_grid_offset(dst_x, dst_y);
-    int distance = map_routing_distance(dst_grid_offset);
+    int distance = map_routing_context_distance(ctx, dst_grid_offset);
     if (distance <= 0 || distance >= 998) {
         return 0;
     }
@@ -152,7 +158,7 @@ int map_routing_get_path_on_water(uint8_t *path, int dst_x, int dst_y, int is_fl
     int grid_offset = dst_grid_offset;
     while (distance > 1) {
         int current_rand = rand;
-        distance = map_routing_distance(grid_offset);
+        distance = map_routing_context_distance(ctx, grid_offset);
         if (is_flotsam) {
             current_rand = map_random_get(grid_offset) & 3;
         }
@@ -160,7 +166,7 @@ int map_routing_get_path_on_water(uint8_t *path, int dst_x, int dst_y, int is_fl
         for (int d = 0; d < 8; d++) {
             if (d != last_direction) {
                 int next_offset = grid_offset + map_grid_direction_delta(d);
-                int next_distance = map_routing_distance(next_offset);
+                int next_distance = map_routing_context_distance(ctx, next_offset);
                 if (next_distance) {
                     if (next_distance < distance) {
                         distance = next_distance;
@@ -189,3 +195,8 @@ int map_routing_get_path_on_water(uint8_t *path, int dst_x, int dst_y, int is_fl
     }
     return num_tiles;
 }
+
+int map_routing_get_path_on_water(uint8_t *path, int dst_x, int dst_y, int is_flotsam)
+{
+    return map_routing_context_get_path_on_water(map_routing_get_default_context(), path, dst_x, dst_y, is_flotsam);
+}
@@ -6,9 +6,14 @@
 #include "map/bridge.h"
 #include "map/building.h"
 #include "map/grid.h"
+#include "map/road_access.h"
 #include "map/ring.h"
 #include "map/routing.h"
 #include "map/sprite.h"
+#include "map/water_supply.h"
+
+// Terrain that decides which roads form a network and which buildings have road access
+#define ROAD_NETWORK_TERRAIN (TERRAIN_ROAD | TERRAIN_BUILDING | TERRAIN_HIGHWAY | TERRAIN_ACCESS_RAMP | TERRAIN_GATEHOUSE)
 
 static grid_u32 terrain_grid;
 static grid_u32 terrain_grid_backup;
@@ -48,16 +53,35 @@ int map_terrain_get_from_buffer_32(buffer *buf, int grid_offset)
 
 void map_terrain_set(int grid_offset, int terrain)
 {
+    int changed = terrain_grid.items[grid_offset] ^ terrain;
     terrain_grid.items[grid_offset] = terrain;
+    if (changed & (TERRAIN_AQUEDUCT | TERRAIN_RESERVOIR_RANGE | TERRAIN_FOUNTAIN_RANGE)) {
+        map_water_supply_terrain_changed(grid_offset, changed);
+    }
+    if (changed & ROAD_NETWORK_TERRAIN) {
+        map_road_access_invalidate();
+    }
 }
 
 void map_terrain_add(int grid_offset, int terrain)
 {
+    if (terrain & TERRAIN_AQUEDUCT && !(terrain_grid.items[grid_offset] & TERRAIN_AQUEDUCT)) {
+        map_water_supply_terrain_changed(grid_offset, TERRAIN_AQUEDUCT);
+    }
+    if (terrain & ~terrain_grid.items[grid_offset] & ROAD_NETWORK_TERRAIN) {
+        map_road_access_invalidate();
+    }
     terrain_grid.items[grid_offset] |= terrain;
 }
 
 void map_terrain_remove(int grid_offset, int terrain)
 {
+    if (terrain & TERRAIN_AQUEDUCT && terrain_grid.items[grid_offset] & TERRAIN_AQUEDUCT) {
+        map_water_supply_terrain_changed(grid_offset, TERRAIN_AQUEDUCT);
+    }
+    if (terrain & terrain_grid.items[grid_offset] & ROAD_NETWORK_TERRAIN) {
+        map_road_access_invalidate();
+    }
     terrain_grid.items[grid_offset] &= ~terrain;
 }
 
@@ -88,6 +112,12 @@ void map_terrain_remove_with_radius(int x, int y, int size, int radius, int terr
 void map_terrain_remove_all(int terrain)
 {
     map_grid_and_u32(terrain_grid.items, ~terrain);
+    if (terrain & TERRAIN_AQUEDUCT) {
+        map_water_supply_invalidate();
+    }
+    if (terrain & ROAD_NETWORK_TERRAIN) {
+        map_road_access_invalidate();
+    }
 }
 
 int map_terrain_count_directly_adjacent_with_type(int grid_offset, int terrain)
@@ -408,12 +438,25 @@ void map_terrain_backup(void)
 
 void map_terrain_restore(void)
 {
+    // Only the tiles whose water terrain differs from the backup are recalculated by the water supply,
+    // and road access only has to be checked again when roads or buildings differ
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        int changed = terrain_grid.items[i] ^ terrain_grid_backup.items[i];
+        if (changed & (TERRAIN_AQUEDUCT | TERRAIN_RESERVOIR_RANGE | TERRAIN_FOUNTAIN_RANGE)) {
+            map_water_supply_terrain_changed(i, changed);
+        }
+        if (changed & ROAD_NETWORK_TERRAIN) {
+            map_road_access_invalidate();
+        }
+    }
     map_grid_copy_u32(terrain_grid_backup.items, terrain_grid.items);
 }
 
 void map_terrain_clear(void)
 {
     map_grid_clear_u32(terrain_grid.items);
+    map_water_supply_invalidate();
+    map_road_access_invalidate();
 }
 
 void map_terrain_init_outside_map(void)
@@ -583,4 +626,6 @@ void map_terrain_load_state(buffer *buf, int expanded_terrain_data, buffer *imag
         map_grid_load_state_u16_to_u32(terrain_grid.items, buf);
     }
     determine_original_trees(images, legacy_image_buffer);
+    map_water_supply_invalidate();
+    map_road_access_invalidate();
 }
@@ -6,6 +6,7 @@
 #include "building/monument.h"
 #include "building/list.h"
 #include "core/image.h"
+#include "core/log.h"
 #include "map/aqueduct.h"
 #include "map/building_tiles.h"
 #include "map/data.h"
@@ -18,6 +19,7 @@
 #include "map/tiles.h"
 #include "scenario/property.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #define OFFSET(x,y) (x + GRID_SIZE * y)
@@ -27,6 +29,7 @@
 #define WELL_RADIUS 2
 #define LATRINES_RADIUS 3
 #define FOUNTAIN_RADIUS 4
+#define MAX_CHANGED_TILES 500
 
 static const int ADJACENT_OFFSETS[] = { -GRID_SIZE, 1, GRID_SIZE, -1 };
 static const int CONNECTOR_OFFSETS[] = { OFFSET(1,-1), OFFSET(3,1), OFFSET(1,3), OFFSET(-1,1) };
@@ -37,6 +40,27 @@ static struct {
     int tail;
 } queue;
 
+static struct {
+    int needs_full_update;
+    int changed_tiles[MAX_CHANGED_TILES];
+    int num_changed_tiles;
+    int reservoir_ranges_invalid;
+    int fountain_ranges_invalid;
+    int reservoir_radius;
+    int neptune_bonus_building_id;
+    int fountain_radius;
+    int active_fountains;
+    // For each tracked reservoir: building_id * 2 + has_water_source, at its grid offset
+    grid_u32 reservoirs;
+    int *reservoir_offsets;
+    int num_reservoirs;
+    int reservoir_offsets_capacity;
+    // Nodes of the network component being refreshed: aqueduct tiles and reservoir origin tiles
+    grid_u32 visited;
+    unsigned int visit_stamp;
+    int nodes[GRID_SIZE * GRID_SIZE];
+} network = { 1 };
+
 static void mark_well_access(int well_id, int radius)
 {
     building *well = building_get(well_id);
@@ -103,20 +127,25 @@ void map_water_supply_update_buildings(void)
     }
 }
 
+static void set_aqueduct_to_no_water(int grid_offset)
+{
+    map_aqueduct_set_water_access(grid_offset, 0);
+    int image_id = map_image_at(grid_offset);
+    if (image_id < image_group(GROUP_BUILDING_AQUEDUCT_NO_WATER)) {
+        map_image_set(grid_offset, image_id + 15);
+    } else if (map_terrain_is(grid_offset, TERRAIN_HIGHWAY)) {
+        image_id = map_tiles_highway_get_aqueduct_image(grid_offset);
+        map_image_set(grid_offset, image_id);
+    }
+}
+
 static void set_all_aqueducts_to_no_water(void)
 {
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
             if (map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
-                map_aqueduct_set_water_access(grid_offset, 0);
-                int image_id = map_image_at(grid_offset);
-                if (image_id < image_group(GROUP_BUILDING_AQUEDUCT_NO_WATER)) {
-                    map_image_set(grid_offset, image_id + 15);
-                } else if(map_terrain_is(grid_offset, TERRAIN_HIGHWAY)) {
-                    image_id = map_tiles_highway_get_aqueduct_image(grid_offset);
-                    map_image_set(grid_offset, image_id);
-                }
+                set_aqueduct_to_no_water(grid_offset);
             }
         }
     }
@@ -189,52 +218,259 @@ static void fill_aqueducts_from_offset(int grid_offset)
     } while (next_offset > -1);
 }
 
-void map_water_supply_update_reservoir_fountain(void)
+static int reservoir_has_water_source(const building *b)
+{
+    return map_terrain_exists_tile_in_area_with_type(b->x - 1, b->y - 1, 5, TERRAIN_WATER);
+}
+
+static unsigned int reservoir_key(const building *b, int has_water_source)
+{
+    return (b->created_sequence << 2) | (has_water_source << 1) | 1;
+}
+
+static building *reservoir_at(int grid_offset)
+{
+    building *b = building_get(map_building_at(grid_offset));
+    if (b->id && b->type == BUILDING_RESERVOIR && b->state == BUILDING_STATE_IN_USE) {
+        return b;
+    }
+    return 0;
+}
+
+static void track_reservoir(const building *b, unsigned int key)
+{
+    if (network.num_reservoirs >= network.reservoir_offsets_capacity) {
+        int capacity = network.reservoir_offsets_capacity ? network.reservoir_offsets_capacity * 2 : 32;
+        int *offsets = realloc(network.reservoir_offsets, capacity * sizeof(int));
+        if (!offsets) {
+            log_error("Unable to allocate memory to track reservoirs, falling back to full water updates", 0, 0);
+            network.needs_full_update = 1;
+            return;
+        }
+        network.reservoir_offsets = offsets;
+        network.reservoir_offsets_capacity = capacity;
+    }
+    network.reservoirs.items[b->grid_offset] = key;
+    network.reservoir_offsets[network.num_reservoirs++] = b->grid_offset;
+}
+
+static void mark_changed_tile(int grid_offset)
+{
+    if (network.num_changed_tiles >= MAX_CHANGED_TILES) {
+        network.needs_full_update = 1;
+        return;
+    }
+    network.changed_tiles[network.num_changed_tiles++] = grid_offset;
+}
+
+static void fill_from_reservoirs(void)
+{
+    int changed = 1;
+    while (changed == 1) {
+        changed = 0;
+        for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
+            if (b->state != BUILDING_STATE_IN_USE) {
+                continue;
+            }
+            if (b->has_water_access == 2) {
+                b->has_water_access = 1;
+                changed = 1;
+                for (int d = 0; d < 4; d++) {
+                    fill_aqueducts_from_offset(b->grid_offset + CONNECTOR_OFFSETS[d]);
+                }
+            }
+        }
+    }
+}
+
+static void update_whole_network(void)
 {
-    map_terrain_remove_all(TERRAIN_FOUNTAIN_RANGE | TERRAIN_RESERVOIR_RANGE);
-    // reservoirs
     set_all_aqueducts_to_no_water();
+    map_grid_clear_u32(network.reservoirs.items);
+    network.num_reservoirs = 0;
+    network.num_changed_tiles = 0;
+    network.needs_full_update = 0;
     for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
         if (b->state != BUILDING_STATE_IN_USE) {
             continue;
         }
-        if (map_terrain_exists_tile_in_area_with_type(b->x - 1, b->y - 1, 5, TERRAIN_WATER)) {
-            b->has_water_access = 2;
+        int has_water_source = reservoir_has_water_source(b);
+        b->has_water_access = has_water_source ? 2 : 0;
+        track_reservoir(b, reservoir_key(b, has_water_source));
+    }
+    // fill reservoirs from full ones
+    fill_from_reservoirs();
+}
+
+static int network_node_at(int grid_offset)
+{
+    if (!map_grid_is_valid_offset(grid_offset)) {
+        return -1;
+    }
+    if (map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
+        return grid_offset;
+    }
+    building *b = reservoir_at(grid_offset);
+    return b ? b->grid_offset : -1;
+}
+
+static int connected_node_at(int grid_offset)
+{
+    if (map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
+        return grid_offset;
+    }
+    building *b = reservoir_at(grid_offset);
+    return b && is_valid_reservoir_connection(grid_offset) ? b->grid_offset : -1;
+}
+
+static int visit_node(int node, int num_nodes)
+{
+    if (node < 0 || network.visited.items[node] == network.visit_stamp) {
+        return num_nodes;
+    }
+    network.visited.items[node] = network.visit_stamp;
+    network.nodes[num_nodes] = node;
+    return num_nodes + 1;
+}
+
+/**
+ * Recalculates the water state of the aqueducts and reservoirs connected to the given tile.
+ * Water never leaves a connected component, so this gives the same result as a full update
+ * for every tile in it.
+ * @return Whether the component contains any reservoir
+ */
+static int update_network_component(int grid_offset)
+{
+    int start = network_node_at(grid_offset);
+    if (start < 0 || network.visited.items[start] == network.visit_stamp) {
+        return 0;
+    }
+    int num_nodes = visit_node(start, 0);
+    for (int i = 0; i < num_nodes; i++) {
+        int node = network.nodes[i];
+        const int *offsets = map_terrain_is(node, TERRAIN_AQUEDUCT) ? ADJACENT_OFFSETS : CONNECTOR_OFFSETS;
+        for (int d = 0; d < 4; d++) {
+            num_nodes = visit_node(connected_node_at(node + offsets[d]), num_nodes);
+        }
+    }
+    int has_reservoirs = 0;
+    for (int i = 0; i < num_nodes; i++) {
+        int node = network.nodes[i];
+        if (map_terrain_is(node, TERRAIN_AQUEDUCT)) {
+            set_aqueduct_to_no_water(node);
         } else {
-            b->has_water_access = 0;
+            int has_water_source = (network.reservoirs.items[node] >> 1) & 1;
+            building_get(map_building_at(node))->has_water_access = has_water_source ? 2 : 0;
+            has_reservoirs = 1;
         }
     }
-    // fill reservoirs from full ones
-    int changed = 1;
-    while (changed == 1) {
+    int changed = has_reservoirs;
+    while (changed) {
         changed = 0;
-        for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
-            if (b->state != BUILDING_STATE_IN_USE) {
+        for (int i = 0; i < num_nodes; i++) {
+            int node = network.nodes[i];
+            if (map_terrain_is(node, TERRAIN_AQUEDUCT)) {
                 continue;
             }
+            building *b = building_get(map_building_at(node));
             if (b->has_water_access == 2) {
                 b->has_water_access = 1;
                 changed = 1;
                 for (int d = 0; d < 4; d++) {
-                    fill_aqueducts_from_offset(b->grid_offset + CONNECTOR_OFFSETS[d]);
+                    fill_aqueducts_from_offset(node + CONNECTOR_OFFSETS[d]);
                 }
             }
         }
     }
-    // mark reservoir ranges
+    return has_reservoirs;
+}
+
+static void track_reservoir_changes(void)
+{
+    // Reservoirs that were removed or replaced since the last update
+    for (int i = 0; i < network.num_reservoirs; i++) {
+        int grid_offset = network.reservoir_offsets[i];
+        building *b = reservoir_at(grid_offset);
+        if (!b || b->grid_offset != grid_offset ||
+            (network.reservoirs.items[grid_offset] >> 2) != b->created_sequence) {
+            network.reservoirs.items[grid_offset] = 0;
+            mark_changed_tile(grid_offset);
+        }
+    }
+    // New reservoirs and reservoirs that gained or lost their water source
+    network.num_reservoirs = 0;
+    for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
+        if (b->state != BUILDING_STATE_IN_USE) {
+            continue;
+        }
+        unsigned int key = reservoir_key(b, reservoir_has_water_source(b));
+        if (network.reservoirs.items[b->grid_offset] != key) {
+            mark_changed_tile(b->grid_offset);
+        }
+        track_reservoir(b, key);
+    }
+}
+
+static int update_changed_network_components(void)
+{
+    track_reservoir_changes();
+    if (network.needs_full_update) {
+        update_whole_network();
+        return 1;
+    }
+    if (!network.num_changed_tiles) {
+        return 0;
+    }
+    if (++network.visit_stamp == 0) {
+        map_grid_clear_u32(network.visited.items);
+        network.visit_stamp = 1;
+    }
+    int reservoirs_changed = 0;
+    for (int i = 0; i < network.num_changed_tiles; i++) {
+        int grid_offset = network.changed_tiles[i];
+        // A removed tile may have split its component, so every neighbour has to be checked
+        reservoirs_changed |= update_network_component(grid_offset);
+        for (int d = 0; d < 4; d++) {
+            reservoirs_changed |= update_network_component(grid_offset + ADJACENT_OFFSETS[d]);
+            reservoirs_changed |= update_network_component(grid_offset + CONNECTOR_OFFSETS[d]);
+        }
+    }
+    network.num_changed_tiles = 0;
+    return reservoirs_changed;
+}
+
+static void update_reservoir_ranges(void)
+{
+    int reservoir_radius = map_water_supply_reservoir_radius();
+    int neptune_bonus_building_id = building_monument_gt_module_is_active(NEPTUNE_MODULE_2_CAPACITY_AND_WATER) ?
+        building_monument_get_neptune_gt() : 0;
+    if (!network.reservoir_ranges_invalid && reservoir_radius == network.reservoir_radius &&
+        neptune_bonus_building_id == network.neptune_bonus_building_id) {
+        return;
+    }
+    network.reservoir_ranges_invalid = 0;
+    network.reservoir_radius = reservoir_radius;
+    network.neptune_bonus_building_id = neptune_bonus_building_id;
+
+    map_terrain_remove_all(TERRAIN_RESERVOIR_RANGE);
     for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
         if (b->state == BUILDING_STATE_IN_USE && b->has_water_access) {
-            map_terrain_add_with_radius(b->x, b->y, 3, map_water_supply_reservoir_radius(), TERRAIN_RESERVOIR_RANGE);
+            map_terrain_add_with_radius(b->x, b->y, 3, reservoir_radius, TERRAIN_RESERVOIR_RANGE);
         }
     }
 
     // Neptune GT module 2 bonus
-    if (building_monument_gt_module_is_active(NEPTUNE_MODULE_2_CAPACITY_AND_WATER)) {
-        building *b = building_get(building_monument_get_neptune_gt());
-        map_terrain_add_with_radius(b->x, b->y, 7, map_water_supply_reservoir_radius(), TERRAIN_RESERVOIR_RANGE);
+    if (neptune_bonus_building_id) {
+        building *b = building_get(neptune_bonus_building_id);
+        map_terrain_add_with_radius(b->x, b->y, 7, reservoir_radius, TERRAIN_RESERVOIR_RANGE);
     }
+}
 
-    // fountains
+static void update_fountains(void)
+{
+    int fountain_radius = map_water_supply_fountain_radius();
+    int ranges_changed = network.fountain_ranges_invalid || fountain_radius != network.fountain_radius;
+    int active_fountains = 0;
     for (building *b = building_first_of_type(BUILDING_FOUNTAIN); b; b = b->next_of_type) {
         if (b->state != BUILDING_STATE_IN_USE) {
             continue;
@@ -249,14 +485,59 @@ void map_water_supply_update_reservoir_fountain(void)
             b->upgrade_level = 0;
         }
         map_building_tiles_add(b->id, b->x, b->y, 1, building_image_get(b), TERRAIN_BUILDING);
-        if (map_terrain_is(b->grid_offset, TERRAIN_RESERVOIR_RANGE) && b->num_workers) {
-            b->has_water_access = 1;
-            map_terrain_add_with_radius(b->x, b->y, 1,
-                map_water_supply_fountain_radius(), TERRAIN_FOUNTAIN_RANGE);
-        } else {
-            b->has_water_access = 0;
+        int has_water_access = map_terrain_is(b->grid_offset, TERRAIN_RESERVOIR_RANGE) && b->num_workers;
+        if (has_water_access != b->has_water_access) {
+            b->has_water_access = has_water_access;
+            ranges_changed = 1;
         }
+        active_fountains += has_water_access;
     }
+    // A removed working fountain is only noticed through the number of working fountains
+    if (!ranges_changed && active_fountains == network.active_fountains) {
+        return;
+    }
+    network.fountain_ranges_invalid = 0;
+    network.fountain_radius = fountain_radius;
+    network.active_fountains = active_fountains;
+
+    map_terrain_remove_all(TERRAIN_FOUNTAIN_RANGE);
+    for (building *b = building_first_of_type(BUILDING_FOUNTAIN); b; b = b->next_of_type) {
+        if (b->state == BUILDING_STATE_IN_USE && b->has_water_access) {
+            map_terrain_add_with_radius(b->x, b->y, 1, fountain_radius, TERRAIN_FOUNTAIN_RANGE);
+        }
+    }
+}
+
+void map_water_supply_terrain_changed(int grid_offset, int changed_terrain)
+{
+    if (changed_terrain & (TERRAIN_RESERVOIR_RANGE | TERRAIN_FOUNTAIN_RANGE)) {
+        network.reservoir_ranges_invalid = 1;
+        network.fountain_ranges_invalid = 1;
+    }
+    if (changed_terrain & TERRAIN_AQUEDUCT && !network.needs_full_update) {
+        mark_changed_tile(grid_offset);
+    }
+}
+
+void map_water_supply_invalidate(void)
+{
+    network.needs_full_update = 1;
+    network.num_changed_tiles = 0;
+    network.reservoir_ranges_invalid = 1;
+    network.fountain_ranges_invalid = 1;
+}
+
+void map_water_supply_update_reservoir_fountain(void)
+{
+    // reservoirs
+    if (update_changed_network_components()) {
+        network.reservoir_ranges_invalid = 1;
+    }
+    update_reservoir_ranges();
+
+    // fountains
+    update_fountains();
+
     // Ponds
     static const building_type ponds[] = { BUILDING_SMALL_POND, BUILDING_LARGE_POND };
     for (int i = 0; i < 2; i++) {
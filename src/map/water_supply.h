@@ -5,6 +5,20 @@ void map_water_supply_update_buildings(void);
 void map_water_supply_update_reservoir_fountain(void);
 int map_water_supply_has_aqueduct_access(int grid_offset);
 
+/**
+ * Notifies the water supply that aqueduct or range terrain of a tile changed,
+ * so only the aqueduct network around it is recalculated on the next update
+ * @param grid_offset The tile that changed
+ * @param changed_terrain The terrain bits that changed
+ */
+void map_water_supply_terrain_changed(int grid_offset, int changed_terrain);
+
+/**
+ * Forces the next update to recalculate the water state of the whole map,
+ * used after the terrain has been replaced as a whole
+ */
+void map_water_supply_invalidate(void);
+
 enum {
     BUILDING_NECESSARY = 0,
     BUILDING_UNNECESSARY_FOUNTAIN = 1,
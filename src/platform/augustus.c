@@ -5,8 +5,10 @@
 #include "core/file.h"
 #include "core/lang.h"
 #include "core/log.h"
+#include "core/memory.h"
 #include "core/time.h"
 #include "game/game.h"
+#include "game/replay.h"
 #include "game/settings.h"
 #include "game/system.h"
 #include "graphics/screen.h"
@@ -27,6 +29,7 @@
 #include "platform/renderer.h"
 #include "platform/screen.h"
 #include "platform/switch/switch.h"
+#include "platform/thread_pool.h"
 #include "platform/touch.h"
 #include "platform/vita/vita.h"
 #include "window/asset_previewer.h"
@@ -208,6 +211,7 @@ static void run_and_draw(void)
 {
     time_millis time_before_run = system_get_ticks();
     time_set_millis(time_before_run);
+    core_memory_start_frame();
 
     game_run();
     game_draw();
@@ -427,6 +431,7 @@ static void teardown(void)
     log_repeated_messages();
     SDL_Log("Exiting game");
     game_exit();
+    platform_thread_pool_shutdown();
     platform_screen_destroy();
     SDL_Quit();
     teardown_logging();
@@ -726,7 +731,12 @@ int main(int argc, char **argv)
 
     setup(&args);
 
-
+    if (args.replay_name) {
+        // The window exists because assets need it, but nothing is drawn while the replay runs
+        int replay_ok = game_replay_run_headless(args.replay_name);
+        teardown();
+        exit_with_status(replay_ok ? 0 : 3);
+    }
 
     mouse_set_inside_window(1);
     run_and_draw();
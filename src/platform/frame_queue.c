@@ -0,0 +1,163 @@
+#include "frame_queue.h"
+
+#include "core/log.h"
+#include "core/memory.h"
+
+#include "SDL.h"
+
+#include <stdint.h>
+
+// Frames are rounded up to this size, so every frame starts at an address that is aligned for any type.
+// The game is built as C99, which has no max_align_t, and no supported platform needs more than 16 bytes.
+#define FRAME_ALIGNMENT 16
+
+struct frame_queue {
+    SDL_Thread *thread;
+    SDL_mutex *mutex;
+    SDL_cond *frame_freed;
+    uint8_t *frames;
+    size_t frame_size;
+    int num_frames;
+    int first_filled;
+    int num_filled;
+    int finished;
+    int quit;
+    frame_queue_producer produce;
+    void *userdata;
+};
+
+static void *get_frame(frame_queue *queue, int index)
+{
+    return queue->frames + (size_t) (index % queue->num_frames) * queue->frame_size;
+}
+
+static int producer_thread(void *arg)
+{
+    frame_queue *queue = arg;
+    SDL_LockMutex(queue->mutex);
+    while (1) {
+        while (!queue->quit && queue->num_filled == queue->num_frames) {
+            SDL_CondWait(queue->frame_freed, queue->mutex);
+        }
+        if (queue->quit) {
+            break;
+        }
+        // The frame after the last filled one is never read by the main thread, so it can be filled unlocked
+        void *frame = get_frame(queue, queue->first_filled + queue->num_filled);
+        SDL_UnlockMutex(queue->mutex);
+
+        int produced = queue->produce(frame, queue->userdata);
+
+        SDL_LockMutex(queue->mutex);
+        if (!produced) {
+            queue->finished = 1;
+            break;
+        }
+        queue->num_filled++;
+    }
+    SDL_UnlockMutex(queue->mutex);
+    return 0;
+}
+
+frame_queue *platform_frame_queue_create(int num_frames, size_t frame_size, frame_queue_producer produce,
+    void *userdata)
+{
+    frame_queue *queue = core_memory_calloc(MEMORY_TAG_VIDEO, 1, sizeof(frame_queue));
+    if (!queue) {
+        return 0;
+    }
+    frame_size = (frame_size + FRAME_ALIGNMENT - 1) / FRAME_ALIGNMENT * FRAME_ALIGNMENT;
+    queue->frames = core_memory_alloc(MEMORY_TAG_VIDEO, frame_size * num_frames);
+    if (!queue->frames) {
+        core_memory_free(MEMORY_TAG_VIDEO, queue);
+        return 0;
+    }
+    queue->frame_size = frame_size;
+    queue->num_frames = num_frames;
+    queue->produce = produce;
+    queue->userdata = userdata;
+    queue->mutex = SDL_CreateMutex();
+    queue->frame_freed = SDL_CreateCond();
+    if (queue->mutex && queue->frame_freed) {
+        queue->thread = SDL_CreateThread(producer_thread, "frame_queue", queue);
+    }
+    if (!queue->thread) {
+        log_info("Unable to create the frame producer thread, producing frames on demand:", SDL_GetError(), 0);
+    }
+    return queue;
+}
+
+static void lock(frame_queue *queue)
+{
+    if (queue->thread) {
+        SDL_LockMutex(queue->mutex);
+    }
+}
+
+static void unlock(frame_queue *queue)
+{
+    if (queue->thread) {
+        SDL_UnlockMutex(queue->mutex);
+    }
+}
+
+const void *platform_frame_queue_peek(frame_queue *queue)
+{
+    const void *frame = 0;
+    lock(queue);
+    if (!queue->thread && !queue->num_filled && !queue->finished) {
+        if (queue->produce(get_frame(queue, queue->first_filled), queue->userdata)) {
+            queue->num_filled++;
+        } else {
+            queue->finished = 1;
+        }
+    }
+    if (queue->num_filled) {
+        frame = get_frame(queue, queue->first_filled);
+    }
+    unlock(queue);
+    return frame;
+}
+
+void platform_frame_queue_pop(frame_queue *queue)
+{
+    lock(queue);
+    if (queue->num_filled) {
+        queue->first_filled = (queue->first_filled + 1) % queue->num_frames;
+        queue->num_filled--;
+        if (queue->thread) {
+            SDL_CondSignal(queue->frame_freed);
+        }
+    }
+    unlock(queue);
+}
+
+int platform_frame_queue_is_finished(frame_queue *queue)
+{
+    lock(queue);
+    int finished = queue->finished && !queue->num_filled;
+    unlock(queue);
+    return finished;
+}
+
+void platform_frame_queue_destroy(frame_queue *queue)
+{
+    if (!queue) {
+        return;
+    }
+    if (queue->thread) {
+        SDL_LockMutex(queue->mutex);
+        queue->quit = 1;
+        SDL_CondSignal(queue->frame_freed);
+        SDL_UnlockMutex(queue->mutex);
+        SDL_WaitThread(queue->thread, 0);
+    }
+    if (queue->frame_freed) {
+        SDL_DestroyCond(queue->frame_freed);
+    }
+    if (queue->mutex) {
+        SDL_DestroyMutex(queue->mutex);
+    }
+    core_memory_free(MEMORY_TAG_VIDEO, queue->frames);
+    core_memory_free(MEMORY_TAG_VIDEO, queue);
+}
@@ -0,0 +1,62 @@
+#ifndef PLATFORM_FRAME_QUEUE_H
+#define PLATFORM_FRAME_QUEUE_H
+
+#include <stddef.h>
+
+/**
+ * @file
+ * Bounded queue of frames filled ahead of time by a background thread.
+ *
+ * The producer runs on its own thread and only ever writes to a free frame, while the
+ * main thread reads the oldest filled frame. When no thread can be created, frames are
+ * produced on demand on the main thread instead.
+ */
+
+typedef struct frame_queue frame_queue;
+
+/**
+ * A producer callback
+ * @param frame The frame to fill, at least frame_size bytes long
+ * @param userdata The userdata passed to platform_frame_queue_create
+ * @return 1 if the frame was filled, 0 if there are no more frames
+ */
+typedef int (*frame_queue_producer)(void *frame, void *userdata);
+
+/**
+ * Creates a queue and starts producing frames
+ * @param num_frames The number of frames the producer can be ahead
+ * @param frame_size The size of a frame in bytes. Every frame is aligned for any type.
+ * @param produce The producer callback
+ * @param userdata Data passed to the producer
+ * @return The queue, or 0 if there was not enough memory
+ */
+frame_queue *platform_frame_queue_create(int num_frames, size_t frame_size, frame_queue_producer produce,
+    void *userdata);
+
+/**
+ * Gets the oldest filled frame without removing it from the queue
+ * @param queue The queue
+ * @return The frame, or 0 if no frame is ready yet
+ */
+const void *platform_frame_queue_peek(frame_queue *queue);
+
+/**
+ * Removes the oldest filled frame, so the producer can reuse it
+ * @param queue The queue
+ */
+void platform_frame_queue_pop(frame_queue *queue);
+
+/**
+ * Checks whether the producer ran out of frames and all frames were removed
+ * @param queue The queue
+ * @return 1 if no more frames will be available, 0 otherwise
+ */
+int platform_frame_queue_is_finished(frame_queue *queue);
+
+/**
+ * Stops the producer and frees the queue
+ * @param queue The queue
+ */
+void platform_frame_queue_destroy(frame_queue *queue);
+
+#endif // PLATFORM_FRAME_QUEUE_H
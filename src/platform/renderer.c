@@ -2,6 +2,7 @@
 
 #include "core/calc.h"
 #include "core/config.h"
+#include "core/memory.h"
 #include "core/time.h"
 #include "graphics/renderer.h"
 #include "graphics/screen.h"
@@ -35,8 +36,15 @@
 #define HAS_TEXTURE_SCALE_MODE 0
 #endif
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define USE_RENDER_GEOMETRY
+#define HAS_RENDER_GEOMETRY (platform_sdl_version_at_least(2, 0, 18))
+#endif
+
 #define MAX_UNPACKED_IMAGES 20
 
+#define PI 3.14159265358979323846
+
 #define MAX_PACKED_IMAGE_SIZE 64000
 
 #if (defined(__ANDROID__) || defined(__EMSCRIPTEN__)) && !SDL_VERSION_ATLEAST(2, 24, 0)
@@ -74,6 +82,13 @@ static struct {
     SDL_Texture *render_texture;
     int is_software_renderer;
     int paused;
+#ifdef USE_RENDER_GEOMETRY
+    struct {
+        SDL_Vertex *vertices;
+        int *indices;
+        int capacity;
+    } geometry;
+#endif
     struct {
         SDL_Texture *texture;
         int size;
@@ -171,6 +186,20 @@ static void fill_rect(int x_start, int x_end, int y_start, int y_end, color_t co
     SDL_RenderFillRect(data.renderer, &rect);
 }
 
+static void draw_points(const graphics_point *points, int num_points, color_t color)
+{
+    if (data.paused || num_points <= 0) {
+        return;
+    }
+    SDL_SetRenderDrawColor(data.renderer,
+        (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
+        (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
+        (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE,
+        (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA);
+    // graphics_point has the same layout as SDL_Point, so the whole batch is sent in a single call
+    SDL_RenderDrawPoints(data.renderer, (const SDL_Point *) points, num_points);
+}
+
 static void set_clip_rectangle(int x, int y, int width, int height)
 {
     if (data.paused) {
@@ -268,7 +297,7 @@ static void free_atlas_data_buffers(atlas_type type)
     if (atlas_data->buffers) {
 #ifndef __VITA__
         for (int i = 0; i < atlas_data->num_images; i++) {
-            free(atlas_data->buffers[i]);
+            core_memory_free(MEMORY_TAG_TEXTURE, atlas_data->buffers[i]);
         }
 #endif
         free(atlas_data->buffers);
@@ -339,12 +368,11 @@ static const image_atlas_data *prepare_texture_atlas(atlas_type type, int num_im
         atlas_data->image_widths[i] = i == num_images - 1 ? last_width : data.max_texture_size.width;
         atlas_data->image_heights[i] = i == num_images - 1 ? last_height : data.max_texture_size.height;
         size_t size = sizeof(color_t) * atlas_data->image_widths[i] * atlas_data->image_heights[i];
-        atlas_data->buffers[i] = malloc(size);
+        atlas_data->buffers[i] = core_memory_calloc(MEMORY_TAG_TEXTURE, size, 1);
         if (!atlas_data->buffers[i]) {
             reset_atlas_data(type);
             return 0;
         }
-        memset(atlas_data->buffers[i], 0, size);
     }
 #endif
     return atlas_data;
@@ -384,7 +412,7 @@ static int create_texture_atlas(const image_atlas_data *atlas_data, int delete_b
         list[i] = SDL_CreateTextureFromSurface(data.renderer, surface);
         SDL_FreeSurface(surface);
         if (delete_buffers) {
-            free(atlas_data->buffers[i]);
+            core_memory_free(MEMORY_TAG_TEXTURE, atlas_data->buffers[i]);
             atlas_data->buffers[i] = 0;
         }
         if (!list[i]) {
@@ -414,6 +442,54 @@ static const image_atlas_data *get_texture_atlas(atlas_type type)
     return &data.atlas_data[type];
 }
 
+static int append_texture_atlas(atlas_type type, color_t **buffers, const int *widths, const int *heights,
+    int num_images)
+{
+    if (!data.texture_lists[type]) {
+        reset_atlas_data(type);
+    }
+    image_atlas_data *atlas_data = &data.atlas_data[type];
+    int first_image = atlas_data->num_images;
+    int total_images = first_image + num_images;
+    SDL_Texture **list = realloc(data.texture_lists[type], sizeof(SDL_Texture *) * total_images);
+    if (list) {
+        data.texture_lists[type] = list;
+    }
+    int *image_widths = realloc(atlas_data->image_widths, sizeof(int) * total_images);
+    if (image_widths) {
+        atlas_data->image_widths = image_widths;
+    }
+    int *image_heights = realloc(atlas_data->image_heights, sizeof(int) * total_images);
+    if (image_heights) {
+        atlas_data->image_heights = image_heights;
+    }
+    if (!list || !image_widths || !image_heights) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to add textures to atlas %u - out of memory", type);
+        return -1;
+    }
+    for (int i = 0; i < num_images; i++) {
+        SDL_Log("Creating atlas texture with size %dx%d", widths[i], heights[i]);
+        SDL_Texture *texture = SDL_CreateTexture(data.renderer,
+            SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, widths[i], heights[i]);
+        if (!texture || SDL_UpdateTexture(texture, NULL, buffers[i], widths[i] * sizeof(color_t))) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to create texture. Reason: %s", SDL_GetError());
+            if (texture) {
+                SDL_DestroyTexture(texture);
+            }
+            for (int j = first_image; j < first_image + i; j++) {
+                SDL_DestroyTexture(list[j]);
+            }
+            return -1;
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        list[first_image + i] = texture;
+        image_widths[first_image + i] = widths[i];
+        image_heights[first_image + i] = heights[i];
+    }
+    atlas_data->num_images = total_images;
+    return first_image;
+}
+
 static void free_all_textures(void)
 {
     for (atlas_type i = ATLAS_FIRST; i < ATLAS_MAX - 1; i++) {
@@ -424,7 +500,7 @@ static void free_all_textures(void)
             SDL_DestroyTexture(data.custom_textures[i].texture);
             data.custom_textures[i].texture = 0;
 #ifndef __vita__
-            free(data.custom_textures[i].buffer);
+            core_memory_free(MEMORY_TAG_TEXTURE, data.custom_textures[i].buffer);
 #endif
             data.custom_textures[i].buffer = 0;
             memset(&data.custom_textures[i].img, 0, sizeof(image));
@@ -558,6 +634,100 @@ static void draw_texture_advanced(const image *img, float x, float y, color_t co
     SDL_RenderCopyEx(data.renderer, texture, &src_coords, &dst_coords, angle, NULL, SDL_FLIP_NONE);
 }
 
+#ifdef USE_RENDER_GEOMETRY
+static int reserve_geometry(int num_quads)
+{
+    if (num_quads <= data.geometry.capacity) {
+        return 1;
+    }
+    SDL_Vertex *vertices = realloc(data.geometry.vertices, sizeof(SDL_Vertex) * 4 * num_quads);
+    if (!vertices) {
+        return 0;
+    }
+    data.geometry.vertices = vertices;
+    int *indices = realloc(data.geometry.indices, sizeof(int) * 6 * num_quads);
+    if (!indices) {
+        return 0;
+    }
+    data.geometry.indices = indices;
+    data.geometry.capacity = num_quads;
+    return 1;
+}
+#endif
+
+static void draw_texture_instances(const image_instance *instances, int num_instances, color_t color)
+{
+    if (data.paused || num_instances <= 0) {
+        return;
+    }
+#ifdef USE_RENDER_GEOMETRY
+    SDL_Texture *texture = get_texture(instances[0].img->atlas.id);
+    int texture_width, texture_height;
+    if (HAS_RENDER_GEOMETRY && texture && reserve_geometry(num_instances) &&
+        SDL_QueryTexture(texture, NULL, NULL, &texture_width, &texture_height) == 0) {
+        if (!color) {
+            color = COLOR_MASK_NONE;
+        }
+        // The color is applied per vertex, so the texture itself must not tint
+        set_texture_color_and_scale_mode(texture, COLOR_MASK_NONE, 0.0f);
+        SDL_Color vertex_color = {
+            (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
+            (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
+            (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE,
+            (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA
+        };
+        static const float corners[4][2] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+        SDL_Vertex *vertex = data.geometry.vertices;
+        int *index = data.geometry.indices;
+        for (int i = 0; i < num_instances; i++) {
+            const image_instance *instance = &instances[i];
+            const image *img = instance->img;
+            float width = img->width / instance->scale_x;
+            float height = img->height / instance->scale_y;
+            float center_x = instance->x + img->x_offset + width / 2;
+            float center_y = instance->y + img->y_offset + height / 2;
+            // Same rotation as SDL_RenderCopyEx: clockwise in degrees, around the center
+            double radians = instance->angle * PI / 180.0;
+            float cos_angle = (float) cos(radians);
+            float sin_angle = (float) sin(radians);
+            float u[2] = {
+                (float) img->atlas.x_offset / texture_width,
+                (float) (img->atlas.x_offset + img->width) / texture_width
+            };
+            float v[2] = {
+                (float) img->atlas.y_offset / texture_height,
+                (float) (img->atlas.y_offset + img->height) / texture_height
+            };
+            int first_vertex = i * 4;
+            for (int c = 0; c < 4; c++) {
+                float dx = corners[c][0] * width;
+                float dy = corners[c][1] * height;
+                vertex->position.x = center_x + dx * cos_angle - dy * sin_angle;
+                vertex->position.y = center_y + dx * sin_angle + dy * cos_angle;
+                vertex->color = vertex_color;
+                vertex->tex_coord.x = u[c == 1 || c == 2];
+                vertex->tex_coord.y = v[c >= 2];
+                vertex++;
+            }
+            *index++ = first_vertex;
+            *index++ = first_vertex + 1;
+            *index++ = first_vertex + 2;
+            *index++ = first_vertex;
+            *index++ = first_vertex + 2;
+            *index++ = first_vertex + 3;
+        }
+        SDL_RenderGeometry(data.renderer, texture, data.geometry.vertices, num_instances * 4,
+            data.geometry.indices, num_instances * 6);
+        return;
+    }
+#endif
+    for (int i = 0; i < num_instances; i++) {
+        const image_instance *instance = &instances[i];
+        draw_texture_advanced(instance->img, instance->x, instance->y, color,
+            instance->scale_x, instance->scale_y, instance->angle, 1);
+    }
+}
+
 static void draw_texture(const image *img, int x, int y, color_t color, float scale)
 {
     draw_texture_advanced(img, (float) x, (float) y, color, scale, scale, 0.0, 0);
@@ -575,7 +745,7 @@ static void create_custom_texture(custom_image_type type, int width, int height,
     memset(&data.custom_textures[type].img, 0, sizeof(data.custom_textures[type].img));
 #ifndef __vita__
     if (data.custom_textures[type].buffer) {
-        free(data.custom_textures[type].buffer);
+        core_memory_free(MEMORY_TAG_TEXTURE, data.custom_textures[type].buffer);
         data.custom_textures[type].buffer = 0;
     }
 #endif
@@ -603,7 +773,8 @@ static color_t *get_custom_texture_buffer(custom_image_type type, int *actual_te
     }
     SDL_UnlockTexture(data.custom_textures[type].texture);
 #else
-    free(data.custom_textures[type].buffer);
+    core_memory_free(MEMORY_TAG_TEXTURE, data.custom_textures[type].buffer);
+    data.custom_textures[type].buffer = 0;
     int width, height;
     Uint32 format;
     SDL_QueryTexture(data.custom_textures[type].texture, &format, NULL, &width, &height);
@@ -611,7 +782,7 @@ static color_t *get_custom_texture_buffer(custom_image_type type, int *actual_te
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Cannot get buffer to YUV texture");
         return 0;
     }
-    data.custom_textures[type].buffer = (color_t *) malloc((size_t) width * height * sizeof(color_t));
+    data.custom_textures[type].buffer = core_memory_alloc(MEMORY_TAG_TEXTURE, (size_t) width * height * sizeof(color_t));
     if (actual_texture_width) {
         *actual_texture_width = width;
     }
@@ -622,7 +793,7 @@ static color_t *get_custom_texture_buffer(custom_image_type type, int *actual_te
 static void release_custom_texture_buffer(custom_image_type type)
 {
 #ifndef __vita__
-    free(data.custom_textures[type].buffer);
+    core_memory_free(MEMORY_TAG_TEXTURE, data.custom_textures[type].buffer);
     data.custom_textures[type].buffer = 0;
 #endif
 }
@@ -1152,8 +1323,10 @@ static void create_renderer_interface(void)
     data.renderer_interface.draw_line = draw_line;
     data.renderer_interface.draw_rect = draw_rect;
     data.renderer_interface.fill_rect = fill_rect;
+    data.renderer_interface.draw_points = draw_points;
     data.renderer_interface.draw_image = draw_texture;
     data.renderer_interface.draw_image_advanced = draw_texture_advanced;
+    data.renderer_interface.draw_image_instances = draw_texture_instances;
     data.renderer_interface.draw_silhouette = draw_silhouetted_texture;
     data.renderer_interface.create_custom_image = create_custom_texture;
     data.renderer_interface.has_custom_image = has_custom_texture;
@@ -1178,6 +1351,7 @@ static void create_renderer_interface(void)
     data.renderer_interface.get_image_atlas = get_texture_atlas;
     data.renderer_interface.has_image_atlas = has_texture_atlas;
     data.renderer_interface.free_image_atlas = free_texture_atlas_and_data;
+    data.renderer_interface.append_image_atlas = append_texture_atlas;
     data.renderer_interface.load_unpacked_image = load_unpacked_image;
     data.renderer_interface.free_unpacked_image = free_unpacked_image;
     data.renderer_interface.should_pack_image = should_pack_image;
@@ -1441,6 +1615,13 @@ void platform_renderer_resume(void)
 void platform_renderer_destroy(void)
 {
     destroy_render_texture();
+#ifdef USE_RENDER_GEOMETRY
+    free(data.geometry.vertices);
+    free(data.geometry.indices);
+    data.geometry.vertices = 0;
+    data.geometry.indices = 0;
+    data.geometry.capacity = 0;
+#endif
     if (data.renderer) {
         SDL_DestroyRenderer(data.renderer);
         data.renderer = 0;
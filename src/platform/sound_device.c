@@ -4,6 +4,7 @@
 #include "core/config.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/memory.h"
 #include "core/time.h"
 #include "game/campaign.h"
 #include "game/settings.h"
@@ -526,7 +527,7 @@ static void free_custom_audio_stream(void)
 #endif
 
     if (custom_music.buffer) {
-        free(custom_music.buffer);
+        core_memory_free(MEMORY_TAG_SOUND, custom_music.buffer);
         custom_music.buffer = 0;
     }
 }
@@ -558,7 +559,7 @@ static int create_custom_audio_stream(SDL_AudioFormat src_format, Uint8 src_chan
 
     // Allocate buffer large enough for 2 seconds of 16-bit audio
     custom_music.buffer_size = dst_rate * dst_channels * 2 * 2;
-    custom_music.buffer = malloc(custom_music.buffer_size);
+    custom_music.buffer = core_memory_alloc(MEMORY_TAG_SOUND, custom_music.buffer_size);
     if (!custom_music.buffer) {
         return 0;
     }
@@ -590,7 +591,7 @@ static int put_custom_audio_stream(const void *audio_data, int len)
 #endif
 
     // Convert audio to SDL format
-    custom_music.cvt.buf = (Uint8 *) malloc((size_t) (len * custom_music.cvt.len_mult));
+    custom_music.cvt.buf = core_memory_alloc(MEMORY_TAG_SOUND, (size_t) (len * custom_music.cvt.len_mult));
     if (!custom_music.cvt.buf) {
         return 0;
     }
@@ -610,7 +611,7 @@ static int put_custom_audio_stream(const void *audio_data, int len)
     custom_music.cur_write = (custom_music.cur_write + converted_len) % custom_music.buffer_size;
 
     // Clean up
-    free(custom_music.cvt.buf);
+    core_memory_free(MEMORY_TAG_SOUND, custom_music.cvt.buf);
     custom_music.cvt.buf = 0;
     custom_music.cvt.len = 0;
 
@@ -631,17 +632,16 @@ static void custom_music_callback(void *dummy, Uint8 *dst, int len)
     int bytes_copied = 0;
 
     // Mix audio to sound effect volume
-    Uint8 *mix_buffer = (Uint8 *) malloc(len);
+    Uint8 *mix_buffer = core_memory_calloc(MEMORY_TAG_SOUND, len, 1);
     if (!mix_buffer) {
         return;
     }
-    memset(mix_buffer, 0, len);
 
 #ifdef USE_SDL_AUDIOSTREAM
     if (custom_music.use_audiostream) {
         bytes_copied = SDL_AudioStreamGet(custom_music.stream, mix_buffer, len);
         if (bytes_copied <= 0) {
-            free(mix_buffer);
+            core_memory_free(MEMORY_TAG_SOUND, mix_buffer);
             return;
         }
     } else {
@@ -670,7 +670,7 @@ static void custom_music_callback(void *dummy, Uint8 *dst, int len)
 #endif
 
     SDL_MixAudioFormat(dst, mix_buffer, custom_music.dst_format, bytes_copied, volume);
-    free(mix_buffer);
+    core_memory_free(MEMORY_TAG_SOUND, mix_buffer);
 }
 
 void sound_device_use_custom_music_player(int bitdepth, int num_channels, int rate, const void *audio_data, int len)
@@ -0,0 +1,161 @@
+#include "thread_pool.h"
+
+#include "core/log.h"
+
+#include "SDL.h"
+
+#include <stdint.h>
+
+#define MAX_WORKER_THREADS 7
+
+static struct {
+    int initialized;
+    int num_threads;
+    SDL_Thread *threads[MAX_WORKER_THREADS];
+    SDL_mutex *mutex;
+    SDL_cond *job_ready;
+    SDL_cond *job_done;
+    unsigned int generation;
+    unsigned int start_generation;
+    int busy_threads;
+    int quit;
+    struct {
+        thread_pool_task task;
+        void *userdata;
+        int num_tasks;
+        SDL_atomic_t next_task;
+    } job;
+} data;
+
+static void run_tasks(int worker)
+{
+    int task;
+    while ((task = SDL_AtomicAdd(&data.job.next_task, 1)) < data.job.num_tasks) {
+        data.job.task(task, worker, data.job.userdata);
+    }
+}
+
+static int worker_thread(void *arg)
+{
+    int worker = (int) (intptr_t) arg;
+    // Jobs may be submitted before the thread first gets the lock, so the generation it starts from
+    // is the one from when the threads were created
+    unsigned int handled_generation = data.start_generation;
+    SDL_LockMutex(data.mutex);
+    while (1) {
+        while (!data.quit && data.generation == handled_generation) {
+            SDL_CondWait(data.job_ready, data.mutex);
+        }
+        if (data.quit) {
+            break;
+        }
+        handled_generation = data.generation;
+        SDL_UnlockMutex(data.mutex);
+
+        run_tasks(worker);
+
+        SDL_LockMutex(data.mutex);
+        if (--data.busy_threads == 0) {
+            SDL_CondSignal(data.job_done);
+        }
+    }
+    SDL_UnlockMutex(data.mutex);
+    return 0;
+}
+
+static void init(void)
+{
+    if (data.initialized) {
+        return;
+    }
+    data.initialized = 1;
+    int wanted_threads = SDL_GetCPUCount() - 1;
+    if (wanted_threads <= 0) {
+        return;
+    }
+    if (wanted_threads > MAX_WORKER_THREADS) {
+        wanted_threads = MAX_WORKER_THREADS;
+    }
+    data.mutex = SDL_CreateMutex();
+    data.job_ready = SDL_CreateCond();
+    data.job_done = SDL_CreateCond();
+    if (!data.mutex || !data.job_ready || !data.job_done) {
+        log_error("Unable to create thread pool synchronization primitives, running tasks serially", SDL_GetError(), 0);
+        return;
+    }
+    data.start_generation = data.generation;
+    for (int i = 0; i < wanted_threads; i++) {
+        SDL_Thread *thread = SDL_CreateThread(worker_thread, "worker", (void *) (intptr_t) (i + 1));
+        if (!thread) {
+            log_info("Unable to create all worker threads:", SDL_GetError(), i);
+            break;
+        }
+        data.threads[data.num_threads++] = thread;
+    }
+    log_info("Worker threads created:", 0, data.num_threads);
+}
+
+int platform_thread_pool_worker_count(void)
+{
+    init();
+    return data.num_threads + 1;
+}
+
+void platform_thread_pool_run(int num_tasks, thread_pool_task task, void *userdata)
+{
+    if (num_tasks <= 0) {
+        return;
+    }
+    init();
+    if (!data.num_threads || num_tasks == 1) {
+        for (int i = 0; i < num_tasks; i++) {
+            task(i, 0, userdata);
+        }
+        return;
+    }
+    SDL_LockMutex(data.mutex);
+    data.job.task = task;
+    data.job.userdata = userdata;
+    data.job.num_tasks = num_tasks;
+    SDL_AtomicSet(&data.job.next_task, 0);
+    data.busy_threads = data.num_threads;
+    data.generation++;
+    SDL_CondBroadcast(data.job_ready);
+    SDL_UnlockMutex(data.mutex);
+
+    run_tasks(0);
+
+    SDL_LockMutex(data.mutex);
+    while (data.busy_threads) {
+        SDL_CondWait(data.job_done, data.mutex);
+    }
+    SDL_UnlockMutex(data.mutex);
+}
+
+void platform_thread_pool_shutdown(void)
+{
+    if (data.num_threads) {
+        SDL_LockMutex(data.mutex);
+        data.quit = 1;
+        SDL_CondBroadcast(data.job_ready);
+        SDL_UnlockMutex(data.mutex);
+        for (int i = 0; i < data.num_threads; i++) {
+            SDL_WaitThread(data.threads[i], 0);
+        }
+    }
+    if (data.job_done) {
+        SDL_DestroyCond(data.job_done);
+    }
+    if (data.job_ready) {
+        SDL_DestroyCond(data.job_ready);
+    }
+    if (data.mutex) {
+        SDL_DestroyMutex(data.mutex);
+    }
+    data.num_threads = 0;
+    data.job_done = 0;
+    data.job_ready = 0;
+    data.mutex = 0;
+    data.quit = 0;
+    data.initialized = 0;
+}
@@ -0,0 +1,40 @@
+#ifndef PLATFORM_THREAD_POOL_H
+#define PLATFORM_THREAD_POOL_H
+
+/**
+ * @file
+ * Small pool of worker threads for splitting independent work in chunks.
+ */
+
+/**
+ * A task callback
+ * @param task Index of the task to run, from 0 to the number of tasks - 1
+ * @param worker Index of the worker running the task, from 0 to platform_thread_pool_worker_count() - 1.
+ *               Tasks with the same worker index never run at the same time, so it can be used to pick
+ *               per-worker scratch data.
+ * @param userdata The userdata passed to platform_thread_pool_run
+ */
+typedef void (*thread_pool_task)(int task, int worker, void *userdata);
+
+/**
+ * Gets the number of workers that can run tasks at the same time, including the calling thread
+ * @return The number of workers, always at least 1
+ */
+int platform_thread_pool_worker_count(void);
+
+/**
+ * Runs all tasks and waits for them to finish. The calling thread also runs tasks.
+ * Must only be called from the main thread and never from within a task.
+ * Falls back to running the tasks in order on the calling thread when threads are unavailable.
+ * @param num_tasks The number of tasks to run
+ * @param task The task callback
+ * @param userdata Data passed to every task
+ */
+void platform_thread_pool_run(int num_tasks, thread_pool_task task, void *userdata);
+
+/**
+ * Stops all worker threads
+ */
+void platform_thread_pool_shutdown(void);
+
+#endif // PLATFORM_THREAD_POOL_H
@@ -98,6 +98,50 @@ int scenario_action_type_execute(scenario_action_t *action)
     }
 }
 
+int scenario_action_type_changes(const scenario_action_t *action)
+{
+    switch (action->type) {
+        case ACTION_TYPE_BUILDING_FORCE_COLLAPSE:
+        case ACTION_TYPE_CHANGE_TERRAIN:
+            return EVENT_DEPENDENCY_BUILDINGS | EVENT_DEPENDENCY_MAP;
+        case ACTION_TYPE_CHANGE_RESOURCE_STOCKPILES:
+            // Changes the amounts stored in warehouses and granaries
+            return EVENT_DEPENDENCY_BUILDINGS;
+        case ACTION_TYPE_ADJUST_CITY_HEALTH:
+        case ACTION_TYPE_ADJUST_FAVOR:
+        case ACTION_TYPE_ADJUST_MONEY:
+        case ACTION_TYPE_ADJUST_SAVINGS:
+        case ACTION_TYPE_CHANGE_CITY_RATING:
+        case ACTION_TYPE_TAX_RATE_SET:
+        case ACTION_TYPE_CAUSE_BLESSING:
+        case ACTION_TYPE_CAUSE_MINOR_CURSE:
+        case ACTION_TYPE_CAUSE_MAJOR_CURSE:
+        case ACTION_TYPE_ADJUST_ROME_WAGES:
+        case ACTION_TYPE_CHANGE_RESOURCE_PRODUCED:
+        case ACTION_TYPE_EMPIRE_MAP_CONVERT_FUTURE_TRADE_CITY:
+        case ACTION_TYPE_TRADE_ROUTE_ADD_NEW_RESOURCE:
+        case ACTION_TYPE_TRADE_ADJUST_PRICE:
+        case ACTION_TYPE_TRADE_ADJUST_ROUTE_AMOUNT:
+        case ACTION_TYPE_TRADE_ADJUST_ROUTE_OPEN_PRICE:
+        case ACTION_TYPE_TRADE_ROUTE_SET_OPEN:
+        case ACTION_TYPE_TRADE_PROBLEM_LAND:
+        case ACTION_TYPE_TRADE_PROBLEM_SEA:
+        case ACTION_TYPE_TRADE_SET_PRICE:
+        case ACTION_TYPE_TRADE_SET_BUY_PRICE_ONLY:
+        case ACTION_TYPE_TRADE_SET_SELL_PRICE_ONLY:
+        case ACTION_TYPE_CHANGE_ALLOWED_BUILDINGS:
+        case ACTION_TYPE_CHANGE_CUSTOM_VARIABLE:
+        case ACTION_TYPE_REQUEST_IMMEDIATELY_START:
+        case ACTION_TYPE_SEND_STANDARD_MESSAGE:
+        case ACTION_TYPE_SHOW_CUSTOM_MESSAGE:
+        case ACTION_TYPE_CHANGE_CLIMATE:
+            return EVENT_DEPENDENCY_NONE;
+        default:
+            // Unknown actions, including invasions and revolts, may change anything
+            return EVENT_DEPENDENCY_ALL;
+    }
+}
+
 void scenario_action_type_delete(scenario_action_t *action)
 {
     memset(action, 0, sizeof(scenario_action_t));
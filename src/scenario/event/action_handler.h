@@ -7,6 +7,11 @@
 void scenario_action_type_init(scenario_action_t *action);
 int scenario_action_type_execute(scenario_action_t *action);
 
+/**
+ * @return The event_dependency flags of the city state the action may change when executed
+ */
+int scenario_action_type_changes(const scenario_action_t *action);
+
 void scenario_action_type_delete(scenario_action_t *action);
 void scenario_action_type_save_state(buffer *buf, const scenario_action_t *action, int link_type, int32_t link_id);
 unsigned int scenario_action_type_load_state(buffer *buf, scenario_action_t *action, int *link_type, int32_t *link_id, 
@@ -94,6 +94,29 @@ int scenario_condition_type_is_met(scenario_condition_t *condition)
     }
 }
 
+int scenario_condition_type_dependencies(const scenario_condition_t *condition)
+{
+    switch (condition->type) {
+        case CONDITION_TYPE_BUILDING_COUNT_ACTIVE:
+        case CONDITION_TYPE_BUILDING_COUNT_ANY:
+        case CONDITION_TYPE_BUILDING_COUNT_AREA:
+            return scenario_condition_type_building_count_dependencies(condition->parameter3);
+        case CONDITION_TYPE_RESOURCE_STORAGE_AVAILABLE:
+        case CONDITION_TYPE_RESOURCE_STORED_COUNT:
+            // Both sum up the contents of every warehouse or granary
+            return EVENT_DEPENDENCY_BUILDINGS;
+        default:
+            // Other conditions only read values the city already keeps track of
+            return EVENT_DEPENDENCY_NONE;
+    }
+}
+
+int scenario_condition_type_is_expensive(const scenario_condition_t *condition)
+{
+    return (scenario_condition_type_dependencies(condition) &
+        (EVENT_DEPENDENCY_BUILDINGS | EVENT_DEPENDENCY_MAP)) != 0;
+}
+
 void scenario_condition_type_delete(scenario_condition_t *condition)
 {
     memset(condition, 0, sizeof(scenario_condition_t));
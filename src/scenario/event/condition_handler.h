@@ -10,6 +10,16 @@ int scenario_condition_group_in_use(const scenario_condition_group_t *group);
 void scenario_condition_type_init(scenario_condition_t *condition);
 int scenario_condition_type_is_met(scenario_condition_t *condition);
 
+/**
+ * @return The event_dependency flags of the city state the condition reads
+ */
+int scenario_condition_type_dependencies(const scenario_condition_t *condition);
+
+/**
+ * @return Whether checking the condition requires scanning buildings or the map
+ */
+int scenario_condition_type_is_expensive(const scenario_condition_t *condition);
+
 void scenario_condition_type_delete(scenario_condition_t *condition);
 void scenario_condition_group_save_state(buffer *buf, const scenario_condition_group_t *condition_group, int link_type,
     int32_t link_id);
@@ -21,12 +21,48 @@
 #include "scenario/request.h"
 #include "scenario/scenario.h"
 
-int scenario_condition_type_building_count_active_met(const scenario_condition_t *condition)
+#include <string.h>
+
+static struct {
+    int enabled;
+    int valid[2][BUILDING_TYPE_MAX];
+    int count[2][BUILDING_TYPE_MAX];
+} count_cache;
+
+void scenario_condition_type_cache_begin(void)
 {
-    int comparison = condition->parameter1;
-    int value = condition->parameter2;
-    building_type type = condition->parameter3;
+    memset(&count_cache, 0, sizeof(count_cache));
+    count_cache.enabled = 1;
+}
 
+void scenario_condition_type_cache_invalidate(int dependencies)
+{
+    if (dependencies & (EVENT_DEPENDENCY_BUILDINGS | EVENT_DEPENDENCY_MAP)) {
+        memset(count_cache.valid, 0, sizeof(count_cache.valid));
+    }
+}
+
+void scenario_condition_type_cache_end(void)
+{
+    count_cache.enabled = 0;
+}
+
+int scenario_condition_type_building_count_dependencies(building_type type)
+{
+    switch (type) {
+        case BUILDING_ROAD:
+        case BUILDING_HIGHWAY:
+        case BUILDING_PLAZA:
+        case BUILDING_GARDENS:
+        case BUILDING_OVERGROWN_GARDENS:
+            return EVENT_DEPENDENCY_MAP;
+        default:
+            return EVENT_DEPENDENCY_BUILDINGS;
+    }
+}
+
+static int count_active_buildings(building_type type)
+{
     int total_active_count = 0;
     switch (type) {
         case BUILDING_MENU_FARMS:
@@ -88,15 +124,11 @@ int scenario_condition_type_building_count_active_met(const scenario_condition_t
             break;
     }
 
-    return comparison_helper_compare_values(comparison, total_active_count, value);
+    return total_active_count;
 }
 
-int scenario_condition_type_building_count_any_met(const scenario_condition_t *condition)
+static int count_any_buildings(building_type type)
 {
-    int comparison = condition->parameter1;
-    int value = condition->parameter2;
-    building_type type = condition->parameter3;
-
     int total_active_count = 0;
     switch (type) {
         case BUILDING_MENU_FARMS:
@@ -158,6 +190,44 @@ int scenario_condition_type_building_count_any_met(const scenario_condition_t *c
             break;
     }
 
+    return total_active_count;
+}
+
+static int get_building_count(building_type type, int active_only)
+{
+    if (type < 0 || type >= BUILDING_TYPE_MAX) {
+        return active_only ? count_active_buildings(type) : count_any_buildings(type);
+    }
+    if (count_cache.enabled && count_cache.valid[active_only][type]) {
+        return count_cache.count[active_only][type];
+    }
+    int count = active_only ? count_active_buildings(type) : count_any_buildings(type);
+    if (count_cache.enabled) {
+        count_cache.count[active_only][type] = count;
+        count_cache.valid[active_only][type] = 1;
+    }
+    return count;
+}
+
+int scenario_condition_type_building_count_active_met(const scenario_condition_t *condition)
+{
+    int comparison = condition->parameter1;
+    int value = condition->parameter2;
+    building_type type = condition->parameter3;
+
+    int total_active_count = get_building_count(type, 1);
+
+    return comparison_helper_compare_values(comparison, total_active_count, value);
+}
+
+int scenario_condition_type_building_count_any_met(const scenario_condition_t *condition)
+{
+    int comparison = condition->parameter1;
+    int value = condition->parameter2;
+    building_type type = condition->parameter3;
+
+    int total_active_count = get_building_count(type, 0);
+
     return comparison_helper_compare_values(comparison, total_active_count, value);
 }
 
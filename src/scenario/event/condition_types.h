@@ -1,8 +1,30 @@
 #ifndef CONDITION_TYPES_H
 #define CONDITION_TYPES_H
 
+#include "building/type.h"
 #include "scenario/event/data.h"
 
+/**
+ * Starts caching building counts, so that events checking the same counts during one pass only count once
+ */
+void scenario_condition_type_cache_begin(void);
+
+/**
+ * Drops cached values that depend on changed city state
+ * @param dependencies The event_dependency flags of the state that changed
+ */
+void scenario_condition_type_cache_invalidate(int dependencies);
+
+/**
+ * Stops caching building counts
+ */
+void scenario_condition_type_cache_end(void);
+
+/**
+ * @return The event_dependency flags of the state a building count for the given type reads
+ */
+int scenario_condition_type_building_count_dependencies(building_type type);
+
 int scenario_condition_type_building_count_active_met(const scenario_condition_t *condition);
 
 int scenario_condition_type_building_count_any_met(const scenario_condition_t *condition);
@@ -4,6 +4,7 @@
 #include "game/save_version.h"
 #include "scenario/event/action_handler.h"
 #include "scenario/event/condition_handler.h"
+#include "scenario/event/condition_types.h"
 #include "scenario/event/event.h"
 #include "scenario/scenario.h"
 
@@ -265,10 +266,18 @@ void scenario_events_load_state(buffer *buf_events, buffer *buf_conditions, buff
 
 void scenario_events_process_all(void)
 {
+    // Building counts are shared between all events of this pass and only dropped when an executed event
+    // may have changed the buildings or the map
+    scenario_condition_type_cache_begin();
     scenario_event_t *current;
     array_foreach(scenario_events, current) {
+        int execution_count = current->execution_count;
         scenario_event_conditional_execute(current);
+        if (current->execution_count != execution_count) {
+            scenario_condition_type_cache_invalidate(scenario_event_get_changes(current));
+        }
     }
+    scenario_condition_type_cache_end();
 }
 
 scenario_event_t *scenario_events_get_using_custom_variable(int custom_variable_id)
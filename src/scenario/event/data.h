@@ -54,6 +54,14 @@ typedef enum {
     CONDITION_TYPE_MIN = CONDITION_TYPE_TIME_PASSED,
 } condition_types;
 
+// City state that conditions read and actions may change, used to decide which cached values are still valid
+typedef enum {
+    EVENT_DEPENDENCY_NONE = 0,
+    EVENT_DEPENDENCY_BUILDINGS = 1 << 0,
+    EVENT_DEPENDENCY_MAP = 1 << 1,
+    EVENT_DEPENDENCY_ALL = EVENT_DEPENDENCY_BUILDINGS | EVENT_DEPENDENCY_MAP
+} event_dependency;
+
 typedef enum {
     ACTION_TYPE_UNDEFINED = 0,
     ACTION_TYPE_ADJUST_FAVOR = 1,
@@ -165,17 +165,23 @@ static int conditions_fulfilled(scenario_event_t *event)
         return 0;
     }
     
+    // Conditions have no side effects, so cheap ones are checked first to skip building and map scans when possible
     scenario_condition_group_t *group;
     array_foreach(event->condition_groups, group) {
         int group_fulfilled = 0;
-        for (unsigned int i = 0; i < group->conditions.size; i++) {
-            scenario_condition_t *condition = array_item(group->conditions, i);
-            if (group->type == FULFILLMENT_TYPE_ALL && !scenario_condition_type_is_met(condition)) {
-                return 0;
-            }
-            if (group->type == FULFILLMENT_TYPE_ANY && scenario_condition_type_is_met(condition)) {
-                group_fulfilled = 1;
-                break;
+        for (int expensive = 0; expensive <= 1 && !group_fulfilled; expensive++) {
+            for (unsigned int i = 0; i < group->conditions.size; i++) {
+                scenario_condition_t *condition = array_item(group->conditions, i);
+                if (scenario_condition_type_is_expensive(condition) != expensive) {
+                    continue;
+                }
+                if (group->type == FULFILLMENT_TYPE_ALL && !scenario_condition_type_is_met(condition)) {
+                    return 0;
+                }
+                if (group->type == FULFILLMENT_TYPE_ANY && scenario_condition_type_is_met(condition)) {
+                    group_fulfilled = 1;
+                    break;
+                }
             }
         }
         if (group->type == FULFILLMENT_TYPE_ANY && group->conditions.size > 0 && !group_fulfilled) {
@@ -186,6 +192,16 @@ static int conditions_fulfilled(scenario_event_t *event)
     return 1;
 }
 
+int scenario_event_get_changes(const scenario_event_t *event)
+{
+    int changes = EVENT_DEPENDENCY_NONE;
+    const scenario_action_t *action;
+    array_foreach(event->actions, action) {
+        changes |= scenario_action_type_changes(action);
+    }
+    return changes;
+}
+
 int scenario_event_decrease_pause_time(scenario_event_t *event, int months_passed)
 {
     if (event->state != EVENT_STATE_PAUSED) {
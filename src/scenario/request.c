@@ -10,6 +10,7 @@
 #include "core/array.h"
 #include "core/log.h"
 #include "core/random.h"
+#include "game/replay.h"
 #include "game/resource.h"
 #include "game/save_version.h"
 #include "game/time.h"
@@ -180,6 +181,7 @@ void scenario_request_process(void)
 
 void scenario_request_dispatch(int id)
 {
+    game_replay_record_command(REPLAY_COMMAND_REQUEST_DISPATCH, id, 0, 0);
     scenario_request *request = array_item(requests, id);
     if (request->state == REQUEST_STATE_NORMAL) {
         request->state = REQUEST_STATE_DISPATCHED;
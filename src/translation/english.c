@@ -1685,6 +1685,17 @@ static translation_string all_strings[] = {
     {TR_TOOLTIP_CHANGE_SIDEBAR_WIDTH, "Change sidebar width"},
     {TR_TOOLTIP_ASCENDING_ORDER, "Ascending order"},
     {TR_TOOLTIP_DESCENDING_ORDER, "Descending order"},
+    {TR_MENU_SKIP_AHEAD_MONTH, "Skip ahead one month"},
+    {TR_SKIP_AHEAD_TITLE, "Skipping ahead"},
+    {TR_SKIP_AHEAD_DAYS, "Days skipped:"},
+    {TR_SKIP_AHEAD_CANCEL_HINT, "Right click or press Esc to stop"},
+    {TR_CHEAT_SKIPPED_AHEAD, "Skipping ahead"},
+    {TR_CHEAT_REPLAY_RECORDING, "Recording replay"},
+    {TR_CHEAT_REPLAY_PLAYING, "Playing replay"},
+    {TR_CHEAT_REPLAY_STOPPED, "Replay stopped"},
+    {TR_CHEAT_MEMORY_USAGE, "Tracked memory (current / peak): "},
+    {TR_CHEAT_MEMORY_REPORT_WRITTEN, "Memory report written to memory_report.txt"},
+    {TR_CHEAT_MEMORY_REPORT_FAILED, "Unable to write the memory report"},
 };
 
 void translation_english(const translation_string **strings, int *num_strings)
@@ -1679,6 +1679,17 @@ typedef enum {
     TR_TOOLTIP_CHANGE_SIDEBAR_WIDTH,
     TR_TOOLTIP_ASCENDING_ORDER,
     TR_TOOLTIP_DESCENDING_ORDER,
+    TR_MENU_SKIP_AHEAD_MONTH,
+    TR_SKIP_AHEAD_TITLE,
+    TR_SKIP_AHEAD_DAYS,
+    TR_SKIP_AHEAD_CANCEL_HINT,
+    TR_CHEAT_SKIPPED_AHEAD,
+    TR_CHEAT_REPLAY_RECORDING,
+    TR_CHEAT_REPLAY_PLAYING,
+    TR_CHEAT_REPLAY_STOPPED,
+    TR_CHEAT_MEMORY_USAGE,
+    TR_CHEAT_MEMORY_REPORT_WRITTEN,
+    TR_CHEAT_MEMORY_REPORT_FAILED,
     TRANSLATION_MAX_KEY
 } translation_key;
 
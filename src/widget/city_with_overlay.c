@@ -14,6 +14,7 @@
 #include "figure/roamer_preview.h"
 #include "game/resource.h"
 #include "game/state.h"
+#include "game/time.h"
 #include "graphics/graphics.h"
 #include "graphics/image.h"
 #include "graphics/renderer.h"
@@ -27,6 +28,7 @@
 #include "map/random.h"
 #include "map/tiles.h"
 #include "map/terrain.h"
+#include "platform/thread_pool.h"
 #include "widget/city_bridge.h"
 #include "widget/city_building_ghost.h"
 #include "widget/city_figure.h"
@@ -39,8 +41,21 @@
 #include "widget/city_without_overlay.h"
 #include "widget/city_draw_highway.h"
 
+#define MAX_COLUMN_HEIGHT 10
+#define COLUMN_CACHE_ROWS_PER_TASK 8
+
 static const city_overlay *overlay = 0;
 static float scale = SCALE_NONE;
+
+// Column heights only change with the simulation, so they're worked out for the whole map once per game day,
+// or when the overlay changes, instead of for every building on every frame.
+// A tile whose building doesn't match the cached one (i.e. something was built since) is worked out when drawn.
+static struct {
+    int overlay_type;
+    int day;
+    grid_u16 building_ids;
+    grid_i8 heights;
+} column_cache = { OVERLAY_NONE };
 static unsigned int city_roamer_preview_selected_building_id = ((unsigned int) -1); //NO_POSITION default
 
 #define SELECTED_BUILDING_COLOR_MASK COLOR_MASK_SKY_BLUE
@@ -152,6 +167,62 @@ static int select_city_overlay(void)
 void city_with_overlay_update(void)
 {
     select_city_overlay();
+    city_with_overlay_invalidate_column_cache();
+}
+
+void city_with_overlay_invalidate_column_cache(void)
+{
+    column_cache.overlay_type = OVERLAY_NONE;
+}
+
+static int get_column_height(const building *b)
+{
+    int height = overlay->get_column_height(b);
+    return height > MAX_COLUMN_HEIGHT ? MAX_COLUMN_HEIGHT : height;
+}
+
+static void cache_column_heights(int task, int worker, void *userdata)
+{
+    int map_width, map_height;
+    map_grid_size(&map_width, &map_height);
+    int y_start = task * COLUMN_CACHE_ROWS_PER_TASK;
+    int y_end = y_start + COLUMN_CACHE_ROWS_PER_TASK;
+    if (y_end > map_height) {
+        y_end = map_height;
+    }
+    for (int y = y_start; y < y_end; y++) {
+        for (int x = 0; x < map_width; x++) {
+            int grid_offset = map_grid_offset(x, y);
+            int building_id = map_building_at(grid_offset);
+            if (!map_property_is_draw_tile(grid_offset) || !map_terrain_is(grid_offset, TERRAIN_BUILDING)) {
+                building_id = 0;
+            }
+            column_cache.building_ids.items[grid_offset] = building_id;
+            if (building_id) {
+                column_cache.heights.items[grid_offset] = get_column_height(building_get(building_id));
+            }
+        }
+    }
+}
+
+static void update_column_cache(void)
+{
+    int day = game_time_total_days();
+    if (column_cache.overlay_type == overlay->type && column_cache.day == day) {
+        return;
+    }
+    column_cache.overlay_type = overlay->type;
+    column_cache.day = day;
+    int num_tasks = (map_grid_height() + COLUMN_CACHE_ROWS_PER_TASK - 1) / COLUMN_CACHE_ROWS_PER_TASK;
+    platform_thread_pool_run(num_tasks, cache_column_heights, 0);
+}
+
+static int get_cached_column_height(int grid_offset, const building *b)
+{
+    if (column_cache.overlay_type == overlay->type && column_cache.building_ids.items[grid_offset] == b->id) {
+        return column_cache.heights.items[grid_offset];
+    }
+    return get_column_height(b);
 }
 
 static color_t get_building_color_mask(const building *b)
@@ -479,8 +550,8 @@ static void draw_footprint(int x, int y, int grid_offset)
 static void draw_overlay_column(int x, int y, int height, column_color_type color_type)
 {
     int image_id = image_group(GROUP_OVERLAY_COLUMN);
-    if (height > 10) {
-        height = 10;
+    if (height > MAX_COLUMN_HEIGHT) {
+        height = MAX_COLUMN_HEIGHT;
     }
     switch (color_type) {
         case COLUMN_COLOR_RED:
@@ -667,7 +738,7 @@ void city_with_overlay_draw_building_top(int x, int y, int grid_offset)
     if (overlay->show_building(b)) {
         draw_building_top(grid_offset, b, x, y);
     } else {
-        int column_height = overlay->get_column_height(b);
+        int column_height = get_cached_column_height(grid_offset, b);
         if (column_height != NO_COLUMN) {
             int draw = 1;
             if (building_is_farm(b->type)) {
@@ -849,6 +920,7 @@ void city_with_overlay_draw(const map_tile *tile, unsigned int roamer_preview_bu
 
     scale = city_view_get_scale() / 100.0f;
     city_roamer_preview_selected_building_id = roamer_preview_building_id;
+    update_column_cache();
     int x, y, width, height;
     city_view_get_viewport(&x, &y, &width, &height);
     graphics_fill_rect(x, y, width, height, COLOR_BLACK);
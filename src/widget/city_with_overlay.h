@@ -9,6 +9,11 @@
  */
 void city_with_overlay_update(void);
 
+/**
+ * Forget the cached overlay column heights, e.g. because another city was loaded
+ */
+void city_with_overlay_invalidate_column_cache(void);
+
 void city_with_overlay_draw(const map_tile *tile, unsigned int roamer_preview_building_id);
 
 int city_with_overlay_get_tooltip_text(tooltip_context *c, int grid_offset);
@@ -534,6 +534,31 @@ void widget_minimap_update(const minimap_functions *functions)
     graphics_renderer()->update_custom_image(CUSTOM_IMAGE_MINIMAP);
 }
 
+int widget_minimap_get_pixels(color_t *pixels, int width, int height)
+{
+    if (!data.cache.buffer || width != data.minimap.width * 2 || height != data.minimap.height) {
+        return 0;
+    }
+    for (int y = 0; y < height; y++) {
+        memcpy(&pixels[y * width], &data.cache.buffer[y * data.cache.stride], sizeof(color_t) * width);
+    }
+    return 1;
+}
+
+void widget_minimap_update_from_pixels(const minimap_functions *functions, const color_t *pixels)
+{
+    data.functions = functions;
+    prepare_minimap_cache();
+    if (!data.cache.buffer) {
+        return;
+    }
+    int width = data.minimap.width * 2;
+    for (int y = 0; y < data.minimap.height; y++) {
+        memcpy(&data.cache.buffer[y * data.cache.stride], &pixels[y * width], sizeof(color_t) * width);
+    }
+    graphics_renderer()->update_custom_image(CUSTOM_IMAGE_MINIMAP);
+}
+
 void widget_minimap_draw(int x_offset, int y_offset, int width, int height)
 {
     if (!data.cache.buffer) {
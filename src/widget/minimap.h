@@ -3,6 +3,7 @@
 
 #include "building/building.h"
 #include "figure/figure.h"
+#include "graphics/color.h"
 #include "input/mouse.h"
 #include "scenario/property.h"
 
@@ -28,6 +29,22 @@ void widget_minimap_invalidate(void);
 
 void widget_minimap_update(const minimap_functions *functions);
 
+/**
+ * Copies the minimap image drawn by the last update
+ * @param pixels Buffer to copy to
+ * @param width Width of the buffer, which must be the map width * 2
+ * @param height Height of the buffer, which must be the map height * 2
+ * @return 1 if the image was copied, 0 if it has a different size
+ */
+int widget_minimap_get_pixels(color_t *pixels, int width, int height);
+
+/**
+ * Updates the minimap with an image copied earlier, instead of drawing it from the map
+ * @param functions The functions to get the map size and viewport from
+ * @param pixels The image, of map width * 2 by map height * 2 pixels
+ */
+void widget_minimap_update_from_pixels(const minimap_functions *functions, const color_t *pixels);
+
 void widget_minimap_draw(int x_offset, int y_offset, int width, int height);
 
 void widget_minimap_draw_decorated(int x_offset, int y_offset, int width, int height);
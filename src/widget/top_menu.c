@@ -13,6 +13,7 @@
 #include "core/lang.h"
 #include "game/campaign.h"
 #include "game/file.h"
+#include "game/speed.h"
 #include "game/settings.h"
 #include "game/state.h"
 #include "game/system.h"
@@ -39,6 +40,7 @@
 #include "window/mission_selection.h"
 #include "window/plain_message_dialog.h"
 #include "window/popup_dialog.h"
+#include "window/skip_ahead.h"
 
 enum {
     INFO_NONE = 0,
@@ -70,6 +72,7 @@ static void menu_file_replay_map(int param);
 static void menu_file_load_game(int param);
 static void menu_file_save_game(int param);
 static void menu_file_delete_game(int param);
+static void menu_file_skip_ahead(int param);
 static void menu_file_exit_to_main_menu(int param);
 static void menu_file_exit_game(int param);
 
@@ -94,6 +97,7 @@ static menu_item menu_file[] = {
     {1, 3, menu_file_load_game, 0},
     {1, 4, menu_file_save_game, 0},
     {1, 6, menu_file_delete_game, 0},
+    {CUSTOM_TRANSLATION, TR_MENU_SKIP_AHEAD_MONTH, menu_file_skip_ahead, GAME_TIME_DAYS_PER_MONTH},
     {CUSTOM_TRANSLATION, TR_BUTTON_BACK_TO_MAIN_MENU, menu_file_exit_to_main_menu, 0},
     {1, 5, menu_file_exit_game, 0},
 };
@@ -132,7 +136,7 @@ static menu_item menu_advisors[] = {
 };
 
 static menu_bar_item menu[] = {
-    {1, menu_file, 6},
+    {1, menu_file, 7},
     {2, menu_options, 7},
     {3, menu_help, 4},
     {4, menu_advisors, 13},
@@ -946,6 +950,13 @@ static void menu_file_delete_game(int param)
     window_file_dialog_show(FILE_TYPE_SAVED_GAME, FILE_DIALOG_DELETE);
 }
 
+static void menu_file_skip_ahead(int days)
+{
+    clear_state();
+    window_go_back();
+    window_skip_ahead_show(days, FAST_FORWARD_STOP_ON_ALL);
+}
+
 static void menu_file_confirm_exit(int accepted, int checked)
 {
     if (accepted) {
@@ -8,6 +8,7 @@
 #include "city/resource.h"
 #include "city/view.h"
 #include "figure/figure.h"
+#include "game/replay.h"
 #include "graphics/button.h"
 #include "graphics/generic_button.h"
 #include "graphics/image.h"
@@ -145,13 +146,15 @@ static void setup_buttons_for_selected_depot(void)
     }
 }
 
-static void calculate_available_storages(int building_id)
+static int calculate_available_storages(int building_id)
 {
     data.depot_building_id = building_id;
 
     building *b = building_get(data.depot_building_id);
+    int order_changed = 0;
     if (!b->data.depot.current_order.resource_type) {
         b->data.depot.current_order.resource_type = RESOURCE_MIN_FOOD;
+        order_changed = 1;
     }
     data.target_resource_id = b->data.depot.current_order.resource_type;
 
@@ -176,18 +179,23 @@ static void calculate_available_storages(int building_id)
             }
         }
     }
-    if (!has_valid_src) {
+    if (!has_valid_src && b->data.depot.current_order.src_storage_id) {
         b->data.depot.current_order.src_storage_id = 0;
+        order_changed = 1;
     }
-    if (!has_valid_dst) {
+    if (!has_valid_dst && b->data.depot.current_order.dst_storage_id) {
         b->data.depot.current_order.dst_storage_id = 0;
+        order_changed = 1;
     }
+    return order_changed;
 }
 
 void window_building_depot_init_main(int building_id)
 {
     city_resource_determine_available(1);
-    calculate_available_storages(building_id);
+    if (calculate_available_storages(building_id)) {
+        game_replay_record_depot_order(building_get(building_id));
+    }
 }
 
 void window_building_depot_init_resource_selection(void)
@@ -435,6 +443,7 @@ static void set_order_source(const generic_button *button)
     if (b->data.depot.current_order.dst_storage_id == building_id) {
         b->data.depot.current_order.dst_storage_id = 0;
     }
+    game_replay_record_depot_order(b);
     window_building_info_depot_return_to_main_window();
 }
 
@@ -451,6 +460,7 @@ static void set_order_destination(const generic_button *button)
     if (b->data.depot.current_order.src_storage_id == building_id) {
         b->data.depot.current_order.src_storage_id = 0;
     }
+    game_replay_record_depot_order(b);
     window_building_info_depot_return_to_main_window();
 }
 
@@ -542,6 +552,7 @@ static void set_order_resource(const generic_button *button)
         building *b = building_get(depot_building_id);
         b->data.depot.current_order.resource_type = resource_id;
         calculate_available_storages(depot_building_id);
+        game_replay_record_depot_order(b);
         window_building_info_depot_return_to_main_window();
     }
 }
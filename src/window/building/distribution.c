@@ -24,6 +24,7 @@
 #include "empire/object.h"
 #include "empire/trade_route.h"
 #include "figure/figure.h"
+#include "game/replay.h"
 #include "graphics/button.h"
 #include "graphics/generic_button.h"
 #include "graphics/graphics.h"
@@ -1459,6 +1460,7 @@ static void market_orders(const generic_button *button)
         if (affect_all_button_distribution_state() == ACCEPT_ALL) {
             building_distribution_accept_all_goods(b);
         } else {
+            game_replay_record_command(REPLAY_COMMAND_DISTRIBUTION_UNACCEPT_ALL_GOODS, b->id, 0, 0);
             building_distribution_unaccept_all_goods(b);
         }
     }
@@ -18,6 +18,7 @@
 #include "figure/formation_legion.h"
 #include "figure/roamer_preview.h"
 #include "figure/phrase.h"
+#include "game/replay.h"
 #include "game/state.h"
 #include "graphics/button.h"
 #include "graphics/generic_button.h"
@@ -1303,6 +1304,7 @@ void window_building_info_depot_toggle_condition_type(void)
 {
     building *b = building_get(context.building_id);
     b->data.depot.current_order.condition.condition_type = (b->data.depot.current_order.condition.condition_type + 1) % 4;
+    game_replay_record_depot_order(b);
     window_invalidate();
 }
 
@@ -1312,6 +1314,7 @@ void window_building_info_depot_toggle_condition_threshold(void)
     int step = config_get(CONFIG_GP_STORAGE_INCREMENT_4) ? 4 : 8;
     int step_max = config_get(CONFIG_GP_STORAGE_INCREMENT_4) ? 36 : 40;
     b->data.depot.current_order.condition.threshold = (b->data.depot.current_order.condition.threshold + step) % step_max;
+    game_replay_record_depot_order(b);
     window_invalidate();
 }
 
@@ -1322,6 +1325,7 @@ void window_building_info_depot_toggle_condition_threshold_reverse(void)
     int new_threshold = (b->data.depot.current_order.condition.threshold - step);
     new_threshold = new_threshold < 0 ? 32 : new_threshold;
     b->data.depot.current_order.condition.threshold = new_threshold;
+    game_replay_record_depot_order(b);
     window_invalidate();
 }
 
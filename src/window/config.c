@@ -8,6 +8,7 @@
 #include "core/log.h"
 #include "core/string.h"
 #include "game/game.h"
+#include "game/replay.h"
 #include "game/settings.h"
 #include "game/system.h"
 #include "graphics/button.h"
@@ -1183,6 +1184,9 @@ static void cancel_values(void)
 static int config_change_basic(int key)
 {
     if (key < CONFIG_MAX_ENTRIES) {
+        if (config_get(key) != data.config_values[key].new_value) {
+            game_replay_record_command(REPLAY_COMMAND_CONFIG_CHANGE, key, data.config_values[key].new_value, 0);
+        }
         config_set(key, data.config_values[key].new_value);
     }
     data.config_values[key].original_value = data.config_values[key].new_value;
@@ -1391,6 +1395,9 @@ static int config_set_difficulty(int key)
 {
     config_change_basic(key);
 
+    if (setting_difficulty() != data.config_values[key].new_value) {
+        game_replay_record_command(REPLAY_COMMAND_DIFFICULTY_CHANGE, data.config_values[key].new_value, 0, 0);
+    }
     while (setting_difficulty() > data.config_values[key].new_value) {
         setting_decrease_difficulty();
     }
@@ -1405,6 +1412,7 @@ static int config_enable_gods_effects(int key)
     config_change_basic(key);
 
     if (setting_gods_enabled() != data.config_values[key].new_value) {
+        game_replay_record_command(REPLAY_COMMAND_GODS_ENABLED_CHANGE, data.config_values[key].new_value, 0, 0);
         setting_toggle_gods_enabled();
     }
     return 1;
@@ -316,6 +316,16 @@ static void draw_mission_info(int x_offset, int y_offset, int box_size)
     text_draw_ellipsized(text, x_offset, y_offset, box_size, FONT_NORMAL_BLACK, 0);
 }
 
+static unsigned int selected_file_modified_time(void)
+{
+    for (int i = 0; i < data.file_list->num_files; i++) {
+        if (strcmp(data.file_list->files[i].name, data.selected_file) == 0) {
+            return data.file_list->files[i].modified_time;
+        }
+    }
+    return 0;
+}
+
 static void draw_background(void)
 {
     window_draw_underlying_window();
@@ -323,7 +333,8 @@ static void draw_background(void)
         const char *filename = dir_get_file_at_location(data.selected_file, data.file_data->location);
         if (filename) {
             if (data.type == FILE_TYPE_SAVED_GAME) {
-                data.savegame_info_status = game_file_io_read_saved_game_info(filename, 0, &data.info);
+                data.savegame_info_status = game_file_io_read_saved_game_info_indexed(filename,
+                    selected_file_modified_time(), &data.info);
             } else {
                 data.savegame_info_status = game_file_io_read_scenario_info(filename, &data.info);
             }
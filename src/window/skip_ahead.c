@@ -0,0 +1,81 @@
+#include "skip_ahead.h"
+
+#include "core/calc.h"
+#include "game/speed.h"
+#include "game/time.h"
+#include "graphics/color.h"
+#include "graphics/graphics.h"
+#include "graphics/lang_text.h"
+#include "graphics/panel.h"
+#include "graphics/text.h"
+#include "graphics/window.h"
+#include "input/input.h"
+#include "translation/translation.h"
+
+#define PANEL_X 128
+#define PANEL_Y 160
+#define PANEL_WIDTH_BLOCKS 24
+#define PANEL_HEIGHT_BLOCKS 10
+#define BAR_WIDTH_BLOCKS 20
+#define BAR_HEIGHT 20
+
+static void draw_background(void)
+{
+    // The city is drawn once and then left alone while skipping, so the simulation gets the frame time
+    window_draw_underlying_window();
+}
+
+static void draw_foreground(void)
+{
+    graphics_in_dialog();
+
+    outer_panel_draw(PANEL_X, PANEL_Y, PANEL_WIDTH_BLOCKS, PANEL_HEIGHT_BLOCKS);
+    text_draw_centered(translation_for(TR_SKIP_AHEAD_TITLE), PANEL_X, PANEL_Y + 16,
+        PANEL_WIDTH_BLOCKS * BLOCK_SIZE, FONT_LARGE_BLACK, 0);
+    lang_text_draw_month_year_max_width(game_time_month(), game_time_year(), PANEL_X + 32, PANEL_Y + 50,
+        (PANEL_WIDTH_BLOCKS - 4) * BLOCK_SIZE, FONT_NORMAL_BLACK, 0);
+
+    int total_days;
+    int days_done = game_speed_fast_forward_progress(&total_days);
+    int bar_x = PANEL_X + 2 * BLOCK_SIZE;
+    int bar_y = PANEL_Y + 76;
+    int bar_width = BAR_WIDTH_BLOCKS * BLOCK_SIZE;
+    inner_panel_draw(bar_x, bar_y, BAR_WIDTH_BLOCKS, 2);
+    if (total_days > 0) {
+        int filled = calc_adjust_with_percentage(bar_width - 8, calc_percentage(days_done, total_days));
+        graphics_fill_rect(bar_x + 4, bar_y + 6, filled, BAR_HEIGHT, COLOR_FONT_GREEN);
+    }
+
+    int width = text_draw(translation_for(TR_SKIP_AHEAD_DAYS), bar_x, PANEL_Y + 120, FONT_NORMAL_BLACK, 0);
+    width += text_draw_number(days_done, ' ', "", bar_x + width, PANEL_Y + 120, FONT_NORMAL_BLACK, 0);
+    text_draw_number(total_days, '/', "", bar_x + width, PANEL_Y + 120, FONT_NORMAL_BLACK, 0);
+    text_draw_centered(translation_for(TR_SKIP_AHEAD_CANCEL_HINT), PANEL_X, PANEL_Y + 140,
+        PANEL_WIDTH_BLOCKS * BLOCK_SIZE, FONT_SMALL_PLAIN, 0);
+
+    graphics_reset_dialog();
+}
+
+static void handle_input(const mouse *m, const hotkeys *h)
+{
+    if (input_go_back_requested(m, h)) {
+        game_speed_fast_forward_stop();
+    }
+    if (!game_speed_fast_forward_is_active()) {
+        window_go_back();
+    }
+}
+
+void window_skip_ahead_show(int days, int stop_events)
+{
+    if (days <= 0 || window_is(WINDOW_SKIP_AHEAD)) {
+        return;
+    }
+    window_type window = {
+        WINDOW_SKIP_AHEAD,
+        draw_background,
+        draw_foreground,
+        handle_input
+    };
+    game_speed_fast_forward_start(days, stop_events);
+    window_show(&window);
+}
@@ -0,0 +1,11 @@
+#ifndef WINDOW_SKIP_AHEAD_H
+#define WINDOW_SKIP_AHEAD_H
+
+/**
+ * Runs the simulation for the given number of days without drawing the city, showing a progress panel
+ * @param days The number of days to skip
+ * @param stop_events Combination of fast_forward_stop_event flags that end the skip early
+ */
+void window_skip_ahead_show(int days, int stop_events);
+
+#endif // WINDOW_SKIP_AHEAD_H